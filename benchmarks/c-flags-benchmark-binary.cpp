@@ -0,0 +1,79 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <benchmark/benchmark.h>
+#include <c-flags.h>
+
+#include <cstdlib>
+#include <string>
+
+static void declare_flags()
+{
+    c_flag_binary("blob", nullptr, nullptr, nullptr);
+}
+
+// the value rendered by the library is base64, `hex:` values are made here
+static std::string make_value(size_t size, bool hex)
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string value = "hex:";
+
+    for (size_t i = 0; i < size; i++) {
+        unsigned char byte = (unsigned char) (i * 131 + 7);
+
+        value += digits[byte >> 4];
+        value += digits[byte & 0x0F];
+    }
+
+    if (hex)
+        return value;
+
+    const char *argv_raw[] = {"app", "--blob", value.c_str(), nullptr};
+    char **argv = (char **) argv_raw;
+    int argc = 3;
+
+    c_flags_parse(&argc, &argv, false);
+
+    int rendered_argc = 0;
+    char **rendered_argv = c_flags_to_argv("app", false, &rendered_argc);
+    std::string rendered = rendered_argv[rendered_argc - 1];
+
+    free(rendered_argv);
+    return rendered;
+}
+
+static void decode(benchmark::State &state, bool hex)
+{
+    std::string token = "--blob=" + make_value((size_t) state.range(0), hex);
+
+    for (auto _ : state) {
+        const char *argv_raw[] = {"app", token.c_str(), nullptr};
+        char **argv = (char **) argv_raw;
+        int argc = 2;
+
+        c_flags_parse(&argc, &argv, false);
+        benchmark::DoNotOptimize(argv);
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_CAPTURE(decode, hex, true)->Range(64, 65536);
+BENCHMARK_CAPTURE(decode, base64, false)->Range(64, 65536);
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    declare_flags();
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <benchmark/benchmark.h>
+#include <c-flags.h>
+
+#include <string>
+#include <vector>
+
+// occurrences of the flag in one parsed argv, so conversions outweigh the parse setup
+#define OCCURRENCES 64
+
+static void declare_flags()
+{
+    c_flag_int("int", nullptr, nullptr, 0);
+    c_flag_int8("int8", nullptr, nullptr, 0);
+    c_flag_int16("int16", nullptr, nullptr, 0);
+    c_flag_int32("int32", nullptr, nullptr, 0);
+    c_flag_int64("int64", nullptr, nullptr, 0);
+    c_flag_unsigned("unsigned", nullptr, nullptr, 0);
+    c_flag_uint8("uint8", nullptr, nullptr, 0);
+    c_flag_uint16("uint16", nullptr, nullptr, 0);
+    c_flag_uint32("uint32", nullptr, nullptr, 0);
+    c_flag_uint64("uint64", nullptr, nullptr, 0);
+    c_flag_size_t("size_t", nullptr, nullptr, 0);
+    c_flag_float("float", nullptr, nullptr, 0);
+    c_flag_double("double", nullptr, nullptr, 0);
+    c_flag_bytes("bytes", nullptr, nullptr, 0);
+    c_flag_duration("duration", nullptr, nullptr, 0);
+}
+
+static void convert(benchmark::State &state, const char *name, const char *value)
+{
+    std::string token = std::string("--") + name + "=" + value;
+    std::vector<char *> args = {(char *) "app"};
+
+    for (int i = 0; i < OCCURRENCES; i++)
+        args.push_back(&token[0]);
+    args.push_back(nullptr);
+
+    for (auto _ : state) {
+        int argc = (int) args.size() - 1;
+        char **argv = args.data();
+
+        c_flags_parse(&argc, &argv, false);
+        benchmark::DoNotOptimize(argv);
+    }
+
+    state.SetItemsProcessed(state.iterations() * OCCURRENCES);
+}
+
+BENCHMARK_CAPTURE(convert, int, "int", "-2147483648");
+BENCHMARK_CAPTURE(convert, int8, "int8", "-128");
+BENCHMARK_CAPTURE(convert, int16, "int16", "-32768");
+BENCHMARK_CAPTURE(convert, int32, "int32", "-2147483648");
+BENCHMARK_CAPTURE(convert, int64, "int64", "-9223372036854775808");
+BENCHMARK_CAPTURE(convert, unsigned, "unsigned", "4294967295");
+BENCHMARK_CAPTURE(convert, uint8, "uint8", "255");
+BENCHMARK_CAPTURE(convert, uint16, "uint16", "65535");
+BENCHMARK_CAPTURE(convert, uint32, "uint32", "4294967295");
+BENCHMARK_CAPTURE(convert, uint64, "uint64", "18446744073709551615");
+BENCHMARK_CAPTURE(convert, size_t, "size_t", "18446744073709551615");
+BENCHMARK_CAPTURE(convert, float, "float", "3.40282347e+38");
+BENCHMARK_CAPTURE(convert, double, "double", "1.7976931348623157e+308");
+BENCHMARK_CAPTURE(convert, bytes, "bytes", "1.5GiB");
+BENCHMARK_CAPTURE(convert, duration, "duration", "1h2m3s4ms");
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    declare_flags();
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <benchmark/benchmark.h>
+#include <c-flags.h>
+
+// the static copy of the library exposes the separator search of lists
+extern "C" {
+#include "c-flags-internal.h"
+}
+
+#include <string>
+#include <vector>
+
+static const uint32_t **uint32_list = nullptr;
+static const int64_t **int64_list = nullptr;
+
+static void declare_flags()
+{
+    uint32_list = c_flag_uint32_list("uint32-list", nullptr, nullptr, nullptr);
+    int64_list = c_flag_int64_list("int64-list", nullptr, nullptr, nullptr);
+}
+
+// `count` elements separated by `separator`, like shard ids passed by schedulers
+static std::string make_list(size_t count, const char *separator)
+{
+    std::string value;
+
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0)
+            value += separator;
+        value += std::to_string(i * 7919 % 100000);
+    }
+
+    return value;
+}
+
+static void parse_list(benchmark::State &state, const char *name, const char *separator)
+{
+    std::string value = make_list((size_t) state.range(0), separator);
+    std::string token = std::string("--") + name + "=" + value;
+
+    for (auto _ : state) {
+        const char *argv_raw[] = {"app", token.c_str(), nullptr};
+        char **argv = (char **) argv_raw;
+        int argc = 2;
+
+        c_flags_parse(&argc, &argv, false);
+        benchmark::DoNotOptimize(argv);
+    }
+
+    state.SetBytesProcessed(state.iterations() * (int64_t) value.size());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// the separator search alone, the parse above is dominated by conversions of elements
+static void count_list(benchmark::State &state, const char *separator)
+{
+    std::string value = make_list((size_t) state.range(0), separator);
+
+    for (auto _ : state) {
+        size_t count = c_flags_list_count(value.data(), value.size());
+        benchmark::DoNotOptimize(count);
+    }
+
+    state.SetBytesProcessed(state.iterations() * (int64_t) value.size());
+}
+
+BENCHMARK_CAPTURE(count_list, comma, ",")->Range(16, 100000);
+BENCHMARK_CAPTURE(count_list, spaces, " , ")->Range(16, 100000);
+
+BENCHMARK_CAPTURE(parse_list, uint32_comma, "uint32-list", ",")->Range(16, 100000);
+BENCHMARK_CAPTURE(parse_list, uint32_spaces, "uint32-list", " , ")->Range(16, 100000);
+BENCHMARK_CAPTURE(parse_list, int64_comma, "int64-list", ",")->Range(16, 100000);
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    declare_flags();
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
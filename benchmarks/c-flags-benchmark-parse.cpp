@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <benchmark/benchmark.h>
+#include <c-flags.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// number of declared flags, the registry is global, so every size runs in its own process
+static size_t flags_count = 10;
+
+static std::vector<std::string> long_names;
+static std::vector<std::string> short_names;
+
+enum class Form {
+    Separate, // `--flag value`
+    Equal,    // `--flag=value`
+    Short,    // `-f value`
+};
+
+static void declare_flags(size_t count)
+{
+    long_names.reserve(count);
+    short_names.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        long_names.push_back("flag-" + std::to_string(i));
+        short_names.push_back("f" + std::to_string(i));
+
+        c_flag_int(long_names[i].c_str(), short_names[i].c_str(), "description of the flag", 0);
+    }
+}
+
+/*
+ * Parse argv with `range(0)` flags spread over the whole registry,
+ * so lookups don't favour the first declared flags.
+ */
+static void parse(benchmark::State &state, Form form)
+{
+    size_t tokens = (size_t) state.range(0);
+    std::vector<std::string> strings;
+
+    for (size_t i = 0; i < tokens; i++) {
+        size_t index = (i * 7919) % flags_count;
+        std::string value = std::to_string(i);
+
+        switch (form) {
+        case Form::Separate:
+            strings.push_back("--" + long_names[index]);
+            strings.push_back(value);
+            break;
+        case Form::Equal:
+            strings.push_back("--" + long_names[index] + "=" + value);
+            break;
+        case Form::Short:
+            strings.push_back("-" + short_names[index]);
+            strings.push_back(value);
+            break;
+        }
+    }
+
+    std::vector<char *> args = {(char *) "app"};
+    for (std::string &string : strings)
+        args.push_back(&string[0]);
+    args.push_back(nullptr);
+
+    for (auto _ : state) {
+        int argc = (int) args.size() - 1;
+        char **argv = args.data();
+
+        c_flags_parse(&argc, &argv, false);
+        benchmark::DoNotOptimize(argv);
+    }
+
+    state.SetItemsProcessed((int64_t) (state.iterations() * tokens));
+}
+
+BENCHMARK_CAPTURE(parse, separate, Form::Separate)->RangeMultiplier(16)->Range(1, 4096);
+BENCHMARK_CAPTURE(parse, equal, Form::Equal)->RangeMultiplier(16)->Range(1, 4096);
+BENCHMARK_CAPTURE(parse, short, Form::Short)->RangeMultiplier(16)->Range(1, 4096);
+
+static void usage(benchmark::State &state)
+{
+    static const char *descriptions[] = {"benchmark", "usage benchmark"};
+    size_t size = 0;
+
+    for (auto _ : state) {
+        // a new description drops the cached text, so it's rendered again
+        c_flags_set_description(descriptions[state.iterations() % 2]);
+
+        const char *text = c_flags_usage_text(&size);
+        benchmark::DoNotOptimize(text);
+    }
+
+    state.SetBytesProcessed((int64_t) (state.iterations() * size));
+}
+
+BENCHMARK(usage);
+
+static void usage_cached(benchmark::State &state)
+{
+    c_flags_usage_text(nullptr);
+
+    for (auto _ : state) {
+        const char *text = c_flags_usage_text(nullptr);
+        benchmark::DoNotOptimize(text);
+    }
+}
+
+BENCHMARK(usage_cached);
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--flags=", strlen("--flags=")) != 0) {
+            fprintf(stderr, "unknown argument %s, expected --flags=<count>\n", argv[i]);
+            return 1;
+        }
+
+        flags_count = strtoul(argv[i] + strlen("--flags="), nullptr, 10);
+    }
+
+    if (flags_count == 0) {
+        fprintf(stderr, "the number of flags must be positive\n");
+        return 1;
+    }
+
+    declare_flags(flags_count);
+    benchmark::AddCustomContext("flags", std::to_string(flags_count));
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
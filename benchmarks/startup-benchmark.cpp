@@ -0,0 +1,256 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Measure programs generated by startup-generate from exec to the end of
+ * parsing, where they stop themselves with SIGSTOP. The time is taken from
+ * right before `execv()` until the stop is reported, counters are read from
+ * `perf_event_open()` while the program is stopped, so they cover the dynamic
+ * loader, static initialization, flag registration and parsing.
+ *
+ *  startup-benchmark [--benchmark_*] <label> <program> <flags count> ...
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// flags passed on the command line of every program
+#define STARTUP_ARGV_FLAGS 16
+
+typedef struct
+{
+    uint32_t type;
+    uint64_t config;
+    const char *name;
+} StartupCounter;
+
+static const StartupCounter startup_counters[] = {
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, "task_clock_ns"},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, "page_faults"},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions"},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles"},
+};
+
+#define STARTUP_COUNTERS (sizeof(startup_counters) / sizeof(startup_counters[0]))
+
+typedef struct
+{
+    std::string label;
+    std::string path;
+    std::vector<std::string> args;
+} StartupProgram;
+
+typedef struct
+{
+    double seconds;
+    uint64_t counts[STARTUP_COUNTERS];
+    bool available[STARTUP_COUNTERS];
+} StartupMeasurement;
+
+// counters that are unavailable, like hardware counters in VMs, are skipped
+static int perf_open(const StartupCounter *counter, pid_t pid)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+
+    attr.size = sizeof(attr);
+    attr.type = counter->type;
+    attr.config = counter->config;
+    attr.disabled = 1;
+    attr.enable_on_exec = 1;
+    attr.exclude_hv = 1;
+
+    int fd = (int) syscall(SYS_perf_event_open, &attr, pid, -1, -1, PERF_FLAG_FD_CLOEXEC);
+
+    // unprivileged users may count only user space
+    if (fd < 0) {
+        attr.exclude_kernel = 1;
+        fd = (int) syscall(SYS_perf_event_open, &attr, pid, -1, -1, PERF_FLAG_FD_CLOEXEC);
+    }
+
+    return fd;
+}
+
+static double elapsed(const struct timespec &begin, const struct timespec &end)
+{
+    return (double) (end.tv_sec - begin.tv_sec) + (double) (end.tv_nsec - begin.tv_nsec) * 1e-9;
+}
+
+static bool run(const StartupProgram &program, StartupMeasurement *measurement)
+{
+    std::vector<char *> argv = {(char *) program.path.c_str()};
+    for (const std::string &arg : program.args)
+        argv.push_back((char *) arg.c_str());
+    argv.push_back(nullptr);
+
+    int go[2];
+    int stamp[2];
+
+    if (pipe2(go, O_CLOEXEC) < 0)
+        return false;
+
+    if (pipe2(stamp, O_CLOEXEC) < 0) {
+        close(go[0]);
+        close(go[1]);
+        return false;
+    }
+
+    pid_t pid = fork();
+
+    // the child waits until counters are attached, then takes the time and execs
+    if (pid == 0) {
+        char byte = 0;
+        struct timespec begin;
+
+        if (read(go[0], &byte, 1) != 1)
+            _exit(127);
+
+        int null_fd = open("/dev/null", O_WRONLY);
+        if (null_fd >= 0) {
+            dup2(null_fd, STDOUT_FILENO);
+            close(null_fd);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        if (write(stamp[1], &begin, sizeof(begin)) != sizeof(begin))
+            _exit(127);
+
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+
+    close(go[0]);
+    close(stamp[1]);
+
+    if (pid < 0) {
+        close(go[1]);
+        close(stamp[0]);
+        return false;
+    }
+
+    int fds[STARTUP_COUNTERS];
+    for (size_t i = 0; i < STARTUP_COUNTERS; i++)
+        fds[i] = perf_open(&startup_counters[i], pid);
+
+    struct timespec begin;
+    struct timespec end;
+    int status = 0;
+
+    bool started = write(go[1], "x", 1) == 1 &&
+                   read(stamp[0], &begin, sizeof(begin)) == sizeof(begin);
+
+    waitpid(pid, &status, WUNTRACED);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    bool stopped = started && WIFSTOPPED(status);
+
+    measurement->seconds = elapsed(begin, end);
+
+    for (size_t i = 0; i < STARTUP_COUNTERS; i++) {
+        uint64_t count = 0;
+
+        measurement->available[i] = fds[i] >= 0 &&
+                                    read(fds[i], &count, sizeof(count)) == sizeof(count);
+        measurement->counts[i] = count;
+
+        if (fds[i] >= 0)
+            close(fds[i]);
+    }
+
+    // the exit is not measured
+    if (WIFSTOPPED(status)) {
+        kill(pid, SIGKILL);
+        waitpid(pid, &status, 0);
+    }
+
+    close(go[1]);
+    close(stamp[0]);
+
+    return stopped;
+}
+
+static void startup(benchmark::State &state, const StartupProgram *program)
+{
+    StartupMeasurement measurement;
+    uint64_t sums[STARTUP_COUNTERS] = {0};
+    bool available[STARTUP_COUNTERS];
+
+    for (size_t i = 0; i < STARTUP_COUNTERS; i++)
+        available[i] = true;
+
+    for (auto _ : state) {
+        if (!run(*program, &measurement)) {
+            state.SkipWithError("the program didn't stop after parsing");
+            break;
+        }
+
+        state.SetIterationTime(measurement.seconds);
+
+        for (size_t i = 0; i < STARTUP_COUNTERS; i++) {
+            sums[i] += measurement.counts[i];
+            available[i] = available[i] && measurement.available[i];
+        }
+    }
+
+    for (size_t i = 0; i < STARTUP_COUNTERS; i++) {
+        if (available[i]) {
+            state.counters[startup_counters[i].name] =
+                benchmark::Counter((double) sums[i], benchmark::Counter::kAvgIterations);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+
+    if (argc < 4 || (argc - 1) % 3 != 0) {
+        fprintf(stderr, "usage: %s [--benchmark_*] <label> <program> <flags count> ...\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<StartupProgram> programs;
+
+    for (int i = 1; i < argc; i += 3) {
+        StartupProgram program = {argv[i], argv[i + 1], {}};
+        unsigned long count = strtoul(argv[i + 2], nullptr, 10);
+
+        // the same flags spread over the whole table for every program
+        for (unsigned long j = 0; j < STARTUP_ARGV_FLAGS && count > 0; j++) {
+            program.args.push_back("--flag-" + std::to_string((j * 7919) % count));
+            program.args.push_back(std::to_string(j));
+        }
+
+        programs.push_back(program);
+    }
+
+    for (const StartupProgram &program : programs) {
+        benchmark::RegisterBenchmark(("startup/" + program.label).c_str(),
+                                     [&program](benchmark::State &state) {
+                                         startup(state, &program);
+                                     })
+            ->UseManualTime()
+            ->Unit(benchmark::kMicrosecond);
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Generate a program declaring the number of integer flags and parsing argv
+ * either with c-flags or with an equivalent `getopt_long()` table. Programs
+ * stop themselves right after parsing, so the startup benchmark reads their
+ * counters at that point.
+ *
+ *  startup-generate <c-flags|getopt> <count> <output.c>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void generate_c_flags(FILE *file, unsigned long count)
+{
+    fprintf(file, "#include <signal.h>\n#include <c-flags.h>\n\n");
+    fprintf(file, "int main(int argc, char **argv)\n{\n");
+
+    for (unsigned long i = 0; i < count; i++) {
+        fprintf(file,
+                "    c_flag_int(\"flag-%lu\", NULL, \"description of flag %lu\", 0);\n",
+                i,
+                i);
+    }
+
+    fprintf(file, "\n    c_flags_parse(&argc, &argv, false);\n");
+    fprintf(file, "    raise(SIGSTOP);\n\n    return 0;\n}\n");
+}
+
+static void generate_getopt(FILE *file, unsigned long count)
+{
+    fprintf(file, "#include <getopt.h>\n#include <signal.h>\n#include <stdio.h>\n");
+    fprintf(file, "#include <stdlib.h>\n\n");
+    fprintf(file, "static int values[%lu];\n\n", count);
+    fprintf(file, "static const struct option options[] = {\n");
+
+    for (unsigned long i = 0; i < count; i++)
+        fprintf(file, "    {\"flag-%lu\", required_argument, NULL, 0},\n", i);
+
+    fprintf(file, "    {NULL, 0, NULL, 0},\n};\n\n");
+    fprintf(file, "int main(int argc, char **argv)\n{\n");
+    fprintf(file, "    int index = 0;\n    int option = 0;\n\n");
+    fprintf(file, "    while ((option = getopt_long(argc, argv, \"\", options, &index)) != -1) "
+                  "{\n");
+    fprintf(file, "        char *end = NULL;\n\n");
+    fprintf(file, "        if (option != 0)\n            return 1;\n\n");
+    fprintf(file, "        values[index] = (int) strtol(optarg, &end, 10);\n\n");
+    fprintf(file, "        if (*end != '\\0') {\n");
+    fprintf(file, "            printf(\"ERROR: invalid value %%s\\n\", optarg);\n");
+    fprintf(file, "            return 1;\n        }\n    }\n\n");
+    fprintf(file, "    raise(SIGSTOP);\n\n    return 0;\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 4 || (strcmp(argv[1], "c-flags") != 0 && strcmp(argv[1], "getopt") != 0)) {
+        fprintf(stderr, "usage: %s <c-flags|getopt> <count> <output.c>\n", argv[0]);
+        return 1;
+    }
+
+    unsigned long count = strtoul(argv[2], NULL, 10);
+
+    FILE *file = fopen(argv[3], "w");
+    if (file == NULL) {
+        perror(argv[3]);
+        return 1;
+    }
+
+    fprintf(file, "// generated by startup-generate, do not edit\n\n");
+
+    if (!strcmp(argv[1], "c-flags"))
+        generate_c_flags(file, count);
+    else
+        generate_getopt(file, count);
+
+    return fclose(file) == 0 ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <benchmark/benchmark.h>
+#include "string-view.h"
+
+#include <string>
+
+// string of `range(0)` characters like a long flag name or value
+static std::string make_string(benchmark::State &state)
+{
+    return std::string((size_t) state.range(0), 'a');
+}
+
+static void sv_from_string_benchmark(benchmark::State &state)
+{
+    std::string string = make_string(state);
+
+    for (auto _ : state) {
+        StringView sv = sv_from_string(string.c_str());
+        benchmark::DoNotOptimize(sv);
+    }
+
+    state.SetBytesProcessed((int64_t) (state.iterations() * string.size()));
+}
+
+static void sv_equal_benchmark(benchmark::State &state)
+{
+    std::string a = make_string(state);
+    std::string b = make_string(state);
+
+    StringView sv_a = sv_from_string(a.c_str());
+    StringView sv_b = sv_from_string(b.c_str());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sv_a);
+        benchmark::DoNotOptimize(sv_equal(sv_a, sv_b));
+    }
+
+    state.SetBytesProcessed((int64_t) (state.iterations() * a.size()));
+}
+
+static void sv_starts_with_benchmark(benchmark::State &state)
+{
+    std::string string = "--" + make_string(state);
+
+    StringView sv = sv_from_string(string.c_str());
+    StringView prefix = sv_from_string("--");
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sv);
+        benchmark::DoNotOptimize(sv_starts_with(sv, prefix));
+    }
+}
+
+// the worst case of `--flag=value` detection: no '=' in the token
+static void sv_index_of_benchmark(benchmark::State &state)
+{
+    std::string string = make_string(state);
+
+    StringView sv = sv_from_string(string.c_str());
+    StringView eq = sv_from_string("=");
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sv);
+        benchmark::DoNotOptimize(sv_index_of(sv, eq));
+    }
+
+    state.SetBytesProcessed((int64_t) (state.iterations() * string.size()));
+}
+
+static void sv_contains_benchmark(benchmark::State &state)
+{
+    std::string string = make_string(state) + "=";
+
+    StringView sv = sv_from_string(string.c_str());
+    StringView eq = sv_from_string("=");
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sv);
+        benchmark::DoNotOptimize(sv_contains(sv, eq));
+    }
+
+    state.SetBytesProcessed((int64_t) (state.iterations() * string.size()));
+}
+
+static void sv_chop_left_benchmark(benchmark::State &state)
+{
+    std::string string = make_string(state);
+    StringView sv = sv_from_string(string.c_str());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sv);
+        benchmark::DoNotOptimize(sv_chop_left(sv_slice_left(sv, sv.size / 2), 2));
+    }
+}
+
+BENCHMARK(sv_from_string_benchmark)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK(sv_equal_benchmark)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK(sv_starts_with_benchmark)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK(sv_index_of_benchmark)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK(sv_contains_benchmark)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK(sv_chop_left_benchmark)->RangeMultiplier(8)->Range(8, 4096);
+
+BENCHMARK_MAIN();
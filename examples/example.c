@@ -20,6 +20,7 @@ int main(int argc, char *argv[])
     size_t *offset = c_flag_size_t("offset", "off", "declare file offset", 0);
     bool *help = c_flag_bool("help", "h", "show usage", false);
 
+    c_flags_add_completion_flag();
     c_flags_parse(&argc, &argv, false);
 
     if (*help) {
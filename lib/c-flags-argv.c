@@ -0,0 +1,353 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+
+// enough for any number, for the names of set flags and for CPU sets
+#define C_FLAGS_ARGV_VALUE_SIZE C_FLAGS_CPUS_FORMAT_SIZE
+
+// write digits backward from the end of the buffer
+static char *format_unsigned(uintmax_t value, char *end)
+{
+    do {
+        *--end = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    return end;
+}
+
+static char *format_signed(intmax_t value, char *end)
+{
+    uintmax_t magnitude = (value < 0) ? -(uintmax_t) value : (uintmax_t) value;
+
+    end = format_unsigned(magnitude, end);
+    if (value < 0)
+        *--end = '-';
+
+    return end;
+}
+
+/*
+ * Format with the shortest precision that converts back to the same value,
+ * 17 and 9 digits are always enough for the exact round trip.
+ */
+static char *format_double(double value, char *buffer)
+{
+    for (int precision = 15; precision <= 17; precision++) {
+        snprintf(buffer, C_FLAGS_ARGV_VALUE_SIZE, "%.*g", precision, value);
+
+        if (strtod(buffer, NULL) == value)
+            break;
+    }
+
+    return buffer;
+}
+
+static char *format_float(float value, char *buffer)
+{
+    for (int precision = 6; precision <= 9; precision++) {
+        snprintf(buffer, C_FLAGS_ARGV_VALUE_SIZE, "%.*g", precision, (double) value);
+
+        if (strtof(buffer, NULL) == value)
+            break;
+    }
+
+    return buffer;
+}
+
+/*
+ * Format the flag value in the form accepted by `c_flags_parse()`.
+ * Returns NULL for NULL strings and files that cannot be passed in argv.
+ */
+static const char *format_value(const CFlag *flag, char *buffer, size_t *size_ptr)
+{
+    CFlagValue flag_value = c_flag_get_value(flag);
+    char *end = buffer + C_FLAGS_ARGV_VALUE_SIZE - 1;
+    const char *value = NULL;
+
+    *end = '\0';
+
+    switch (flag->type) {
+    case C_FLAG_INT:
+        value = format_signed(flag_value.as_int, end);
+        break;
+    case C_FLAG_INT_8:
+        value = format_signed(flag_value.as_int8, end);
+        break;
+    case C_FLAG_INT_16:
+        value = format_signed(flag_value.as_int16, end);
+        break;
+    case C_FLAG_INT_32:
+        value = format_signed(flag_value.as_int32, end);
+        break;
+    case C_FLAG_INT_64:
+        value = format_signed(flag_value.as_int64, end);
+        break;
+    case C_FLAG_UNSIGNED:
+        value = format_unsigned(flag_value.as_unsigned, end);
+        break;
+    case C_FLAG_UINT_8:
+        value = format_unsigned(flag_value.as_uint8, end);
+        break;
+    case C_FLAG_UINT_16:
+        value = format_unsigned(flag_value.as_uint16, end);
+        break;
+    case C_FLAG_UINT_32:
+        value = format_unsigned(flag_value.as_uint32, end);
+        break;
+    case C_FLAG_UINT_64:
+        value = format_unsigned(flag_value.as_uint64, end);
+        break;
+    case C_FLAG_SIZE_T:
+        value = format_unsigned(flag_value.as_size_t, end);
+        break;
+    case C_FLAG_BOOL:
+        value = flag_value.as_bool ? "true" : "false";
+        break;
+    case C_FLAG_STRING:
+        value = flag_value.as_string;
+        break;
+    case C_FLAG_FLOAT:
+        value = format_float(flag_value.as_float, buffer);
+        break;
+    case C_FLAG_DOUBLE:
+        value = format_double(flag_value.as_double, buffer);
+        break;
+    case C_FLAG_BYTES:
+        value = c_flags_format_bytes(flag_value.as_bytes, buffer, C_FLAGS_ARGV_VALUE_SIZE);
+        break;
+    case C_FLAG_DURATION:
+        value = c_flags_format_duration(flag_value.as_duration, buffer, C_FLAGS_ARGV_VALUE_SIZE);
+        break;
+    case C_FLAG_CHOICE:
+        value = c_flags_format_choice(flag->choices,
+                                      flag_value.as_choice,
+                                      buffer,
+                                      C_FLAGS_ARGV_VALUE_SIZE);
+        break;
+    case C_FLAG_SET:
+        value = c_flags_format_set(flag->choices,
+                                   flag_value.as_set,
+                                   buffer,
+                                   C_FLAGS_ARGV_VALUE_SIZE);
+        break;
+#if defined(__linux__)
+    case C_FLAG_CPUS:
+        value = c_flags_format_cpus(flag_value.as_cpus, buffer, C_FLAGS_ARGV_VALUE_SIZE);
+        break;
+#endif
+    case C_FLAG_INT32_LIST:
+    case C_FLAG_INT64_LIST:
+    case C_FLAG_UINT32_LIST:
+    case C_FLAG_UINT64_LIST:
+    case C_FLAG_DOUBLE_LIST:
+    case C_FLAG_BINARY:
+        // lists have no size limit and are formatted directly into the argv strings
+        *size_ptr = c_flags_format_list(flag->type, flag_value.as_list, NULL, 0);
+        return "";
+    case C_FLAG_COUNTER:
+        value = format_unsigned(flag_value.as_counter, end);
+        break;
+    case C_FLAG_STRINGS:
+        // elements are rendered as separate occurrences
+        *size_ptr = 0;
+        return "";
+#if defined(__linux__)
+    case C_FLAG_PATH:
+    case C_FLAG_DIRECTORY:
+    case C_FLAG_FILE:
+    case C_FLAG_MAPPED_FILE:
+        value = c_flag_format(flag, flag_value, buffer, C_FLAGS_ARGV_VALUE_SIZE);
+        break;
+#endif
+    default:
+        assert(false && "not all flag types implements format_value()");
+    }
+
+    if (value != NULL)
+        *size_ptr = strlen(value);
+
+    return value;
+}
+
+/*
+ * Render flags to the buffer, or only count the arguments and the buffer size
+ * if the buffer is NULL. Booleans are rendered as `--flag` or `--flag=false`,
+ * counters as `--flag=count`, accumulating flags as `--flag` and `value`
+ * arguments for every element, other flags as `--flag` and `value` arguments,
+ * so that values may be empty or start with a dash.
+ */
+static size_t render_argv(char *buffer, const char *program, bool all, int *argc_ptr)
+{
+    char value_buffer[C_FLAGS_ARGV_VALUE_SIZE];
+
+    size_t argc = 1;
+    size_t strings_size = 0;
+
+    for (size_t i = 0; i < c_flags_count(); i++) {
+        const CFlag *flag = c_flags_at(i);
+
+        if (!all && c_flag_value_equal(flag, c_flag_get_value(flag), flag->default_value))
+            continue;
+
+        size_t value_size = 0;
+        const char *value = format_value(flag, value_buffer, &value_size);
+
+        if (value == NULL)
+            continue;
+
+        bool bool_true = flag->type == C_FLAG_BOOL && c_flag_get_value(flag).as_bool;
+        bool bool_false = flag->type == C_FLAG_BOOL && !bool_true;
+
+        size_t name_size = strlen(flag->long_name);
+        size_t option_size = strlen("--") + name_size + (bool_false ? strlen("=false") : 0) + 1;
+
+        if (flag->type == C_FLAG_STRINGS) {
+            for (char **values = c_flag_get_value(flag).as_strings; *values != NULL; values++) {
+                argc += 2;
+                strings_size += option_size + strlen(*values) + 1;
+            }
+
+            continue;
+        }
+
+        if (flag->type == C_FLAG_BOOL) {
+            argc += 1;
+            strings_size += option_size;
+        }
+        else if (flag->type == C_FLAG_COUNTER) {
+            argc += 1;
+            strings_size += option_size + strlen("=") + value_size;
+        }
+        else {
+            argc += 2;
+            strings_size += option_size + value_size + 1;
+        }
+    }
+
+    size_t total_size = (argc + 1) * sizeof(char *) + strings_size;
+
+    if (argc_ptr != NULL)
+        *argc_ptr = (int) argc;
+
+    if (buffer == NULL)
+        return total_size;
+
+    char **argv = (char **) buffer;
+    char *strings = buffer + (argc + 1) * sizeof(char *);
+    size_t arg = 0;
+
+    argv[arg++] = (char *) program;
+
+    for (size_t i = 0; i < c_flags_count(); i++) {
+        const CFlag *flag = c_flags_at(i);
+
+        if (!all && c_flag_value_equal(flag, c_flag_get_value(flag), flag->default_value))
+            continue;
+
+        size_t value_size = 0;
+        const char *value = format_value(flag, value_buffer, &value_size);
+
+        if (value == NULL)
+            continue;
+
+        size_t name_size = strlen(flag->long_name);
+
+        if (flag->type == C_FLAG_STRINGS) {
+            for (char **values = c_flag_get_value(flag).as_strings; *values != NULL; values++) {
+                size_t element_size = strlen(*values);
+
+                argv[arg++] = strings;
+                memcpy(strings, "--", 2);
+                memcpy(strings + 2, flag->long_name, name_size + 1);
+                strings += 2 + name_size + 1;
+
+                argv[arg++] = strings;
+                memcpy(strings, *values, element_size + 1);
+                strings += element_size + 1;
+            }
+
+            continue;
+        }
+
+        argv[arg++] = strings;
+        memcpy(strings, "--", 2);
+        memcpy(strings + 2, flag->long_name, name_size);
+        strings += 2 + name_size;
+
+        if (flag->type == C_FLAG_COUNTER) {
+            *strings++ = '=';
+            memcpy(strings, value, value_size);
+            strings += value_size;
+
+            *strings++ = '\0';
+            continue;
+        }
+
+        if (flag->type == C_FLAG_BOOL) {
+            if (!c_flag_get_value(flag).as_bool) {
+                memcpy(strings, "=false", 6);
+                strings += 6;
+            }
+
+            *strings++ = '\0';
+            continue;
+        }
+
+        *strings++ = '\0';
+
+        argv[arg++] = strings;
+
+        if (c_flags_is_list(flag->type)) {
+            const void *list = c_flag_get_value(flag).as_list;
+            c_flags_format_list(flag->type, list, strings, value_size + 1);
+        }
+        else {
+            memcpy(strings, value, value_size);
+        }
+
+        strings += value_size;
+        *strings++ = '\0';
+    }
+
+    argv[arg] = NULL;
+    return total_size;
+}
+
+size_t c_flags_to_argv_buffer(void *buffer, size_t size, const char *program, bool all,
+                              int *argc_ptr)
+{
+    assert(program != NULL && "the program name is required and cannot be NULL");
+
+    c_flags_lock();
+
+    size_t required_size = render_argv(NULL, program, all, argc_ptr);
+    if (buffer != NULL && size >= required_size)
+        render_argv(buffer, program, all, argc_ptr);
+
+    c_flags_unlock();
+    return required_size;
+}
+
+char **c_flags_to_argv(const char *program, bool all, int *argc_ptr)
+{
+    assert(program != NULL && "the program name is required and cannot be NULL");
+
+    c_flags_lock();
+
+    char *buffer = malloc(render_argv(NULL, program, all, argc_ptr));
+    if (buffer != NULL)
+        render_argv(buffer, program, all, argc_ptr);
+
+    c_flags_unlock();
+    return (char **) buffer;
+}
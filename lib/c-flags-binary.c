@@ -0,0 +1,647 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+
+#if defined(C_FLAGS_SSE2)
+#include <emmintrin.h>
+#elif defined(C_FLAGS_NEON)
+#include <arm_neon.h>
+#endif
+
+#define C_FLAGS_BINARY_ONES    0x0101010101010101ULL
+#define C_FLAGS_BINARY_HIGHS   0x8080808080808080ULL
+#define C_FLAGS_BINARY_INVALID 0xFF
+
+// characters of the described value shown in errors, the rest is replaced by "..."
+#define C_FLAGS_BINARY_DESCRIBED 32
+
+static const char hex_prefix[] = "hex:";
+static const char base64_prefix[] = "base64:";
+
+static const char base64_alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// values of base64 characters, other characters are C_FLAGS_BINARY_INVALID
+static const uint8_t base64_values[256] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 62,  255, 255, 255, 63,
+    52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  255, 255, 255, 255, 255, 255,
+    255, 0,   1,   2,   3,   4,   5,   6,   7,   8,   9,   10,  11,  12,  13,  14,
+    15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  255, 255, 255, 255, 255,
+    255, 26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,
+    41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+/*
+ * Why the value is invalid, `offset` is the offset of the invalid character
+ * in the value or SIZE_MAX if the reason is not about one character.
+ */
+typedef struct
+{
+    const char *reason;
+    size_t offset;
+} CFlagsBinaryError;
+
+// assemble the word in string order, so the first byte is the lowest on any endianness
+static uint64_t binary_load_word(const unsigned char *bytes)
+{
+    uint64_t word = 0;
+
+    for (size_t i = 0; i < sizeof(uint64_t); i++)
+        word |= (uint64_t) bytes[i] << (i * 8);
+
+    return word;
+}
+
+// high bit of every byte greater than low and less than high, bytes must be below 0x80
+static uint64_t binary_between(uint64_t word, uint64_t low, uint64_t high)
+{
+    uint64_t lows = word & (C_FLAGS_BINARY_ONES * 127);
+
+    return (C_FLAGS_BINARY_ONES * (127 + high) - lows) & ~word &
+           (lows + C_FLAGS_BINARY_ONES * (127 - low)) & C_FLAGS_BINARY_HIGHS;
+}
+
+#if defined(C_FLAGS_SSE2)
+// 0xFF in bytes greater than low and less than high, signed compares leave bytes above 0x7F out
+static __m128i binary_between_sse2(__m128i chunk, char low, char high)
+{
+    return _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8(low)),
+                         _mm_cmplt_epi8(chunk, _mm_set1_epi8(high)));
+}
+
+/*
+ * Decode hex digits sixteen at a time into eight bytes. Returns the number
+ * of decoded digits, the vector with an invalid digit is left to SWAR.
+ */
+static size_t hex_decode_vector(const unsigned char *text, size_t size, uint8_t *out)
+{
+    size_t i = 0;
+
+    for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) (text + i));
+        __m128i lower = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+        __m128i digits = binary_between_sse2(chunk, '0' - 1, '9' + 1);
+        __m128i letters = binary_between_sse2(lower, 'a' - 1, 'f' + 1);
+
+        if (_mm_movemask_epi8(_mm_or_si128(digits, letters)) != 0xFFFF)
+            break;
+
+        __m128i nibbles = _mm_add_epi8(_mm_and_si128(chunk, _mm_set1_epi8(0x0F)),
+                                       _mm_and_si128(letters, _mm_set1_epi8(9)));
+
+        // the first digit of a pair is the low byte of a 16-bit lane
+        __m128i highs = _mm_and_si128(_mm_slli_epi16(nibbles, 4), _mm_set1_epi16(0xF0));
+        __m128i pairs = _mm_or_si128(highs, _mm_srli_epi16(nibbles, 8));
+
+        _mm_storel_epi64((__m128i *) (out + i / 2), _mm_packus_epi16(pairs, pairs));
+    }
+
+    return i;
+}
+
+/*
+ * Values of sixteen base64 characters, every range of the alphabet is
+ * selected by compares and shifted to its values. `valid_ptr` is set to
+ * 0xFF in bytes of valid characters.
+ */
+static __m128i base64_values_sse2(__m128i chunk, __m128i *valid_ptr)
+{
+    __m128i upper = binary_between_sse2(chunk, 'A' - 1, 'Z' + 1);
+    __m128i lower = binary_between_sse2(chunk, 'a' - 1, 'z' + 1);
+    __m128i digits = binary_between_sse2(chunk, '0' - 1, '9' + 1);
+    __m128i plus = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('+'));
+    __m128i slash = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('/'));
+
+    __m128i shift = _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                                 _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+    shift = _mm_or_si128(shift, _mm_and_si128(digits, _mm_set1_epi8(52 - '0')));
+    shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(62 - '+')));
+    shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+
+    *valid_ptr = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digits, plus));
+    *valid_ptr = _mm_or_si128(*valid_ptr, slash);
+
+    return _mm_add_epi8(chunk, shift);
+}
+
+/*
+ * Decode base64 characters sixteen at a time into twelve bytes. They are
+ * written by two 8-byte stores, the second one runs into the next group,
+ * so the last group is left to the scalar kernel. Returns the number of
+ * decoded characters, the vector with an invalid character is left too.
+ */
+static size_t base64_decode_vector(const unsigned char *text, size_t size, uint8_t *out)
+{
+    size_t i = 0;
+
+    for (; i + sizeof(__m128i) + 4 <= size; i += sizeof(__m128i), out += 12) {
+        __m128i valid;
+        __m128i values = base64_values_sse2(_mm_loadu_si128((const __m128i *) (text + i)), &valid);
+
+        if (_mm_movemask_epi8(valid) != 0xFFFF)
+            break;
+
+        // pairs of 6-bit values are joined in 16-bit lanes, then pairs of lanes in 32-bit lanes
+        __m128i pairs = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0xFF)), 6),
+                                     _mm_srli_epi16(values, 8));
+        __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+
+        // the first byte of a group is the highest of its 24 bits, it's moved to the lowest
+        groups = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(groups, 16),
+                                           _mm_and_si128(groups, _mm_set1_epi32(0xFF00))),
+                              _mm_slli_epi32(_mm_and_si128(groups, _mm_set1_epi32(0xFF)), 16));
+
+        // 3 bytes of the odd groups are moved next to 3 bytes of the even groups
+        __m128i bytes = _mm_or_si128(
+            _mm_and_si128(groups, _mm_set_epi32(0, 0xFFFFFF, 0, 0xFFFFFF)),
+            _mm_and_si128(_mm_srli_epi64(groups, 8),
+                          _mm_set_epi32(0xFFFF, (int) 0xFF000000, 0xFFFF, (int) 0xFF000000)));
+
+        _mm_storel_epi64((__m128i *) out, bytes);
+        _mm_storel_epi64((__m128i *) (out + 6), _mm_srli_si128(bytes, 8));
+    }
+
+    return i;
+}
+#elif defined(C_FLAGS_NEON)
+// 0xFF in bytes greater than low and less than high
+static uint8x16_t binary_between_neon(uint8x16_t chunk, uint8_t low, uint8_t high)
+{
+    return vandq_u8(vcgtq_u8(chunk, vdupq_n_u8(low)), vcltq_u8(chunk, vdupq_n_u8(high)));
+}
+
+/*
+ * Decode hex digits sixteen at a time into eight bytes. Returns the number
+ * of decoded digits, the vector with an invalid digit is left to SWAR.
+ */
+static size_t hex_decode_vector(const unsigned char *text, size_t size, uint8_t *out)
+{
+    size_t i = 0;
+
+    for (; i + sizeof(uint8x16_t) <= size; i += sizeof(uint8x16_t)) {
+        uint8x16_t chunk = vld1q_u8(text + i);
+        uint8x16_t lower = vorrq_u8(chunk, vdupq_n_u8(0x20));
+        uint8x16_t digits = binary_between_neon(chunk, '0' - 1, '9' + 1);
+        uint8x16_t letters = binary_between_neon(lower, 'a' - 1, 'f' + 1);
+
+        if (vminvq_u8(vorrq_u8(digits, letters)) == 0)
+            break;
+
+        uint8x16_t nibbles = vaddq_u8(vandq_u8(chunk, vdupq_n_u8(0x0F)),
+                                      vandq_u8(letters, vdupq_n_u8(9)));
+
+        // the first digits of pairs are shifted into the high halves of the second ones
+        uint8x16_t pairs = vsliq_n_u8(vuzp2q_u8(nibbles, nibbles), vuzp1q_u8(nibbles, nibbles), 4);
+
+        vst1_u8(out + i / 2, vget_low_u8(pairs));
+    }
+
+    return i;
+}
+
+/*
+ * Values of sixteen base64 characters, every range of the alphabet is
+ * selected by compares and shifted to its values. Bytes of invalid
+ * characters are cleared in `valid`.
+ */
+static uint8x16_t base64_values_neon(uint8x16_t chunk, uint8x16_t *valid)
+{
+    uint8x16_t upper = binary_between_neon(chunk, 'A' - 1, 'Z' + 1);
+    uint8x16_t lower = binary_between_neon(chunk, 'a' - 1, 'z' + 1);
+    uint8x16_t digits = binary_between_neon(chunk, '0' - 1, '9' + 1);
+    uint8x16_t plus = vceqq_u8(chunk, vdupq_n_u8('+'));
+    uint8x16_t slash = vceqq_u8(chunk, vdupq_n_u8('/'));
+
+    uint8x16_t shift = vorrq_u8(vandq_u8(upper, vdupq_n_u8((uint8_t) -'A')),
+                                vandq_u8(lower, vdupq_n_u8((uint8_t) (26 - 'a'))));
+    shift = vorrq_u8(shift, vandq_u8(digits, vdupq_n_u8((uint8_t) (52 - '0'))));
+    shift = vorrq_u8(shift, vandq_u8(plus, vdupq_n_u8((uint8_t) (62 - '+'))));
+    shift = vorrq_u8(shift, vandq_u8(slash, vdupq_n_u8((uint8_t) (63 - '/'))));
+
+    uint8x16_t characters = vorrq_u8(vorrq_u8(upper, lower), vorrq_u8(plus, slash));
+    *valid = vandq_u8(*valid, vorrq_u8(characters, digits));
+
+    return vaddq_u8(chunk, shift);
+}
+
+/*
+ * Decode base64 characters sixty-four at a time into forty-eight bytes,
+ * loads split the characters of groups into four vectors and stores
+ * interleave the bytes back. Returns the number of decoded characters,
+ * the block with an invalid character is left to the scalar kernel.
+ */
+static size_t base64_decode_vector(const unsigned char *text, size_t size, uint8_t *out)
+{
+    size_t i = 0;
+
+    for (; i + 4 * sizeof(uint8x16_t) <= size; i += 4 * sizeof(uint8x16_t), out += 48) {
+        uint8x16x4_t chunks = vld4q_u8(text + i);
+        uint8x16_t valid = vdupq_n_u8(0xFF);
+
+        uint8x16_t a = base64_values_neon(chunks.val[0], &valid);
+        uint8x16_t b = base64_values_neon(chunks.val[1], &valid);
+        uint8x16_t c = base64_values_neon(chunks.val[2], &valid);
+        uint8x16_t d = base64_values_neon(chunks.val[3], &valid);
+
+        if (vminvq_u8(valid) == 0)
+            break;
+
+        uint8x16x3_t bytes;
+        bytes.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+        bytes.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+        bytes.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+
+        vst3q_u8(out, bytes);
+    }
+
+    return i;
+}
+#endif
+
+static int hex_digit(unsigned char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+
+    c |= 0x20;
+
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+
+    return -1;
+}
+
+/*
+ * Decode hex digits sixteen at a time with vector kernels, then eight at
+ * a time with SWAR: every byte of the word is checked and turned into its
+ * digit value, then pairs of digits are packed into bytes. Returns the number
+ * of decoded digits, less than size at the invalid digit.
+ */
+static size_t hex_decode(const unsigned char *text, size_t size, uint8_t *out)
+{
+    size_t i = 0;
+
+#if defined(C_FLAGS_SSE2) || defined(C_FLAGS_NEON)
+    i = hex_decode_vector(text, size, out);
+#endif
+
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word = binary_load_word(text + i);
+        uint64_t digits = binary_between(word, '0' - 1, '9' + 1);
+        uint64_t letters = binary_between(word | (C_FLAGS_BINARY_ONES * 0x20), 'a' - 1, 'f' + 1);
+
+        if ((word & C_FLAGS_BINARY_HIGHS) != 0 || (digits | letters) != C_FLAGS_BINARY_HIGHS)
+            break;
+
+        uint64_t nibbles = (word & (C_FLAGS_BINARY_ONES * 0x0F)) + (letters >> 7) * 9;
+        uint64_t pairs = ((nibbles & 0x00FF00FF00FF00FFULL) << 4) |
+                         ((nibbles >> 8) & 0x00FF00FF00FF00FFULL);
+
+        pairs = (pairs | (pairs >> 8)) & 0x0000FFFF0000FFFFULL;
+        pairs = pairs | (pairs >> 16);
+
+        for (size_t j = 0; j < sizeof(uint32_t); j++)
+            out[i / 2 + j] = (uint8_t) (pairs >> (j * 8));
+    }
+
+    for (; i < size; i += 2) {
+        int high = hex_digit(text[i]);
+        int low = hex_digit(text[i + 1]);
+
+        if (high < 0)
+            return i;
+        if (low < 0)
+            return i + 1;
+
+        out[i / 2] = (uint8_t) (high << 4 | low);
+    }
+
+    return size;
+}
+
+/*
+ * Decode groups of four base64 characters into three bytes, vector kernels
+ * decode the first groups. Invalid characters of the rest are collected into
+ * one mask checked after the loop, so valid values are decoded without
+ * branches. Returns the number of decoded characters, less than size at
+ * the invalid character.
+ */
+static size_t base64_decode(const unsigned char *text, size_t size, uint8_t *out)
+{
+    unsigned invalid = 0;
+    size_t i = 0;
+
+#if defined(C_FLAGS_SSE2) || defined(C_FLAGS_NEON)
+    i = base64_decode_vector(text, size, out);
+#endif
+
+    for (out += i / 4 * 3; i < size; i += 4, out += 3) {
+        uint32_t a = base64_values[text[i]];
+        uint32_t b = base64_values[text[i + 1]];
+        uint32_t c = base64_values[text[i + 2]];
+        uint32_t d = base64_values[text[i + 3]];
+
+        invalid |= a | b | c | d;
+
+        uint32_t bits = a << 18 | b << 12 | c << 6 | d;
+
+        out[0] = (uint8_t) (bits >> 16);
+        out[1] = (uint8_t) (bits >> 8);
+        out[2] = (uint8_t) bits;
+    }
+
+    if ((invalid & 0x80) == 0)
+        return size;
+
+    i = 0;
+    while (i < size && base64_values[text[i]] != C_FLAGS_BINARY_INVALID)
+        i++;
+
+    return i;
+}
+
+// decode the last group of base64 value with one or two '=' of padding
+static size_t base64_decode_padded(const unsigned char *text, size_t padding, uint8_t *out)
+{
+    uint32_t a = base64_values[text[0]];
+    uint32_t b = base64_values[text[1]];
+    uint32_t c = padding == 1 ? base64_values[text[2]] : 0;
+
+    if (a == C_FLAGS_BINARY_INVALID)
+        return 0;
+    if (b == C_FLAGS_BINARY_INVALID)
+        return 1;
+    if (c == C_FLAGS_BINARY_INVALID)
+        return 2;
+
+    // bits that don't form a whole byte must be zero, so every value has one encoding
+    if (padding == 2 && (b & 0x0F) != 0)
+        return 1;
+    if (padding == 1 && (c & 0x03) != 0)
+        return 2;
+
+    uint32_t bits = a << 18 | b << 12 | c << 6;
+
+    out[0] = (uint8_t) (bits >> 16);
+    if (padding == 1)
+        out[1] = (uint8_t) (bits >> 8);
+
+    return 4;
+}
+
+static bool binary_allocate(size_t size, uint8_t **values_ptr, CFlagsBinaryError *error)
+{
+    void *values = NULL;
+
+    if (!c_flags_list_allocate(C_FLAG_BINARY, size, &values)) {
+        error->reason = "out of memory";
+        error->offset = SIZE_MAX;
+        return false;
+    }
+
+    *values_ptr = values;
+    return true;
+}
+
+static bool binary_parse_hex(const char *text, const void **values_ptr, CFlagsBinaryError *error)
+{
+    size_t size = strlen(text);
+    uint8_t *values = NULL;
+
+    if (size % 2 != 0) {
+        error->reason = "odd number of hex digits";
+        error->offset = SIZE_MAX;
+        return false;
+    }
+
+    if (!binary_allocate(size / 2, &values, error))
+        return false;
+
+    size_t decoded = hex_decode((const unsigned char *) text, size, values);
+
+    if (decoded != size) {
+        free(c_flags_list_allocation(values));
+
+        error->reason = "invalid hex digit";
+        error->offset = decoded;
+        return false;
+    }
+
+    *values_ptr = values;
+    return true;
+}
+
+/*
+ * Values use the standard alphabet with padding, characters after
+ * the padding and non-zero bits of the last incomplete byte are invalid.
+ */
+static bool binary_parse_base64(const char *text, const void **values_ptr, CFlagsBinaryError *error)
+{
+    size_t size = strlen(text);
+    uint8_t *values = NULL;
+
+    if (size % 4 != 0) {
+        error->reason = "base64 length is not a multiple of 4";
+        error->offset = SIZE_MAX;
+        return false;
+    }
+
+    size_t padding = text[size - 1] != '=' ? 0 : text[size - 2] != '=' ? 1 : 2;
+    size_t groups_size = padding > 0 ? size - 4 : size;
+
+    if (!binary_allocate(size / 4 * 3 - padding, &values, error))
+        return false;
+
+    const unsigned char *bytes = (const unsigned char *) text;
+    size_t decoded = base64_decode(bytes, groups_size, values);
+
+    if (decoded == groups_size && padding > 0)
+        decoded += base64_decode_padded(bytes + groups_size, padding, values + groups_size / 4 * 3);
+
+    if (decoded != size) {
+        free(c_flags_list_allocation(values));
+
+        error->reason = "invalid base64 character";
+        error->offset = decoded;
+        return false;
+    }
+
+    *values_ptr = values;
+    return true;
+}
+
+static bool binary_parse(const char *value, const void **values_ptr, CFlagsBinaryError *error)
+{
+    size_t prefix_size = 0;
+    bool decoded = false;
+
+    if (!strncmp(value, hex_prefix, sizeof(hex_prefix) - 1))
+        prefix_size = sizeof(hex_prefix) - 1;
+    else if (!strncmp(value, base64_prefix, sizeof(base64_prefix) - 1))
+        prefix_size = sizeof(base64_prefix) - 1;
+
+    // the empty value is accepted without the prefix, as it's formatted
+    if (value[prefix_size] == '\0' && (prefix_size > 0 || value[0] == '\0')) {
+        *values_ptr = NULL;
+        return true;
+    }
+
+    if (prefix_size == 0) {
+        error->reason = "expected hex: or base64: prefix";
+        error->offset = SIZE_MAX;
+        return false;
+    }
+
+    if (prefix_size == sizeof(hex_prefix) - 1)
+        decoded = binary_parse_hex(value + prefix_size, values_ptr, error);
+    else
+        decoded = binary_parse_base64(value + prefix_size, values_ptr, error);
+
+    if (!decoded && error->offset != SIZE_MAX)
+        error->offset += prefix_size;
+
+    return decoded;
+}
+
+bool c_flags_parse_binary(const char *value, const void **values_ptr)
+{
+    CFlagsBinaryError error;
+    return binary_parse(value, values_ptr, &error);
+}
+
+const char *c_flags_describe_binary(const char *value, char *buffer, size_t size)
+{
+    CFlagsBinaryError error = {.reason = "out of memory", .offset = SIZE_MAX};
+    const void *values = NULL;
+
+    if (binary_parse(value, &values, &error))
+        free(c_flags_list_allocation(values));
+
+    // values may be long, only the beginning is shown
+    int shown = C_FLAGS_BINARY_DESCRIBED;
+    const char *ellipsis = strlen(value) > C_FLAGS_BINARY_DESCRIBED ? "..." : "";
+
+    if (error.offset == SIZE_MAX)
+        snprintf(buffer, size, "%.*s%s (%s)", shown, value, ellipsis, error.reason);
+    else
+        snprintf(buffer,
+                 size,
+                 "%.*s%s (%s at offset %zu)",
+                 shown,
+                 value,
+                 ellipsis,
+                 error.reason,
+                 error.offset);
+
+    return buffer;
+}
+
+static void binary_put(char *buffer, size_t size, size_t offset, char c)
+{
+    if (offset < size)
+        buffer[offset] = c;
+}
+
+size_t c_flags_format_binary(const void *values, char *buffer, size_t size)
+{
+    size_t count = c_flags_list_size(values);
+    const uint8_t *bytes = values;
+
+    if (count == 0) {
+        if (size > 0)
+            buffer[0] = '\0';
+
+        return 0;
+    }
+
+    size_t offset = sizeof(base64_prefix) - 1;
+    size_t length = offset + (count + 2) / 3 * 4;
+
+    for (size_t i = 0; i < offset; i++)
+        binary_put(buffer, size, i, base64_prefix[i]);
+
+    for (size_t i = 0; i < count && offset < size; i += 3, offset += 4) {
+        uint32_t bits = (uint32_t) bytes[i] << 16;
+
+        if (i + 1 < count)
+            bits |= (uint32_t) bytes[i + 1] << 8;
+        if (i + 2 < count)
+            bits |= bytes[i + 2];
+
+        binary_put(buffer, size, offset, base64_alphabet[bits >> 18]);
+        binary_put(buffer, size, offset + 1, base64_alphabet[(bits >> 12) & 0x3F]);
+        char third = i + 1 < count ? base64_alphabet[(bits >> 6) & 0x3F] : '=';
+        char fourth = i + 2 < count ? base64_alphabet[bits & 0x3F] : '=';
+
+        binary_put(buffer, size, offset + 2, third);
+        binary_put(buffer, size, offset + 3, fourth);
+    }
+
+    if (size > 0)
+        buffer[length < size ? length : size - 1] = '\0';
+
+    return length;
+}
+
+static CFlag *binary_declare(const char *long_name,
+                             const char *short_name,
+                             const char *desc,
+                             const char *default_val,
+                             void *var)
+{
+    const void *values = NULL;
+    CFlagsBinaryError error = {.reason = NULL, .offset = 0};
+
+    if (default_val != NULL && !binary_parse(default_val, &values, &error)) {
+        assert(!strcmp(error.reason, "out of memory") && "the default value must be valid");
+        return NULL;
+    }
+
+    CFlag *flag = c_flags_declare(C_FLAG_BINARY, long_name, short_name, desc, var);
+    flag->default_value.as_list = values;
+
+    c_flag_set_value(flag, flag->default_value);
+    return flag;
+}
+
+const uint8_t **c_flag_binary(const char *long_name,
+                              const char *short_name,
+                              const char *desc,
+                              const char *default_val)
+{
+    CFlag *flag = binary_declare(long_name, short_name, desc, default_val, NULL);
+    if (flag == NULL)
+        return NULL;
+
+    return (const uint8_t **) flag->value;
+}
+
+bool c_flag_binary_var(const uint8_t **var,
+                       const char *long_name,
+                       const char *short_name,
+                       const char *desc,
+                       const char *default_val)
+{
+    assert(var != NULL && "the variable is required and cannot be NULL");
+
+    return binary_declare(long_name, short_name, desc, default_val, (void *) var) != NULL;
+}
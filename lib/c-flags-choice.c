@@ -0,0 +1,371 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+
+#define C_FLAGS_CHOICE_MAX_DISPLACEMENT 65535U
+
+static uint32_t choice_hash(StringView name, uint32_t seed)
+{
+    // FNV-1a with the seed mixed into the offset basis
+    uint32_t hash = 2166136261U ^ (seed * 0x9E3779B9U);
+
+    for (size_t i = 0; i < name.size; i++)
+        hash = (hash ^ (unsigned char) name.data[i]) * 16777619U;
+
+    return hash ^ (hash >> 16);
+}
+
+/*
+ * Build the perfect hash with hash and displace: names are grouped into
+ * buckets by the first hash, then buckets from the largest are given
+ * displacements that place all their names into free slots.
+ */
+static bool choices_build(CFlagChoices *choices)
+{
+    size_t count = choices->count;
+    size_t buckets_size = choices->buckets_size;
+    size_t slots_size = choices->slots_size;
+
+    size_t *bucket_sizes = calloc(buckets_size, sizeof(size_t));
+    size_t *bucket_order = malloc(buckets_size * sizeof(size_t));
+    size_t *bucket_slots = malloc(count * sizeof(size_t));
+
+    if (bucket_sizes == NULL || bucket_order == NULL || bucket_slots == NULL) {
+        free(bucket_sizes);
+        free(bucket_order);
+        free(bucket_slots);
+        return false;
+    }
+
+    size_t max_bucket_size = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        size_t bucket = choice_hash(sv_from_string(choices->names[i]), 0) % buckets_size;
+
+        bucket_sizes[bucket] += 1;
+        if (bucket_sizes[bucket] > max_bucket_size)
+            max_bucket_size = bucket_sizes[bucket];
+    }
+
+    // non-empty buckets from the largest to the smallest
+    size_t order_size = 0;
+
+    for (size_t size = max_bucket_size; size > 0; size--) {
+        for (size_t i = 0; i < buckets_size; i++) {
+            if (bucket_sizes[i] == size)
+                bucket_order[order_size++] = i;
+        }
+    }
+
+    memset(choices->slots, 0, slots_size);
+
+    bool built = true;
+
+    for (size_t i = 0; i < order_size; i++) {
+        size_t bucket = bucket_order[i];
+        uint32_t displacement = 1;
+
+        for (; displacement <= C_FLAGS_CHOICE_MAX_DISPLACEMENT; displacement++) {
+            size_t placed = 0;
+
+            for (size_t j = 0; j < count; j++) {
+                StringView name = sv_from_string(choices->names[j]);
+
+                if (choice_hash(name, 0) % buckets_size != bucket)
+                    continue;
+
+                size_t slot = choice_hash(name, displacement) & (slots_size - 1);
+
+                bool taken = choices->slots[slot] != 0;
+                for (size_t k = 0; k < placed && !taken; k++)
+                    taken = bucket_slots[k] == slot;
+
+                if (taken)
+                    break;
+
+                bucket_slots[placed++] = slot;
+                choices->slots[slot] = (uint8_t) (j + 1);
+            }
+
+            if (placed == bucket_sizes[bucket])
+                break;
+
+            // release slots of the failed attempt
+            for (size_t k = 0; k < placed; k++)
+                choices->slots[bucket_slots[k]] = 0;
+        }
+
+        if (displacement > C_FLAGS_CHOICE_MAX_DISPLACEMENT) {
+            built = false;
+            break;
+        }
+
+        choices->displacements[bucket] = (uint16_t) displacement;
+    }
+
+    free(bucket_sizes);
+    free(bucket_order);
+    free(bucket_slots);
+
+    return built;
+}
+
+static CFlagChoices *choices_create(const char *const *names, size_t count)
+{
+    assert(names != NULL && count > 0 && "the names are required and cannot be empty");
+    assert(count <= UINT8_MAX && "the number of names must not exceed 255");
+
+    for (size_t i = 0; i < count; i++) {
+        assert(names[i] != NULL && names[i][0] != '\0' && "the names cannot be NULL or empty");
+        assert(strchr(names[i], ',') == NULL && "the names cannot contain commas");
+
+        for (size_t j = 0; j < i; j++)
+            assert(strcmp(names[i], names[j]) && "the names must be unique");
+    }
+
+    size_t slots_size = 2;
+    while (slots_size < count * 2)
+        slots_size *= 2;
+
+    // the table grows until a displacement is found for every bucket
+    for (; slots_size <= 4096; slots_size *= 2) {
+        size_t buckets_size = (count + 1) / 2;
+        CFlagChoices *choices = malloc(sizeof(CFlagChoices) + slots_size +
+                                       buckets_size * sizeof(uint16_t));
+        if (choices == NULL)
+            return NULL;
+
+        choices->names = names;
+        choices->count = count;
+        choices->buckets_size = buckets_size;
+        choices->slots_size = slots_size;
+        choices->displacements = (uint16_t *) (choices + 1);
+        choices->slots = (uint8_t *) (choices->displacements + buckets_size);
+
+        if (choices_build(choices))
+            return choices;
+
+        free(choices);
+    }
+
+    return NULL;
+}
+
+bool c_flags_choices_find(const CFlagChoices *choices, StringView name, size_t *index_ptr)
+{
+    uint32_t displacement = choices->displacements[choice_hash(name, 0) % choices->buckets_size];
+    uint8_t slot = choices->slots[choice_hash(name, displacement) & (choices->slots_size - 1)];
+
+    if (slot == 0)
+        return false;
+
+    const char *candidate = choices->names[slot - 1];
+    if (strlen(candidate) != name.size || memcmp(candidate, name.data, name.size))
+        return false;
+
+    *index_ptr = slot - 1U;
+    return true;
+}
+
+bool c_flags_parse_choice(const CFlagChoices *choices, const char *value, int *index_ptr)
+{
+    size_t index = 0;
+
+    if (!c_flags_choices_find(choices, sv_from_string(value), &index))
+        return false;
+
+    *index_ptr = (int) index;
+    return true;
+}
+
+bool c_flags_parse_set(const CFlagChoices *choices, const char *value, uint64_t *mask_ptr)
+{
+    StringView sv_value = sv_from_string(value);
+    uint64_t mask = 0;
+
+    // the empty value is the empty set, otherwise names cannot be empty
+    while (sv_value.size > 0) {
+        int comma = sv_index_of(sv_value, sv_from_string(","));
+        size_t size = comma < 0 ? sv_value.size : (size_t) comma;
+        size_t index = 0;
+
+        if (!c_flags_choices_find(choices, sv_slice_left(sv_value, size), &index))
+            return false;
+
+        mask |= (uint64_t) 1 << index;
+
+        if (comma >= 0 && size + 1 == sv_value.size)
+            return false;
+
+        sv_value = sv_chop_left(sv_value, comma < 0 ? size : size + 1);
+    }
+
+    *mask_ptr = mask;
+    return true;
+}
+
+const char *c_flags_format_choice(const CFlagChoices *choices,
+                                  int index,
+                                  char *buffer,
+                                  size_t size)
+{
+    if (index >= 0 && (size_t) index < choices->count)
+        return choices->names[index];
+
+    snprintf(buffer, size, "%d", index);
+    return buffer;
+}
+
+const char *c_flags_format_set(const CFlagChoices *choices,
+                               uint64_t mask,
+                               char *buffer,
+                               size_t size)
+{
+    size_t offset = 0;
+
+    buffer[0] = '\0';
+
+    for (size_t i = 0; i < choices->count && offset < size; i++) {
+        if (!(mask & ((uint64_t) 1 << i)))
+            continue;
+
+        offset += (size_t) snprintf(buffer + offset,
+                                    size - offset,
+                                    offset > 0 ? ",%s" : "%s",
+                                    choices->names[i]);
+    }
+
+    return buffer;
+}
+
+const char *c_flags_format_choices(const CFlag *flag,
+                                   const char *separator,
+                                   char *buffer,
+                                   size_t size)
+{
+    if (flag->choices == NULL)
+        return NULL;
+
+    size_t offset = 0;
+
+    buffer[0] = '\0';
+
+    for (size_t i = 0; i < flag->choices->count && offset < size; i++) {
+        offset += (size_t) snprintf(buffer + offset,
+                                    size - offset,
+                                    "%s%s",
+                                    i > 0 ? separator : "",
+                                    flag->choices->names[i]);
+    }
+
+    return buffer;
+}
+
+static CFlag *choice_declare(CFlagType type,
+                             const char *long_name,
+                             const char *short_name,
+                             const char *desc,
+                             const char *const *names,
+                             size_t count,
+                             void *var)
+{
+    CFlagChoices *choices = choices_create(names, count);
+    if (choices == NULL)
+        return NULL;
+
+    CFlag *flag = c_flags_declare(type, long_name, short_name, desc, var);
+    flag->choices = choices;
+
+    return flag;
+}
+
+int *c_flag_choice(const char *long_name,
+                   const char *short_name,
+                   const char *desc,
+                   const char *const *choices,
+                   size_t count,
+                   int default_val)
+{
+    assert(default_val >= 0 && (size_t) default_val < count &&
+           "the default value must be an index of the choices");
+
+    CFlag *flag = choice_declare(C_FLAG_CHOICE, long_name, short_name, desc, choices, count, NULL);
+    if (flag == NULL)
+        return NULL;
+
+    flag->default_value.as_choice = default_val;
+    *((int *) flag->value) = default_val;
+
+    return (int *) flag->value;
+}
+
+bool c_flag_choice_var(int *var,
+                       const char *long_name,
+                       const char *short_name,
+                       const char *desc,
+                       const char *const *choices,
+                       size_t count,
+                       int default_val)
+{
+    assert(var != NULL && "the variable is required and cannot be NULL");
+    assert(default_val >= 0 && (size_t) default_val < count &&
+           "the default value must be an index of the choices");
+
+    CFlag *flag = choice_declare(C_FLAG_CHOICE, long_name, short_name, desc, choices, count, var);
+    if (flag == NULL)
+        return false;
+
+    flag->default_value.as_choice = default_val;
+    *var = default_val;
+
+    return true;
+}
+
+uint64_t *c_flag_set(const char *long_name,
+                     const char *short_name,
+                     const char *desc,
+                     const char *const *names,
+                     size_t count,
+                     uint64_t default_val)
+{
+    assert(count <= 64 && "the number of set names must not exceed 64");
+
+    CFlag *flag = choice_declare(C_FLAG_SET, long_name, short_name, desc, names, count, NULL);
+    if (flag == NULL)
+        return NULL;
+
+    flag->default_value.as_set = default_val;
+    *((uint64_t *) flag->value) = default_val;
+
+    return (uint64_t *) flag->value;
+}
+
+bool c_flag_set_var(uint64_t *var,
+                    const char *long_name,
+                    const char *short_name,
+                    const char *desc,
+                    const char *const *names,
+                    size_t count,
+                    uint64_t default_val)
+{
+    assert(var != NULL && "the variable is required and cannot be NULL");
+    assert(count <= 64 && "the number of set names must not exceed 64");
+
+    CFlag *flag = choice_declare(C_FLAG_SET, long_name, short_name, desc, names, count, var);
+    if (flag == NULL)
+        return false;
+
+    flag->default_value.as_set = default_val;
+    *var = default_val;
+
+    return true;
+}
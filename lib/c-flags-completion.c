@@ -0,0 +1,301 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <assert.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+
+static char **completion_shell = NULL;
+
+static int compare_flags_by_long_name(const void *a, const void *b)
+{
+    const CFlag *flag_a = *((const CFlag *const *) a);
+    const CFlag *flag_b = *((const CFlag *const *) b);
+
+    return strcmp(flag_a->long_name, flag_b->long_name);
+}
+
+// values of strings and files are completed with file names
+static bool completes_files(const CFlag *flag)
+{
+    return flag->type == C_FLAG_STRING || flag->type == C_FLAG_STRINGS ||
+           (c_flags_is_file(flag->type) && flag->type != C_FLAG_DIRECTORY);
+}
+
+// visible flags sorted by long name
+static size_t completion_flags(const CFlag **sorted)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < c_flags_count(); i++) {
+        const CFlag *flag = c_flags_at(i);
+
+        if (!flag->hidden)
+            sorted[count++] = flag;
+    }
+
+    qsort(sorted, count, sizeof(const CFlag *), compare_flags_by_long_name);
+    return count;
+}
+
+static const char *program_name(const char *program)
+{
+    const char *name = program;
+
+    for (const char *c = program; *c != '\0'; c++) {
+        if (*c == '/' || *c == '\\')
+            name = c + 1;
+    }
+
+    return name;
+}
+
+// write text inside of single quotes of shell string
+static void write_quoted(FILE *file, const char *text, const char *escaped)
+{
+    for (; *text != '\0'; text++) {
+        if (*text == '\'')
+            fputs("'\\''", file);
+        else if (*text == '\n')
+            fputc(' ', file);
+        else if (escaped != NULL && strchr(escaped, *text) != NULL)
+            fprintf(file, "\\%c", *text);
+        else
+            fputc(*text, file);
+    }
+}
+
+// space-separated allowed values of choice and set flags
+static void write_choices(FILE *file, const CFlag *flag, const char *escaped)
+{
+    for (size_t i = 0; i < flag->choices->count; i++) {
+        if (i > 0)
+            fputc(' ', file);
+
+        write_quoted(file, flag->choices->names[i], escaped);
+    }
+}
+
+static void write_bash(FILE *file, const char *name, const CFlag **flags, size_t count)
+{
+    fputs("# bash completion generated by c-flags\n", file);
+
+    fputs("_c_flags_", file);
+    for (const char *c = name; *c != '\0'; c++)
+        fputc(isalnum((unsigned char) *c) ? *c : '_', file);
+
+    fputs("()\n{\n", file);
+    fputs("    local cur=\"${COMP_WORDS[COMP_CWORD]}\"\n", file);
+    fputs("    local prev=\"${COMP_WORDS[COMP_CWORD-1]}\"\n\n", file);
+
+    fputs("    case \"$prev\" in\n", file);
+
+    for (size_t i = 0; i < count; i++) {
+        const CFlag *flag = flags[i];
+
+        if (!c_flag_takes_value(flag))
+            continue;
+
+        fputs("    '--", file);
+        write_quoted(file, flag->long_name, NULL);
+        fputs("'", file);
+
+        if (flag->short_name != NULL) {
+            fputs("|'-", file);
+            write_quoted(file, flag->short_name, NULL);
+            fputs("'", file);
+        }
+
+        if (flag->choices != NULL) {
+            fputs(")\n        COMPREPLY=($(compgen -W '", file);
+            write_choices(file, flag, NULL);
+            fputs("' -- \"$cur\"))\n        return ;;\n", file);
+        }
+        else if (flag->type == C_FLAG_DIRECTORY) {
+            fputs(")\n        COMPREPLY=($(compgen -d -- \"$cur\"))\n        return ;;\n", file);
+        }
+        else if (completes_files(flag)) {
+            fputs(")\n        COMPREPLY=($(compgen -f -- \"$cur\"))\n        return ;;\n", file);
+        }
+        else {
+            fputs(")\n        COMPREPLY=()\n        return ;;\n", file);
+        }
+    }
+
+    fputs("    esac\n\n", file);
+
+    fputs("    if [[ \"$cur\" == -* ]]; then\n", file);
+    fputs("        COMPREPLY=($(compgen -W '", file);
+
+    for (size_t i = 0; i < count; i++) {
+        fputs(i > 0 ? " --" : "--", file);
+        write_quoted(file, flags[i]->long_name, NULL);
+
+        if (flags[i]->short_name != NULL) {
+            fputs(" -", file);
+            write_quoted(file, flags[i]->short_name, NULL);
+        }
+    }
+
+    fputs("' -- \"$cur\"))\n", file);
+    fputs("    else\n", file);
+    fputs("        COMPREPLY=($(compgen -f -- \"$cur\"))\n", file);
+    fputs("    fi\n", file);
+    fputs("}\n\n", file);
+
+    fputs("complete -F _c_flags_", file);
+    for (const char *c = name; *c != '\0'; c++)
+        fputc(isalnum((unsigned char) *c) ? *c : '_', file);
+
+    fprintf(file, " '");
+    write_quoted(file, name, NULL);
+    fputs("'\n", file);
+}
+
+static void write_zsh(FILE *file, const char *name, const CFlag **flags, size_t count)
+{
+    fputs("#compdef ", file);
+    write_quoted(file, name, NULL);
+    fputs("\n# zsh completion generated by c-flags\n\n", file);
+
+    fputs("_arguments -s \\\n", file);
+
+    for (size_t i = 0; i < count; i++) {
+        const CFlag *flag = flags[i];
+
+        fputs("    '", file);
+
+        if (flag->short_name != NULL) {
+            fputs("(--", file);
+            write_quoted(file, flag->long_name, "[]:\\");
+            fputs(" -", file);
+            write_quoted(file, flag->short_name, "[]:\\");
+            fputs(")'{--", file);
+            write_quoted(file, flag->long_name, "[]:\\");
+            fputs(",-", file);
+            write_quoted(file, flag->short_name, "[]:\\");
+            fputs("}'", file);
+        }
+        else {
+            fputs("--", file);
+            write_quoted(file, flag->long_name, "[]:\\");
+        }
+
+        fputs("[", file);
+        write_quoted(file, flag->desc != NULL ? flag->desc : "", "[]:\\");
+        fputs("]", file);
+
+        if (flag->choices != NULL) {
+            fprintf(file, ":%s:(", c_flag_type_name(flag->type));
+            write_choices(file, flag, "[]:()\\");
+            fputs(")", file);
+        }
+        else if (flag->type == C_FLAG_DIRECTORY) {
+            fputs(":directory:_files -/", file);
+        }
+        else if (completes_files(flag)) {
+            fputs(c_flags_is_file(flag->type) ? ":file:_files" : ":string:_files", file);
+        }
+        else if (c_flag_takes_value(flag)) {
+            fprintf(file, ":%s: ", c_flag_type_name(flag->type));
+        }
+
+        fputs("' \\\n", file);
+    }
+
+    fputs("    '*:file:_files'\n", file);
+}
+
+static void write_fish(FILE *file, const char *name, const CFlag **flags, size_t count)
+{
+    fputs("# fish completion generated by c-flags\n", file);
+
+    for (size_t i = 0; i < count; i++) {
+        const CFlag *flag = flags[i];
+
+        fputs("complete -c '", file);
+        write_quoted(file, name, NULL);
+        fputs("' -l '", file);
+        write_quoted(file, flag->long_name, NULL);
+        fputs("'", file);
+
+        if (flag->short_name != NULL) {
+            fputs(" -o '", file);
+            write_quoted(file, flag->short_name, NULL);
+            fputs("'", file);
+        }
+
+        if (flag->choices != NULL) {
+            fputs(" -x -a '", file);
+            write_choices(file, flag, NULL);
+            fputs("'", file);
+        }
+        else if (flag->type == C_FLAG_DIRECTORY) {
+            fputs(" -x -a '(__fish_complete_directories)'", file);
+        }
+        else if (completes_files(flag)) {
+            fputs(" -r -F", file);
+        }
+        else if (c_flag_takes_value(flag)) {
+            fputs(" -x", file);
+        }
+
+        if (flag->desc != NULL) {
+            fputs(" -d '", file);
+            write_quoted(file, flag->desc, NULL);
+            fputs("'", file);
+        }
+
+        fputs("\n", file);
+    }
+}
+
+bool c_flags_completion_to_file(const char *shell, const char *program, FILE *file)
+{
+    static const CFlag *flags[C_FLAGS_CAPACITY];
+
+    assert(shell != NULL && "the shell is required and cannot be NULL");
+    assert(program != NULL && "the program is required and cannot be NULL");
+
+    const char *name = program_name(program);
+    size_t count = completion_flags(flags);
+
+    if (!strcmp(shell, "bash"))
+        write_bash(file, name, flags, count);
+    else if (!strcmp(shell, "zsh"))
+        write_zsh(file, name, flags, count);
+    else if (!strcmp(shell, "fish"))
+        write_fish(file, name, flags, count);
+    else
+        return false;
+
+    return true;
+}
+
+void c_flags_add_completion_flag(void)
+{
+    assert(completion_shell == NULL && "the completion flag is already added");
+
+    completion_shell = c_flag_string("completion", NULL, NULL, NULL);
+    c_flags_find_by_data(completion_shell)->hidden = true;
+}
+
+void c_flags_completion_dispatch(const char *program)
+{
+    if (completion_shell == NULL || *completion_shell == NULL)
+        return;
+
+    if (!c_flags_completion_to_file(*completion_shell, program, stdout)) {
+        printf("ERROR: unsupported shell %s for completion\n", *completion_shell);
+        exit(1);
+    }
+
+    exit(0);
+}
@@ -0,0 +1,232 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+#include "string-view.h"
+
+static char *read_file(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+        return NULL;
+
+    size_t size = 0;
+    size_t capacity = 4096;
+    char *content = malloc(capacity);
+
+    while (content != NULL) {
+        size += fread(content + size, 1, capacity - size - 1, file);
+
+        if (size + 1 < capacity)
+            break;
+
+        char *grown = realloc(content, capacity * 2);
+        if (grown == NULL) {
+            free(content);
+            content = NULL;
+            break;
+        }
+
+        content = grown;
+        capacity *= 2;
+    }
+
+    if (content != NULL && ferror(file)) {
+        free(content);
+        content = NULL;
+    }
+
+    if (content != NULL)
+        content[size] = '\0';
+
+    fclose(file);
+    return content;
+}
+
+static StringView sv_trim(StringView sv)
+{
+    while (sv.size > 0 && isspace((unsigned char) sv.data[0])) {
+        sv.data += 1;
+        sv.size -= 1;
+    }
+
+    while (sv.size > 0 && isspace((unsigned char) sv.data[sv.size - 1]))
+        sv.size -= 1;
+
+    return sv;
+}
+
+static void release_assignments(CFlagAssignment *assignments, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        free(assignments[i].owned);
+
+    free(assignments);
+}
+
+/*
+ * Keep only the last assignment of every flag, in the order of the kept ones,
+ * so a flag assigned several times is changed once to its final value.
+ */
+static size_t drop_overridden(CFlagAssignment *assignments, size_t count)
+{
+    bool assigned[C_FLAGS_CAPACITY] = {false};
+    const CFlag *first = c_flags_at(0);
+    size_t kept = count;
+
+    for (size_t i = count; i-- > 0;) {
+        size_t index = (size_t) (assignments[i].flag - first);
+
+        if (assigned[index]) {
+            free(assignments[i].owned);
+            continue;
+        }
+
+        assigned[index] = true;
+        assignments[--kept] = assignments[i];
+    }
+
+    memmove(assignments, assignments + kept, (count - kept) * sizeof(CFlagAssignment));
+    return count - kept;
+}
+
+int c_flags_load_config(const char *path)
+{
+    if (c_flags_is_frozen()) {
+        printf("ERROR: flags are frozen, config %s is not loaded\n", path);
+        return -1;
+    }
+
+    char *content = read_file(path);
+    if (content == NULL) {
+        printf("ERROR: failed to read config %s\n", path);
+        return -1;
+    }
+
+    CFlagAssignment *assignments = NULL;
+    size_t assignments_size = 0;
+    size_t assignments_capacity = 0;
+
+    c_flags_files_begin();
+
+    size_t line_number = 0;
+    char *line = content;
+
+    while (line != NULL) {
+        char *line_end = strchr(line, '\n');
+        if (line_end != NULL)
+            *line_end = '\0';
+
+        line_number += 1;
+
+        StringView sv_line = sv_trim(sv_from_string(line));
+        line = (line_end != NULL) ? line_end + 1 : NULL;
+
+        // empty lines and `# comment`
+        if (sv_line.size == 0 || sv_line.data[0] == '#')
+            continue;
+
+        // `name = value` or `--name = value`
+        int index_of_eq = sv_index_of(sv_line, sv_from_string("="));
+        if (index_of_eq < 0) {
+            printf("ERROR: expected <flag> = <value> in %s:%zu\n", path, line_number);
+            goto error;
+        }
+
+        StringView sv_long_name = sv_trim(sv_slice_left(sv_line, (size_t) index_of_eq));
+        StringView sv_value = sv_trim(sv_chop_left(sv_line, (size_t) index_of_eq + 1));
+
+        if (sv_starts_with(sv_long_name, sv_from_string("--")))
+            sv_long_name = sv_chop_left(sv_long_name, strlen("--"));
+
+        CFlag *flag = c_flags_find_by_long_name(sv_long_name);
+        if (flag == NULL) {
+            printf("ERROR: unknown flag " SVFMT " in %s:%zu\n",
+                   SVARG(sv_long_name),
+                   path,
+                   line_number);
+            goto error;
+        }
+
+        // values are terminated inside of the owned line
+        char *value = "";
+        if (sv_value.size > 0) {
+            value = (char *) sv_value.data;
+            value[sv_value.size] = '\0';
+        }
+
+        if (assignments_size == assignments_capacity) {
+            size_t capacity = assignments_capacity ? assignments_capacity * 2 : 16;
+            CFlagAssignment *grown = realloc(assignments, capacity * sizeof(CFlagAssignment));
+            if (grown == NULL) {
+                printf("ERROR: out of memory while loading config %s\n", path);
+                goto error;
+            }
+
+            assignments = grown;
+            assignments_capacity = capacity;
+        }
+
+        CFlagAssignment *assignment = &assignments[assignments_size];
+        assignment->flag = flag;
+        assignment->value.raw = 0;
+        assignment->owned = NULL;
+
+        if (flag->type == C_FLAG_STRING) {
+            assignment->owned = malloc(sv_value.size + 1);
+            if (assignment->owned == NULL) {
+                printf("ERROR: out of memory while loading config %s\n", path);
+                goto error;
+            }
+
+            memcpy(assignment->owned, value, sv_value.size + 1);
+            value = assignment->owned;
+        }
+
+        assignments_size += 1;
+
+        if (!c_flag_convert(flag, value, &assignment->value)) {
+            char allowed[C_FLAGS_FORMAT_SIZE];
+            char invalid[C_FLAGS_FORMAT_SIZE];
+
+            printf("ERROR: invalid value %s for %s flag %s in %s:%zu\n",
+                   c_flag_describe_invalid(flag, value, invalid, sizeof(invalid)),
+                   c_flag_type_name(flag->type),
+                   flag->long_name,
+                   path,
+                   line_number);
+
+            if (c_flags_format_choices(flag, ", ", allowed, sizeof(allowed)) != NULL)
+                printf("       allowed values: %s\n", allowed);
+
+            goto error;
+        }
+
+        if (flag->type != C_FLAG_STRING)
+            assignment->owned = c_flag_value_allocation(flag, assignment->value);
+    }
+
+    assignments_size = drop_overridden(assignments, assignments_size);
+    size_t changed = c_flags_apply(assignments, assignments_size, C_FLAG_SOURCE_CONFIG);
+
+    release_assignments(assignments, assignments_size);
+    c_flags_files_end();
+    free(content);
+
+    return (int) changed;
+
+error:
+    release_assignments(assignments, assignments_size);
+    c_flags_files_end();
+    free(content);
+
+    return -1;
+}
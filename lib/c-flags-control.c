@@ -0,0 +1,591 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <ctype.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+#include "string-view.h"
+
+#ifndef C_FLAGS_CONTROL_LINE_MAX
+#define C_FLAGS_CONTROL_LINE_MAX 4096
+#endif
+
+typedef struct CFlagsControlClient CFlagsControlClient;
+
+struct CFlagsControlClient
+{
+    int fd;
+    char in[C_FLAGS_CONTROL_LINE_MAX];
+    size_t in_size;
+    char *out;
+    size_t out_size;
+    size_t out_sent;
+    size_t out_capacity;
+    bool eof;
+    bool broken;
+    bool discarding;
+    CFlagsControlClient *prev;
+    CFlagsControlClient *next;
+};
+
+static int control_epoll_fd = -1;
+static int control_listen_fd = -1;
+static int control_stop_fd = -1;
+static char *control_path = NULL;
+static CFlagsControlClient *control_clients = NULL;
+
+static pthread_t control_thread;
+static bool control_thread_started = false;
+
+// markers of non-client file descriptors in epoll events
+static char control_listen_marker;
+static char control_stop_marker;
+
+static void client_printf(CFlagsControlClient *client, const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    int size = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    if (size < 0 || client->broken)
+        return;
+
+    size_t required = client->out_size + (size_t) size + 1;
+    if (required > client->out_capacity) {
+        size_t capacity = client->out_capacity ? client->out_capacity : 256;
+        while (capacity < required)
+            capacity *= 2;
+
+        char *grown = realloc(client->out, capacity);
+        if (grown == NULL) {
+            client->broken = true;
+            return;
+        }
+
+        client->out = grown;
+        client->out_capacity = capacity;
+    }
+
+    va_start(args, format);
+    vsnprintf(client->out + client->out_size, (size_t) size + 1, format, args);
+    va_end(args);
+
+    client->out_size += (size_t) size;
+}
+
+static StringView sv_next_word(StringView *line)
+{
+    while (line->size > 0 && isspace((unsigned char) line->data[0])) {
+        line->data += 1;
+        line->size -= 1;
+    }
+
+    size_t size = 0;
+    while (size < line->size && !isspace((unsigned char) line->data[size]))
+        size += 1;
+
+    StringView word = {.data = line->data, .size = size};
+
+    line->data += size;
+    line->size -= size;
+
+    return word;
+}
+
+static void control_list(CFlagsControlClient *client)
+{
+    c_flags_lock();
+
+    for (size_t i = 0; i < c_flags_count(); i++) {
+        const CFlag *flag = c_flags_at(i);
+
+        char buffer[C_FLAGS_FORMAT_SIZE];
+        const char *value = c_flag_format(flag, c_flag_get_value(flag), buffer, sizeof(buffer));
+
+        client_printf(client,
+                      "%s %s %s\n",
+                      flag->long_name,
+                      c_flag_source_name(flag->source),
+                      value ? value : "");
+    }
+
+    c_flags_unlock();
+
+    client_printf(client, "OK\n");
+}
+
+static void control_get(CFlagsControlClient *client, StringView args)
+{
+    StringView sv_long_name = sv_next_word(&args);
+
+    CFlag *flag = c_flags_find_by_long_name(sv_long_name);
+    if (flag == NULL) {
+        client_printf(client, "ERR unknown flag " SVFMT "\n", SVARG(sv_long_name));
+        return;
+    }
+
+    c_flags_lock();
+
+    char buffer[C_FLAGS_FORMAT_SIZE];
+    const char *value = c_flag_format(flag, c_flag_get_value(flag), buffer, sizeof(buffer));
+    client_printf(client, "OK %s\n", value ? value : "");
+
+    c_flags_unlock();
+}
+
+static void control_set(CFlagsControlClient *client, StringView args)
+{
+    // every `<flag>=<value>` pair takes at least two characters
+    size_t capacity = args.size / 2 + 1;
+    CFlagAssignment *assignments = calloc(capacity, sizeof(CFlagAssignment));
+    size_t assignments_size = 0;
+
+    if (assignments == NULL) {
+        client_printf(client, "ERR out of memory\n");
+        return;
+    }
+
+    c_flags_files_begin();
+
+    for (;;) {
+        StringView pair = sv_next_word(&args);
+        if (pair.size == 0)
+            break;
+
+        // the line is not terminated, so `sv_index_of()` cannot be used
+        const char *eq = memchr(pair.data, '=', pair.size);
+        if (eq == NULL || eq == pair.data) {
+            client_printf(client, "ERR expected <flag>=<value>, got " SVFMT "\n", SVARG(pair));
+            goto cleanup;
+        }
+
+        size_t index_of_eq = (size_t) (eq - pair.data);
+        StringView sv_long_name = sv_slice_left(pair, index_of_eq);
+        StringView sv_value = sv_chop_left(pair, index_of_eq + 1);
+
+        CFlag *flag = c_flags_find_by_long_name(sv_long_name);
+        if (flag == NULL) {
+            client_printf(client, "ERR unknown flag " SVFMT "\n", SVARG(sv_long_name));
+            goto cleanup;
+        }
+
+        CFlagAssignment *assignment = &assignments[assignments_size++];
+        assignment->flag = flag;
+
+        // value is copied to be terminated, strings keep the copy
+        assignment->owned = malloc(sv_value.size + 1);
+        if (assignment->owned == NULL) {
+            client_printf(client, "ERR out of memory\n");
+            goto cleanup;
+        }
+
+        if (sv_value.size > 0)
+            memcpy(assignment->owned, sv_value.data, sv_value.size);
+        ((char *) assignment->owned)[sv_value.size] = '\0';
+
+        if (!c_flag_convert(flag, assignment->owned, &assignment->value)) {
+            char allowed[C_FLAGS_FORMAT_SIZE];
+            char invalid[C_FLAGS_FORMAT_SIZE];
+            const char *owned = assignment->owned;
+            bool has_allowed = c_flags_format_choices(flag, ", ", allowed, sizeof(allowed)) != NULL;
+
+            client_printf(client,
+                          "ERR invalid value %s for %s flag %s%s%s\n",
+                          c_flag_describe_invalid(flag, owned, invalid, sizeof(invalid)),
+                          c_flag_type_name(flag->type),
+                          flag->long_name,
+                          has_allowed ? ", allowed values: " : "",
+                          has_allowed ? allowed : "");
+            goto cleanup;
+        }
+
+        // lists keep the parsed elements instead of the text
+        if (flag->type != C_FLAG_STRING) {
+            free(assignment->owned);
+            assignment->owned = c_flag_value_allocation(flag, assignment->value);
+        }
+    }
+
+    if (assignments_size == 0) {
+        client_printf(client, "ERR expected <flag>=<value>\n");
+        goto cleanup;
+    }
+
+    if (c_flags_is_frozen()) {
+        client_printf(client, "ERR flags are frozen\n");
+        goto cleanup;
+    }
+
+    size_t changed = c_flags_apply(assignments, assignments_size, C_FLAG_SOURCE_CONTROL);
+    client_printf(client, "OK %zu\n", changed);
+
+cleanup:
+    for (size_t i = 0; i < assignments_size; i++)
+        free(assignments[i].owned);
+
+    free(assignments);
+    c_flags_files_end();
+}
+
+static void control_execute(CFlagsControlClient *client, StringView line)
+{
+    StringView command = sv_next_word(&line);
+
+    if (command.size == 0)
+        return;
+
+    if (sv_equal(command, sv_from_string("LIST")))
+        control_list(client);
+    else if (sv_equal(command, sv_from_string("GET")))
+        control_get(client, line);
+    else if (sv_equal(command, sv_from_string("SET")))
+        control_set(client, line);
+    else
+        client_printf(client, "ERR unknown command " SVFMT "\n", SVARG(command));
+}
+
+static void client_close(CFlagsControlClient *client)
+{
+    if (client->prev != NULL)
+        client->prev->next = client->next;
+    else
+        control_clients = client->next;
+
+    if (client->next != NULL)
+        client->next->prev = client->prev;
+
+    epoll_ctl(control_epoll_fd, EPOLL_CTL_DEL, client->fd, NULL);
+    close(client->fd);
+
+    free(client->out);
+    free(client);
+}
+
+static bool client_flush(CFlagsControlClient *client)
+{
+    while (client->out_sent < client->out_size) {
+        ssize_t sent = send(client->fd,
+                            client->out + client->out_sent,
+                            client->out_size - client->out_sent,
+                            MSG_NOSIGNAL);
+
+        if (sent < 0 && errno == EINTR)
+            continue;
+
+        if (sent < 0 && errno == EAGAIN)
+            break;
+
+        if (sent < 0)
+            return false;
+
+        client->out_sent += (size_t) sent;
+    }
+
+    bool flushed = client->out_sent == client->out_size;
+    if (flushed) {
+        client->out_sent = 0;
+        client->out_size = 0;
+    }
+
+    struct epoll_event event = {
+        .events = flushed ? EPOLLIN : EPOLLOUT,
+        .data.ptr = client,
+    };
+
+    return epoll_ctl(control_epoll_fd, EPOLL_CTL_MOD, client->fd, &event) == 0;
+}
+
+static bool client_read(CFlagsControlClient *client)
+{
+    for (;;) {
+        ssize_t size = recv(client->fd,
+                            client->in + client->in_size,
+                            sizeof(client->in) - client->in_size,
+                            0);
+
+        if (size < 0 && errno == EINTR)
+            continue;
+
+        if (size < 0 && errno == EAGAIN)
+            return true;
+
+        if (size < 0)
+            return false;
+
+        if (size == 0) {
+            client->eof = true;
+            return true;
+        }
+
+        client->in_size += (size_t) size;
+
+        char *line = client->in;
+        char *line_end;
+
+        // the rest of a line that is too long is dropped up to its end
+        if (client->discarding) {
+            line_end = memchr(line, '\n', client->in_size);
+            client->discarding = line_end == NULL;
+            line = client->discarding ? client->in + client->in_size : line_end + 1;
+        }
+
+        while ((line_end = memchr(line, '\n', client->in_size - (size_t) (line - client->in)))) {
+            StringView sv_line = {.data = line, .size = (size_t) (line_end - line)};
+            if (sv_line.size > 0 && sv_line.data[sv_line.size - 1] == '\r')
+                sv_line.size -= 1;
+
+            control_execute(client, sv_line);
+            line = line_end + 1;
+        }
+
+        size_t rest = client->in_size - (size_t) (line - client->in);
+        memmove(client->in, line, rest);
+        client->in_size = rest;
+
+        if (client->in_size == sizeof(client->in)) {
+            client_printf(client, "ERR line is too long\n");
+            client->in_size = 0;
+            client->discarding = true;
+        }
+
+        if (client->broken)
+            return false;
+
+        // stop reading until the response is sent
+        if (client->out_size > 0)
+            return true;
+    }
+}
+
+static void control_accept(void)
+{
+    for (;;) {
+        int fd = accept4(control_listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return;
+
+        CFlagsControlClient *client = calloc(1, sizeof(CFlagsControlClient));
+        if (client == NULL) {
+            close(fd);
+            continue;
+        }
+
+        client->fd = fd;
+
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = client};
+        if (epoll_ctl(control_epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            close(fd);
+            free(client);
+            continue;
+        }
+
+        client->next = control_clients;
+        if (control_clients != NULL)
+            control_clients->prev = client;
+
+        control_clients = client;
+    }
+}
+
+/*
+ * Remove the socket left at the path by a previous run. Other files aren't
+ * removed, so a mistyped path doesn't delete an unrelated file.
+ */
+static bool control_path_release(const char *path)
+{
+    struct stat path_stat;
+
+    if (lstat(path, &path_stat) < 0)
+        return errno == ENOENT;
+
+    if (!S_ISSOCK(path_stat.st_mode)) {
+        errno = EEXIST;
+        return false;
+    }
+
+    return unlink(path) == 0 || errno == ENOENT;
+}
+
+int c_flags_control_open(const char *path)
+{
+    assert(path != NULL && "control socket path cannot be NULL");
+    assert(control_epoll_fd == -1 && "control socket is already opened");
+
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    size_t path_size = strlen(path);
+
+    if (path_size >= sizeof(address.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    memcpy(address.sun_path, path, path_size + 1);
+
+    // the path is owned by the control socket and removed on close once it's bound
+    char *bound_path = malloc(path_size + 1);
+    if (bound_path == NULL)
+        return -1;
+
+    memcpy(bound_path, path, path_size + 1);
+
+    control_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    control_listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    control_stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (control_epoll_fd < 0 || control_listen_fd < 0 || control_stop_fd < 0)
+        goto error;
+
+    if (!control_path_release(path))
+        goto error;
+
+    if (bind(control_listen_fd, (struct sockaddr *) &address, sizeof(address)) < 0)
+        goto error;
+
+    control_path = bound_path;
+    bound_path = NULL;
+
+    // connections are refused until listen(), so only the owner can ever connect
+    if (chmod(path, S_IRUSR | S_IWUSR) < 0)
+        goto error;
+
+    if (listen(control_listen_fd, SOMAXCONN) < 0)
+        goto error;
+
+    struct epoll_event listen_event = {.events = EPOLLIN, .data.ptr = &control_listen_marker};
+    struct epoll_event stop_event = {.events = EPOLLIN, .data.ptr = &control_stop_marker};
+
+    if (epoll_ctl(control_epoll_fd, EPOLL_CTL_ADD, control_listen_fd, &listen_event) < 0 ||
+        epoll_ctl(control_epoll_fd, EPOLL_CTL_ADD, control_stop_fd, &stop_event) < 0) {
+        goto error;
+    }
+
+    return control_epoll_fd;
+
+error:
+    free(bound_path);
+    c_flags_control_close();
+    return -1;
+}
+
+int c_flags_control_dispatch(void)
+{
+    assert(control_epoll_fd != -1 && "control socket is not opened");
+
+    struct epoll_event events[16];
+    int count = epoll_wait(control_epoll_fd, events, 16, 0);
+
+    if (count < 0)
+        return (errno == EINTR) ? 0 : -1;
+
+    for (int i = 0; i < count; i++) {
+        void *ptr = events[i].data.ptr;
+
+        if (ptr == &control_listen_marker) {
+            control_accept();
+            continue;
+        }
+
+        if (ptr == &control_stop_marker)
+            continue;
+
+        CFlagsControlClient *client = ptr;
+        bool alive = !(events[i].events & EPOLLERR);
+
+        if (alive && (events[i].events & (EPOLLIN | EPOLLHUP)))
+            alive = client_read(client);
+
+        if (alive)
+            alive = client_flush(client);
+
+        // the peer has finished sending requests and got all responses
+        if (!alive || (client->eof && client->out_size == 0))
+            client_close(client);
+    }
+
+    return 0;
+}
+
+static void *control_thread_main(void *arg)
+{
+    (void) arg;
+
+    for (;;) {
+        struct pollfd pfd = {.fd = control_epoll_fd, .events = POLLIN};
+
+        if (poll(&pfd, 1, -1) < 0 && errno != EINTR)
+            break;
+
+        uint64_t stop = 0;
+        if (read(control_stop_fd, &stop, sizeof(stop)) == sizeof(stop))
+            break;
+
+        if (c_flags_control_dispatch() < 0)
+            break;
+    }
+
+    return NULL;
+}
+
+bool c_flags_control_start_thread(void)
+{
+    assert(control_epoll_fd != -1 && "control socket is not opened");
+    assert(!control_thread_started && "control thread is already started");
+
+    control_thread_started = pthread_create(&control_thread, NULL, control_thread_main, NULL) == 0;
+    return control_thread_started;
+}
+
+void c_flags_control_close(void)
+{
+    if (control_thread_started) {
+        uint64_t stop = 1;
+        ssize_t written = write(control_stop_fd, &stop, sizeof(stop));
+        (void) written;
+
+        pthread_join(control_thread, NULL);
+        control_thread_started = false;
+    }
+
+    while (control_clients != NULL)
+        client_close(control_clients);
+
+    if (control_epoll_fd != -1)
+        close(control_epoll_fd);
+
+    if (control_listen_fd != -1)
+        close(control_listen_fd);
+
+    if (control_stop_fd != -1)
+        close(control_stop_fd);
+
+    if (control_path != NULL)
+        unlink(control_path);
+
+    free(control_path);
+
+    control_epoll_fd = -1;
+    control_listen_fd = -1;
+    control_stop_fd = -1;
+    control_path = NULL;
+}
@@ -0,0 +1,326 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+
+#ifndef C_FLAGS_CPUS_ONLINE_PATH
+#define C_FLAGS_CPUS_ONLINE_PATH "/sys/devices/system/cpu/online"
+#endif
+
+typedef struct CFlagsCpuSet CFlagsCpuSet;
+
+struct CFlagsCpuSet
+{
+    CFlagsCpuSet *next;
+    cpu_set_t set;
+};
+
+/*
+ * Distinct parsed sets are kept until exit, so a value is a stable pointer
+ * that can be read without locking and compared by address.
+ */
+static CFlagsCpuSet *cpu_sets = NULL;
+static pthread_mutex_t cpu_sets_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const cpu_set_t *cpus_intern(const cpu_set_t *set)
+{
+    pthread_mutex_lock(&cpu_sets_lock);
+
+    CFlagsCpuSet *node = cpu_sets;
+    while (node != NULL && !CPU_EQUAL(&node->set, set))
+        node = node->next;
+
+    if (node == NULL) {
+        node = malloc(sizeof(CFlagsCpuSet));
+
+        if (node != NULL) {
+            node->set = *set;
+            node->next = cpu_sets;
+            cpu_sets = node;
+        }
+    }
+
+    pthread_mutex_unlock(&cpu_sets_lock);
+    return node != NULL ? &node->set : NULL;
+}
+
+static const char *cpus_parse_number(const char *text, unsigned *number_ptr)
+{
+    unsigned number = 0;
+
+    if (!isdigit((unsigned char) *text))
+        return NULL;
+
+    for (; isdigit((unsigned char) *text); text++) {
+        number = number * 10 + (unsigned) (*text - '0');
+
+        if (number >= CPU_SETSIZE)
+            return NULL;
+    }
+
+    *number_ptr = number;
+    return text;
+}
+
+/*
+ * Parse one item of the list: `all`, `N`, `N-M`, `N-M:stride` or
+ * `N-M:used/group` as in the kernel, where the first `used` CPUs of every
+ * `group` CPUs are taken.
+ */
+static bool cpus_parse_item(StringView item, const cpu_set_t *online, cpu_set_t *set)
+{
+    if (sv_equal(item, sv_from_string("all"))) {
+        CPU_OR(set, set, online);
+        return true;
+    }
+
+    char text[32];
+    if (item.size == 0 || item.size >= sizeof(text))
+        return false;
+
+    memcpy(text, item.data, item.size);
+    text[item.size] = '\0';
+
+    unsigned first = 0;
+    unsigned last = 0;
+    unsigned used = 1;
+    unsigned group = 1;
+
+    const char *end = cpus_parse_number(text, &first);
+    if (end == NULL)
+        return false;
+
+    last = first;
+
+    if (*end == '-' && (end = cpus_parse_number(end + 1, &last)) == NULL)
+        return false;
+
+    if (*end == ':') {
+        if ((end = cpus_parse_number(end + 1, &group)) == NULL)
+            return false;
+
+        if (*end == '/') {
+            used = group;
+            if ((end = cpus_parse_number(end + 1, &group)) == NULL)
+                return false;
+        }
+    }
+
+    if (*end != '\0' || first > last || used == 0 || group == 0 || used > group)
+        return false;
+
+    for (unsigned cpu = first; cpu <= last; cpu++) {
+        if ((cpu - first) % group < used)
+            CPU_SET(cpu, set);
+    }
+
+    return true;
+}
+
+/*
+ * Exclusions are applied after all inclusions, so the order of items
+ * doesn't matter.
+ */
+static bool cpus_parse_list(const char *value, const cpu_set_t *online, cpu_set_t *set)
+{
+    StringView sv_value = sv_from_string(value);
+    cpu_set_t excluded;
+
+    CPU_ZERO(set);
+    CPU_ZERO(&excluded);
+
+    if (sv_value.size == 0)
+        return false;
+
+    while (true) {
+        int comma = sv_index_of(sv_value, sv_from_string(","));
+        size_t size = comma < 0 ? sv_value.size : (size_t) comma;
+        StringView item = sv_slice_left(sv_value, size);
+
+        bool exclude = item.size > 0 && item.data[0] == '^';
+        if (exclude)
+            item = sv_chop_left(item, 1);
+
+        if (!cpus_parse_item(item, online, exclude ? &excluded : set))
+            return false;
+
+        if (comma < 0)
+            break;
+
+        sv_value = sv_chop_left(sv_value, size + 1);
+    }
+
+    for (unsigned cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &excluded))
+            CPU_CLR(cpu, set);
+    }
+
+    return true;
+}
+
+/*
+ * Online CPUs are read on every parse since CPUs can be hotplugged.
+ * Configured processors are used if sysfs is not mounted.
+ */
+static void cpus_online(cpu_set_t *online)
+{
+    char text[C_FLAGS_FORMAT_SIZE];
+    ssize_t size = -1;
+
+    int fd = open(C_FLAGS_CPUS_ONLINE_PATH, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        size = read(fd, text, sizeof(text) - 1);
+        close(fd);
+    }
+
+    if (size > 0) {
+        cpu_set_t none;
+        CPU_ZERO(&none);
+
+        text[size] = '\0';
+        text[strcspn(text, "\n")] = '\0';
+
+        if (cpus_parse_list(text, &none, online))
+            return;
+    }
+
+    long count = sysconf(_SC_NPROCESSORS_CONF);
+
+    CPU_ZERO(online);
+    for (long cpu = 0; cpu < (count > 0 ? count : 1) && cpu < CPU_SETSIZE; cpu++)
+        CPU_SET((size_t) cpu, online);
+}
+
+bool c_flags_parse_cpus(const char *value, const void **cpus_ptr)
+{
+    cpu_set_t online;
+    cpu_set_t set;
+
+    cpus_online(&online);
+
+    if (!cpus_parse_list(value, &online, &set) || CPU_COUNT(&set) == 0)
+        return false;
+
+    // every CPU of the set must be online, excluded CPUs may be offline
+    cpu_set_t combined;
+    CPU_OR(&combined, &set, &online);
+    if (!CPU_EQUAL(&combined, &online))
+        return false;
+
+    const cpu_set_t *interned = cpus_intern(&set);
+    if (interned == NULL)
+        return false;
+
+    *cpus_ptr = interned;
+    return true;
+}
+
+const char *c_flags_format_cpus(const void *cpus, char *buffer, size_t size)
+{
+    const cpu_set_t *set = cpus;
+    size_t offset = 0;
+
+    buffer[0] = '\0';
+
+    if (set == NULL)
+        return buffer;
+
+    // canonical form of the kernel with ranges of consecutive CPUs
+    for (unsigned cpu = 0; cpu < CPU_SETSIZE && offset < size; cpu++) {
+        if (!CPU_ISSET(cpu, set))
+            continue;
+
+        unsigned last = cpu;
+        while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, set))
+            last++;
+
+        if (last == cpu) {
+            offset +=
+                (size_t) snprintf(buffer + offset, size - offset, offset > 0 ? ",%u" : "%u", cpu);
+        }
+        else {
+            offset += (size_t) snprintf(buffer + offset,
+                                        size - offset,
+                                        offset > 0 ? ",%u-%u" : "%u-%u",
+                                        cpu,
+                                        last);
+        }
+
+        cpu = last;
+    }
+
+    return buffer;
+}
+
+/*
+ * Online CPUs depend on the machine, so a default that is invalid here is
+ * reported and the flag is declared with all online CPUs instead.
+ */
+static bool cpus_declare(const char *long_name,
+                         const char *short_name,
+                         const char *desc,
+                         const char *default_val,
+                         void *var,
+                         CFlag **flag_ptr)
+{
+    assert(default_val != NULL && "the default value is required and cannot be NULL");
+
+    CFlag *flag = c_flags_declare(C_FLAG_CPUS, long_name, short_name, desc, var);
+
+    const void *cpus = NULL;
+    bool valid = c_flags_parse_cpus(default_val, &cpus);
+
+    if (!valid) {
+        printf("ERROR: invalid default value %s for %s flag --%s, all online CPUs are used\n",
+               default_val,
+               c_flag_type_name(C_FLAG_CPUS),
+               long_name);
+
+        // fails only when out of memory, the flag has no set then
+        c_flags_parse_cpus("all", &cpus);
+    }
+
+    flag->default_value.as_cpus = cpus;
+    c_flag_set_value(flag, flag->default_value);
+
+    *flag_ptr = flag;
+    return valid;
+}
+
+const cpu_set_t **c_flag_cpus(const char *long_name,
+                              const char *short_name,
+                              const char *desc,
+                              const char *default_val)
+{
+    CFlag *flag;
+    cpus_declare(long_name, short_name, desc, default_val, NULL, &flag);
+
+    return (const cpu_set_t **) flag->value;
+}
+
+bool c_flag_cpus_var(const cpu_set_t **var,
+                     const char *long_name,
+                     const char *short_name,
+                     const char *desc,
+                     const char *default_val)
+{
+    assert(var != NULL && "the variable is required and cannot be NULL");
+
+    CFlag *flag;
+    return cpus_declare(long_name, short_name, desc, default_val, (void *) var, &flag);
+}
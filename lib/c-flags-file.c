@@ -0,0 +1,351 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+
+typedef struct CFlagsFileNode CFlagsFileNode;
+
+struct CFlagsFileNode
+{
+    CFlagsFileNode *next;
+    CFlagType type;
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    struct timespec mtime;
+    CFlagsFile file;
+};
+
+/*
+ * Opened files are shared by values and defaults, the same file opened again
+ * with the same path gets the same handle, a replaced file or a modified mapped
+ * file gets a new one. Files are opened only by changes in progress, handles
+ * that no value or default references are released when the last one ends,
+ * like arenas of accumulating flags.
+ */
+static CFlagsFileNode *files = NULL;
+static size_t files_changes = 0;
+static pthread_mutex_t files_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// files are opened without blocking, so that parsing never waits for a FIFO writer
+static int file_open_flags(CFlagType type)
+{
+    switch (type) {
+    case C_FLAG_PATH:
+        return O_PATH | O_CLOEXEC;
+    case C_FLAG_DIRECTORY:
+        return O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+    default:
+        return O_RDONLY | O_NONBLOCK | O_CLOEXEC;
+    }
+}
+
+/*
+ * Open the path for the flag type and check the file type.
+ * Returns the descriptor, or -1 with the reason of the error.
+ */
+static int file_open(CFlagType type, const char *path, struct stat *st, const char **reason_ptr)
+{
+    if (path[0] == '\0') {
+        *reason_ptr = strerror(ENOENT);
+        return -1;
+    }
+
+    int fd = open(path, file_open_flags(type));
+    if (fd < 0) {
+        *reason_ptr = strerror(errno);
+        return -1;
+    }
+
+    if (fstat(fd, st) < 0) {
+        *reason_ptr = strerror(errno);
+        close(fd);
+        return -1;
+    }
+
+    const char *reason = NULL;
+
+    if ((type == C_FLAG_FILE || type == C_FLAG_MAPPED_FILE) && S_ISDIR(st->st_mode))
+        reason = strerror(EISDIR);
+    else if (type == C_FLAG_MAPPED_FILE && !S_ISREG(st->st_mode))
+        reason = "not a regular file";
+
+    if (reason == NULL && type == C_FLAG_FILE &&
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK) < 0) {
+        reason = strerror(errno);
+    }
+
+    if (reason != NULL) {
+        *reason_ptr = reason;
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static bool file_same(const CFlagsFileNode *node,
+                      CFlagType type,
+                      const char *path,
+                      const struct stat *st)
+{
+    if (node->type != type || node->dev != st->st_dev || node->ino != st->st_ino ||
+        strcmp(node->file.path, path) != 0) {
+        return false;
+    }
+
+    // descriptors follow the file, only mappings have to be created again for modified files
+    return type != C_FLAG_MAPPED_FILE ||
+           (node->size == st->st_size && node->mtime.tv_sec == st->st_mtim.tv_sec &&
+            node->mtime.tv_nsec == st->st_mtim.tv_nsec);
+}
+
+static CFlagsFileNode *file_create(CFlagType type, const char *path, int fd, const struct stat *st)
+{
+    size_t path_size = strlen(path) + 1;
+
+    CFlagsFileNode *node = malloc(sizeof(CFlagsFileNode) + path_size);
+    if (node == NULL)
+        return NULL;
+
+    char *path_copy = (char *) (node + 1);
+    memcpy(path_copy, path, path_size);
+
+    node->type = type;
+    node->dev = st->st_dev;
+    node->ino = st->st_ino;
+    node->size = st->st_size;
+    node->mtime = st->st_mtim;
+
+    node->file.path = path_copy;
+    node->file.fd = fd;
+    node->file.data = NULL;
+    node->file.size = (size_t) st->st_size;
+
+    if (type != C_FLAG_MAPPED_FILE)
+        return node;
+
+    // mapped files don't keep the descriptor, empty files have no mapping
+    if (st->st_size > 0) {
+        void *data = mmap(NULL, (size_t) st->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            free(node);
+            return NULL;
+        }
+
+        node->file.data = data;
+    }
+
+    close(fd);
+    node->file.fd = -1;
+
+    return node;
+}
+
+bool c_flags_open_file(CFlagType type, const char *value, const void **file_ptr)
+{
+    struct stat st;
+    const char *reason = NULL;
+
+    int fd = file_open(type, value, &st, &reason);
+    if (fd < 0)
+        return false;
+
+    pthread_mutex_lock(&files_lock);
+
+    CFlagsFileNode *node = files;
+    while (node != NULL && !file_same(node, type, value, &st))
+        node = node->next;
+
+    if (node != NULL) {
+        close(fd);
+    }
+    else {
+        node = file_create(type, value, fd, &st);
+
+        if (node != NULL) {
+            node->next = files;
+            files = node;
+        }
+        else {
+            close(fd);
+        }
+    }
+
+    pthread_mutex_unlock(&files_lock);
+
+    if (node == NULL)
+        return false;
+
+    *file_ptr = &node->file;
+    return true;
+}
+
+static bool file_referenced(const CFlagsFile *file)
+{
+    for (size_t i = 0; i < c_flags_count(); i++) {
+        const CFlag *flag = c_flags_at(i);
+
+        if (!c_flags_is_file(flag->type))
+            continue;
+
+        if (c_flag_get_value(flag).as_file == file || flag->default_value.as_file == file)
+            return true;
+    }
+
+    return false;
+}
+
+static void file_release(CFlagsFileNode *node)
+{
+    if (node->file.data != NULL)
+        munmap((void *) node->file.data, node->file.size);
+
+    if (node->file.fd >= 0)
+        close(node->file.fd);
+
+    free(node);
+}
+
+void c_flags_files_begin(void)
+{
+    pthread_mutex_lock(&files_lock);
+    files_changes += 1;
+    pthread_mutex_unlock(&files_lock);
+}
+
+void c_flags_files_end(void)
+{
+    pthread_mutex_lock(&files_lock);
+
+    assert(files_changes > 0 && "c_flags_files_end() without c_flags_files_begin()");
+    files_changes -= 1;
+
+    // files opened by other changes in progress may not be stored yet
+    CFlagsFileNode **link = &files;
+    while (files_changes == 0 && *link != NULL) {
+        CFlagsFileNode *node = *link;
+
+        if (file_referenced(&node->file)) {
+            link = &node->next;
+            continue;
+        }
+
+        *link = node->next;
+        file_release(node);
+    }
+
+    pthread_mutex_unlock(&files_lock);
+}
+
+const char *c_flags_describe_file(CFlagType type, const char *value, char *buffer, size_t size)
+{
+    struct stat st;
+    const char *reason = NULL;
+
+    int fd = file_open(type, value, &st, &reason);
+    if (fd >= 0) {
+        close(fd);
+        reason = "cannot be opened";
+    }
+
+    snprintf(buffer, size, "%s (%s)", value, reason);
+    return buffer;
+}
+
+static CFlagType file_type(CFlagsFileMode mode)
+{
+    switch (mode) {
+    case C_FLAGS_FILE_PATH:
+        return C_FLAG_PATH;
+    case C_FLAGS_FILE_DIRECTORY:
+        return C_FLAG_DIRECTORY;
+    case C_FLAGS_FILE_READ:
+        return C_FLAG_FILE;
+    case C_FLAGS_FILE_MAP:
+        return C_FLAG_MAPPED_FILE;
+    default:
+        assert(false && "unknown file mode");
+    }
+
+    return C_FLAG_FILE;
+}
+
+/*
+ * Declare the flag even if the default file cannot be opened, the error is
+ * reported and the flag keeps no file until it is set.
+ */
+static bool file_declare(const char *long_name,
+                         const char *short_name,
+                         const char *desc,
+                         CFlagsFileMode mode,
+                         const char *default_val,
+                         void *var,
+                         CFlag **flag_ptr)
+{
+    CFlagType type = file_type(mode);
+    CFlag *flag = c_flags_declare(type, long_name, short_name, desc, var);
+
+    c_flags_files_begin();
+
+    const void *file = NULL;
+    bool opened = default_val == NULL || c_flags_open_file(type, default_val, &file);
+
+    if (!opened) {
+        char invalid[C_FLAGS_FORMAT_SIZE];
+
+        printf("ERROR: invalid default value %s for %s flag --%s\n",
+               c_flags_describe_file(type, default_val, invalid, sizeof(invalid)),
+               c_flag_type_name(type),
+               long_name);
+    }
+
+    flag->default_value.as_file = file;
+    c_flag_set_value(flag, flag->default_value);
+
+    c_flags_files_end();
+
+    *flag_ptr = flag;
+    return opened;
+}
+
+const CFlagsFile **c_flag_file(const char *long_name,
+                               const char *short_name,
+                               const char *desc,
+                               CFlagsFileMode mode,
+                               const char *default_val)
+{
+    CFlag *flag;
+    file_declare(long_name, short_name, desc, mode, default_val, NULL, &flag);
+
+    return (const CFlagsFile **) flag->value;
+}
+
+bool c_flag_file_var(const CFlagsFile **var,
+                     const char *long_name,
+                     const char *short_name,
+                     const char *desc,
+                     CFlagsFileMode mode,
+                     const char *default_val)
+{
+    assert(var != NULL && "the variable is required and cannot be NULL");
+
+    CFlag *flag;
+    return file_declare(long_name, short_name, desc, mode, default_val, (void *) var, &flag);
+}
@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+
+static bool frozen = false;
+
+#if defined(__unix__) || defined(__APPLE__)
+static struct sigaction previous_segv_action;
+static struct sigaction previous_bus_action;
+
+static void write_string(const char *text)
+{
+    ssize_t written = write(STDOUT_FILENO, text, strlen(text));
+    (void) written;
+}
+
+static void restore_actions(void)
+{
+    sigaction(SIGSEGV, &previous_segv_action, NULL);
+    sigaction(SIGBUS, &previous_bus_action, NULL);
+}
+
+/*
+ * Report writes to the frozen storage, then restore previous handlers,
+ * so the faulting write is repeated and handled as usual.
+ */
+static void frozen_write_handler(int signal, siginfo_t *info, void *context)
+{
+    (void) signal;
+    (void) context;
+
+    size_t size = 0;
+    uintptr_t begin = (uintptr_t) c_flags_value_storage(&size);
+    uintptr_t address = (uintptr_t) info->si_addr;
+
+    if (address >= begin && address < begin + size) {
+        size_t slot = (address - begin) / sizeof(CFlagSlot) * sizeof(CFlagSlot);
+        const CFlag *flag = c_flags_find_by_data((const void *) (begin + slot));
+
+        if (flag != NULL) {
+            write_string("ERROR: write to frozen flag --");
+            write_string(flag->long_name);
+            write_string("\n");
+        }
+        else {
+            write_string("ERROR: write to frozen flags\n");
+        }
+    }
+
+    restore_actions();
+}
+
+static bool report_frozen_writes(void)
+{
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = frozen_write_handler;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+
+    if (sigaction(SIGSEGV, &action, &previous_segv_action) < 0)
+        return false;
+
+    if (sigaction(SIGBUS, &action, &previous_bus_action) < 0) {
+        sigaction(SIGSEGV, &previous_segv_action, NULL);
+        return false;
+    }
+
+    return true;
+}
+#endif
+
+bool c_flags_freeze(bool report_writes)
+{
+    if (frozen)
+        return true;
+
+    size_t size = 0;
+    void *storage = c_flags_value_storage(&size);
+
+#if defined(_WIN32)
+    (void) report_writes;
+
+    DWORD old_protection;
+    if (!VirtualProtect(storage, size, PAGE_READONLY, &old_protection))
+        return false;
+#elif defined(__unix__) || defined(__APPLE__)
+    long page_size = sysconf(_SC_PAGESIZE);
+
+    /*
+     * The storage is aligned for the largest page size of the architecture,
+     * larger pages would protect neighbouring data, so freezing is refused.
+     */
+    if (page_size <= 0 || C_FLAGS_PAGE_SIZE % page_size != 0)
+        return false;
+
+    if (report_writes && !report_frozen_writes())
+        return false;
+
+    if (mprotect(storage, size, PROT_READ) < 0) {
+        if (report_writes)
+            restore_actions();
+
+        return false;
+    }
+#else
+    (void) report_writes;
+    (void) storage;
+    return false;
+#endif
+
+    frozen = true;
+    return true;
+}
+
+bool c_flags_is_frozen(void)
+{
+    return frozen;
+}
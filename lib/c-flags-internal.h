@@ -0,0 +1,838 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef C_FLAGS_INTERNAL_H
+#define C_FLAGS_INTERNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "c-flags.h"
+#include "string-view.h"
+
+#ifndef C_FLAGS_CAPACITY
+#define C_FLAGS_CAPACITY 64
+#endif
+
+#ifndef C_FLAGS_CACHE_LINE_SIZE
+#define C_FLAGS_CACHE_LINE_SIZE 64
+#endif
+
+// size of buffers for formatted values, long sets are truncated
+#define C_FLAGS_FORMAT_SIZE 1024
+
+// size of the buffer that fits any formatted CPU set without truncation
+#define C_FLAGS_CPUS_FORMAT_SIZE 8192
+
+// alignment of list memory, see `c_flags_list_memory()`
+#define C_FLAGS_LIST_ALIGNMENT 8
+
+// the largest page size of the platform, arm64 Linux kernels are built with pages up to 64K
+#ifndef C_FLAGS_PAGE_SIZE
+#if defined(_WIN32) || defined(__i386__) || defined(__x86_64__)
+#define C_FLAGS_PAGE_SIZE 4096
+#elif defined(__APPLE__) && defined(__aarch64__)
+#define C_FLAGS_PAGE_SIZE 16384
+#else
+#define C_FLAGS_PAGE_SIZE 65536
+#endif
+#endif
+
+/*
+ * Vector kernels of lists and binary values, SSE2 is a part of x86-64 and
+ * NEON is a part of AArch64. Other targets or builds with C_FLAGS_NO_SIMD
+ * use SWAR kernels working on eight bytes of uint64_t.
+ */
+#ifndef C_FLAGS_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define C_FLAGS_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define C_FLAGS_NEON
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#define C_FLAGS_ALIGNED(alignment) __declspec(align(alignment))
+#else
+#define C_FLAGS_ALIGNED(alignment) __attribute__((aligned(alignment)))
+#endif
+
+typedef enum {
+    C_FLAG_INT,
+    C_FLAG_INT_8,
+    C_FLAG_INT_16,
+    C_FLAG_INT_32,
+    C_FLAG_INT_64,
+    C_FLAG_UNSIGNED,
+    C_FLAG_UINT_8,
+    C_FLAG_UINT_16,
+    C_FLAG_UINT_32,
+    C_FLAG_UINT_64,
+    C_FLAG_SIZE_T,
+    C_FLAG_BOOL,
+    C_FLAG_STRING,
+    C_FLAG_FLOAT,
+    C_FLAG_DOUBLE,
+    C_FLAG_BYTES,
+    C_FLAG_DURATION,
+    C_FLAG_CHOICE,
+    C_FLAG_SET,
+    C_FLAG_CPUS,
+    C_FLAG_INT32_LIST,
+    C_FLAG_INT64_LIST,
+    C_FLAG_UINT32_LIST,
+    C_FLAG_UINT64_LIST,
+    C_FLAG_DOUBLE_LIST,
+    C_FLAG_COUNTER,
+    C_FLAG_STRINGS,
+    C_FLAG_PATH,
+    C_FLAG_DIRECTORY,
+    C_FLAG_FILE,
+    C_FLAG_MAPPED_FILE,
+    C_FLAG_BINARY,
+} CFlagType;
+
+typedef enum {
+    C_FLAG_SOURCE_DEFAULT,
+    C_FLAG_SOURCE_COMMAND_LINE,
+    C_FLAG_SOURCE_CONFIG,
+    C_FLAG_SOURCE_CONTROL,
+    C_FLAG_SOURCE_SHARED_MEMORY,
+} CFlagSource;
+
+typedef struct CFlagSubscription CFlagSubscription;
+
+/**
+ * Allowed names of choice and set flags with the perfect hash for lookup.
+ * The name is found at `slots[hash(name, displacements[hash(name, 0) % buckets_size])]`.
+ */
+typedef struct
+{
+    const char *const *names;
+    size_t count;
+    size_t buckets_size;
+    size_t slots_size;
+    uint16_t *displacements;
+    uint8_t *slots;
+} CFlagChoices;
+
+/**
+ * Value of a flag, the member is selected by the flag type.
+ * `raw` covers the whole value, so values of the same type can be copied
+ * and compared with it when unused bytes are zero.
+ */
+typedef union {
+    int as_int;
+    int8_t as_int8;
+    int16_t as_int16;
+    int32_t as_int32;
+    int64_t as_int64;
+    unsigned as_unsigned;
+    uint8_t as_uint8;
+    uint16_t as_uint16;
+    uint32_t as_uint32;
+    uint64_t as_uint64;
+    size_t as_size_t;
+    bool as_bool;
+    char *as_string;
+    float as_float;
+    double as_double;
+    uint64_t as_bytes;
+    int64_t as_duration;
+    int as_choice;
+    uint64_t as_set;
+    const void *as_cpus;
+    const void *as_list;
+    unsigned as_counter;
+    char **as_strings;
+    const void *as_file;
+    uintmax_t raw;
+} CFlagValue;
+
+/**
+ * Slot of the value storage. Values are stored densely, so values read
+ * together share cache lines. Define `C_FLAGS_PAD_VALUES` when compile
+ * to give every value its own cache line if flags are changed at runtime
+ * while other threads read neighbouring values.
+ */
+typedef struct
+{
+    CFlagValue value;
+#if defined(C_FLAGS_PAD_VALUES)
+    char padding[C_FLAGS_CACHE_LINE_SIZE - sizeof(CFlagValue)];
+#endif
+} CFlagSlot;
+
+/**
+ * Metadata of a flag used for parsing, help and runtime changes.
+ * The current value lives in the separate value storage or in the variable
+ * bound by the application, so it has only the size of the flag type.
+ * Values of packed boolean flags live in the bitset at `bit` index.
+ */
+typedef struct
+{
+    void *value;
+    CFlagType type;
+    CFlagSource source;
+    const char *long_name;
+    const char *short_name;
+    const char *desc;
+    const CFlagChoices *choices;
+    CFlagValue default_value;
+    void *owned;
+    CFlagSubscription *subscriptions;
+    unsigned change_stamp;
+    bool hidden;
+    bool packed;
+    unsigned bit;
+} CFlag;
+
+/**
+ * A pending change of one flag value.
+ * String, list and accumulating flag values may reference library-owned memory in `owned`,
+ * ownership is transferred to the flag when the assignment is applied.
+ */
+typedef struct
+{
+    CFlag *flag;
+    CFlagValue value;
+    void *owned;
+} CFlagAssignment;
+
+/**
+ * Get number of declared flags
+ *
+ * @return number of flags
+ */
+size_t c_flags_count(void);
+
+/**
+ * Get declared flag by index in declaration order
+ *
+ * @param index flag index less than `c_flags_count()`
+ * @return flag instance
+ */
+CFlag *c_flags_at(size_t index);
+
+/**
+ * Register flag which value is stored in the value storage or in the variable
+ *
+ * @param type flag type
+ * @param long_name long name of the flag
+ * @param short_name short name of the flag or NULL
+ * @param desc description of the flag or NULL
+ * @param var variable for the value or NULL to use the value storage
+ * @return flag instance with default value to be set by the caller
+ */
+CFlag *c_flags_declare(CFlagType type,
+                       const char *long_name,
+                       const char *short_name,
+                       const char *desc,
+                       void *var);
+
+/**
+ * Find declared flag by long name
+ *
+ * @param long_name long name of the flag without leading dashes
+ * @return flag instance if found, otherwise NULL
+ */
+CFlag *c_flags_find_by_long_name(StringView long_name);
+
+/**
+ * Find declared flag by pointer to its value in constant time
+ *
+ * @param value pointer returned by `c_flag_*` function
+ * @return flag instance if found, otherwise NULL
+ */
+CFlag *c_flags_find_by_data(const void *value);
+
+/**
+ * Get page aligned storage of flag values, which starts with `CFlagSlot` array
+ * in declaration order and occupies whole pages
+ *
+ * @param size_ptr pointer to store size of the storage
+ * @return storage address
+ */
+void *c_flags_value_storage(size_t *size_ptr);
+
+/**
+ * Get hash of names and types of declared flags.
+ * Processes that declare the same flags in the same order have the same hash.
+ *
+ * @return schema hash
+ */
+uint64_t c_flags_schema_hash(void);
+
+/**
+ * Get version of the registry which is changed when flags are declared
+ * or help messages are customized, so cached help can be invalidated
+ *
+ * @return registry version
+ */
+unsigned c_flags_registry_version(void);
+
+/**
+ * Get application name set with `c_flags_set_application_name()`
+ *
+ * @return application name or NULL
+ */
+const char *c_flags_application_name(void);
+
+/**
+ * Get positional arguments description set with `c_flags_set_positional_args_description()`
+ *
+ * @return positional arguments description or NULL
+ */
+const char *c_flags_positional_args_description(void);
+
+/**
+ * Get description set with `c_flags_set_description()`
+ *
+ * @return description or NULL
+ */
+const char *c_flags_description(void);
+
+/**
+ * Get printable name of the flag type for error messages
+ *
+ * @param type flag type
+ * @return type name like "int8_t" or "char *"
+ */
+const char *c_flag_type_name(CFlagType type);
+
+/**
+ * Get printable name of the flag value provenance
+ *
+ * @param source flag value provenance
+ * @return source name like "default" or "config"
+ */
+const char *c_flag_source_name(CFlagSource source);
+
+/**
+ * Format flag value in the form accepted by `c_flag_convert()`
+ *
+ * @param flag flag which type is used for formatting
+ * @param value value of the flag type
+ * @param buffer buffer for formatted numbers, see `C_FLAGS_FORMAT_SIZE`
+ * @param size size of the buffer
+ * @return formatted value, may point to the string value itself or be NULL for NULL strings
+ */
+const char *c_flag_format(const CFlag *flag, CFlagValue value, char *buffer, size_t size);
+
+/**
+ * Convert string value according to the flag type without changing the flag.
+ * Boolean flags accept "true" and "false".
+ *
+ * @param flag flag which type is used for conversion
+ * @param value string value to convert
+ * @param value_ptr pointer to store converted value, unused bytes are zeroed
+ * @return true if value is valid for the flag, otherwise false
+ */
+bool c_flag_convert(const CFlag *flag, const char *value, CFlagValue *value_ptr);
+
+/**
+ * Compare two values of the flag, string values are compared by content
+ *
+ * @param flag flag which type is used for comparison
+ * @param a value of the flag type
+ * @param b value of the flag type
+ * @return true if values are equal, otherwise false
+ */
+bool c_flag_value_equal(const CFlag *flag, CFlagValue a, CFlagValue b);
+
+/**
+ * Read current value of the flag
+ *
+ * @param flag flag instance
+ * @return current value, unused bytes are zeroed
+ */
+CFlagValue c_flag_get_value(const CFlag *flag);
+
+/**
+ * Write current value of the flag without notifying observers
+ *
+ * @param flag flag instance
+ * @param value value of the flag type
+ */
+void c_flag_set_value(CFlag *flag, CFlagValue value);
+
+/**
+ * Parse byte size like `512MiB`, `4k` or `1.5G` with decimal and binary suffixes.
+ * Fractions are accepted only if they give a whole number of bytes.
+ *
+ * @param value string value to parse
+ * @param bytes_ptr pointer to store number of bytes
+ * @return true if value is valid and fits `uint64_t`, otherwise false
+ */
+bool c_flags_parse_bytes(const char *value, uint64_t *bytes_ptr);
+
+/**
+ * Parse duration like `250ms`, `2m30s` or `1h` into nanoseconds
+ *
+ * @param value string value to parse
+ * @param duration_ptr pointer to store number of nanoseconds
+ * @return true if value is valid and fits `int64_t`, otherwise false
+ */
+bool c_flags_parse_duration(const char *value, int64_t *duration_ptr);
+
+/**
+ * Format byte size with the largest unit that keeps the value exact
+ *
+ * @param bytes number of bytes
+ * @param buffer buffer for formatted value, 32 bytes are enough
+ * @param size size of the buffer
+ * @return formatted value like `512MiB`
+ */
+const char *c_flags_format_bytes(uint64_t bytes, char *buffer, size_t size);
+
+/**
+ * Format duration with units from hours to nanoseconds
+ *
+ * @param duration number of nanoseconds
+ * @param buffer buffer for formatted value, 32 bytes are enough
+ * @param size size of the buffer
+ * @return formatted value like `2m30s`
+ */
+const char *c_flags_format_duration(int64_t duration, char *buffer, size_t size);
+
+/**
+ * Find index of the allowed name of choice or set flag
+ *
+ * @param choices allowed names
+ * @param name name to find
+ * @param index_ptr pointer to store index of the name
+ * @return true if name is allowed, otherwise false
+ */
+bool c_flags_choices_find(const CFlagChoices *choices, StringView name, size_t *index_ptr);
+
+/**
+ * Parse value of choice flag
+ *
+ * @param choices allowed names
+ * @param value string value to parse
+ * @param index_ptr pointer to store index of the name
+ * @return true if value is one of the names, otherwise false
+ */
+bool c_flags_parse_choice(const CFlagChoices *choices, const char *value, int *index_ptr);
+
+/**
+ * Parse comma-separated names of set flag into the bitmask
+ *
+ * @param choices allowed names
+ * @param value string value to parse, empty for the empty set
+ * @param mask_ptr pointer to store the bitmask with bits at name indexes
+ * @return true if all names are allowed, otherwise false
+ */
+bool c_flags_parse_set(const CFlagChoices *choices, const char *value, uint64_t *mask_ptr);
+
+/**
+ * Format value of choice flag
+ *
+ * @param choices allowed names
+ * @param index index of the name
+ * @param buffer buffer used for indexes out of range
+ * @param size size of the buffer
+ * @return name or formatted index
+ */
+const char *c_flags_format_choice(const CFlagChoices *choices,
+                                  int index,
+                                  char *buffer,
+                                  size_t size);
+
+/**
+ * Format value of set flag as comma-separated names
+ *
+ * @param choices allowed names
+ * @param mask bitmask with bits at name indexes
+ * @param buffer buffer for formatted value
+ * @param size size of the buffer
+ * @return formatted value
+ */
+const char *c_flags_format_set(const CFlagChoices *choices,
+                               uint64_t mask,
+                               char *buffer,
+                               size_t size);
+
+/**
+ * Format allowed names of choice and set flags for help and errors
+ *
+ * @param flag flag instance
+ * @param separator separator of names
+ * @param buffer buffer for formatted names
+ * @param size size of the buffer
+ * @return formatted names or NULL for other flags
+ */
+const char *c_flags_format_choices(const CFlag *flag,
+                                   const char *separator,
+                                   char *buffer,
+                                   size_t size);
+
+/**
+ * Parse Linux cpulist like `0-7,16-23:2,^4` into the CPU set. All CPUs
+ * of the set must be online, sets are kept by the library until exit.
+ *
+ * @param value string value to parse
+ * @param cpus_ptr pointer to store `const cpu_set_t *`, equal sets have the same address
+ * @return true if value is a valid non-empty list of online CPUs, otherwise false
+ */
+bool c_flags_parse_cpus(const char *value, const void **cpus_ptr);
+
+/**
+ * Format CPU set in the canonical form of the kernel like `0-7,16,18`
+ *
+ * @param cpus pointer to `cpu_set_t`
+ * @param buffer buffer for formatted value, see `C_FLAGS_CPUS_FORMAT_SIZE`
+ * @param size size of the buffer
+ * @return formatted value
+ */
+const char *c_flags_format_cpus(const void *cpus, char *buffer, size_t size);
+
+/**
+ * Check whether the flag type is one of the file types
+ *
+ * @param type flag type
+ * @return true for path, directory, file and mapped file types, otherwise false
+ */
+bool c_flags_is_file(CFlagType type);
+
+/**
+ * Check whether values of the flag type are resources kept by the library,
+ * that are stored outside of the process as text and converted again
+ *
+ * @param type flag type
+ * @return true for CPU sets and files, otherwise false
+ */
+bool c_flags_is_reconverted(CFlagType type);
+
+/**
+ * Open the file for the flag type, see `CFlagsFileMode`.
+ * Files are opened only between `c_flags_files_begin()` and `c_flags_files_end()`.
+ *
+ * @param type file flag type
+ * @param value path of the file
+ * @param file_ptr pointer to store `const CFlagsFile *`, the same unchanged file
+ *                 opened with the same path has the same address
+ * @return true if the file is opened and has the right type, otherwise false
+ */
+bool c_flags_open_file(CFlagType type, const char *value, const void **file_ptr);
+
+#if defined(__linux__)
+/**
+ * Start a change that opens files for values, which are stored
+ * into flags later, so handles aren't released until it ends
+ */
+void c_flags_files_begin(void);
+
+/**
+ * End the change. When no other change is in progress, files
+ * that no value or default references are closed and unmapped.
+ */
+void c_flags_files_end(void);
+#else
+// files are opened only on Linux
+#define c_flags_files_begin() ((void) 0)
+#define c_flags_files_end() ((void) 0)
+#endif
+
+/**
+ * Describe why the file cannot be opened for error messages
+ *
+ * @param type file flag type
+ * @param value path of the file
+ * @param buffer buffer for the description
+ * @param size size of the buffer
+ * @return description like `/etc/x (No such file or directory)`
+ */
+const char *c_flags_describe_file(CFlagType type, const char *value, char *buffer, size_t size);
+
+/**
+ * Check whether the flag type is one of the numeric list types or binary,
+ * which is stored as the list of bytes
+ *
+ * @param type flag type
+ * @return true for list and binary types, otherwise false
+ */
+bool c_flags_is_list(CFlagType type);
+
+/**
+ * Get size of list elements
+ *
+ * @param type list flag type
+ * @return element size in bytes
+ */
+size_t c_flags_list_element_size(CFlagType type);
+
+/**
+ * Count elements of a list as runs of characters other than commas and
+ * whitespace, the count is exact for valid lists.
+ *
+ * @param value string value of the list
+ * @param size size of the value
+ * @return number of elements
+ */
+size_t c_flags_list_count(const char *value, size_t size);
+
+/**
+ * Parse numbers separated by commas or whitespace into one allocation
+ * holding the number of elements followed by the elements.
+ *
+ * @param type list flag type
+ * @param value string value to parse, empty for the empty list
+ * @param values_ptr pointer to store elements, NULL for the empty list
+ * @param error_index_ptr pointer to store index of the invalid element, SIZE_MAX if out of
+ *                        memory, or NULL
+ * @return true if all elements are valid, otherwise false
+ */
+bool c_flags_parse_list(CFlagType type,
+                        const char *value,
+                        const void **values_ptr,
+                        size_t *error_index_ptr);
+
+/**
+ * Allocate the list for the number of elements to be filled by the caller
+ *
+ * @param type list flag type
+ * @param count number of elements, not zero
+ * @param values_ptr pointer to store elements
+ * @return true on success, false if out of memory
+ */
+bool c_flags_list_allocate(CFlagType type, size_t count, void **values_ptr);
+
+/**
+ * Copy elements into a new list allocation
+ *
+ * @param type list flag type
+ * @param data elements
+ * @param count number of elements
+ * @param values_ptr pointer to store elements, NULL for the empty list
+ * @return true on success, false if out of memory
+ */
+bool c_flags_list_copy(CFlagType type, const void *data, size_t count, const void **values_ptr);
+
+/**
+ * Get memory of the list with the number of elements followed by the elements,
+ * which can be copied as is and used in place with `c_flags_list_from_memory()`
+ *
+ * @param type list flag type
+ * @param values list elements or NULL
+ * @param size_ptr pointer to store size of the memory
+ * @return list memory or NULL with zero size for the empty list
+ */
+const void *c_flags_list_memory(CFlagType type, const void *values, size_t *size_ptr);
+
+/**
+ * Get list elements from the memory returned by `c_flags_list_memory()`
+ *
+ * @param type list flag type
+ * @param memory list memory aligned to `C_FLAGS_LIST_ALIGNMENT`
+ * @param size size of the memory, zero for the empty list
+ * @param values_ptr pointer to store elements inside of the memory
+ * @return true if the memory holds a valid list, otherwise false
+ */
+bool c_flags_list_from_memory(CFlagType type,
+                              const void *memory,
+                              size_t size,
+                              const void **values_ptr);
+
+/**
+ * Get allocation of the list to be released with `free()`
+ *
+ * @param values list elements or NULL
+ * @return allocation or NULL for the empty list
+ */
+void *c_flags_list_allocation(const void *values);
+
+/**
+ * Format list elements separated by commas like `snprintf()`
+ *
+ * @param type list flag type
+ * @param values list elements or NULL
+ * @param buffer buffer for formatted value or NULL if size is 0
+ * @param size size of the buffer, the value is truncated to fit
+ * @return length of the whole formatted value
+ */
+size_t c_flags_format_list(CFlagType type, const void *values, char *buffer, size_t size);
+
+/**
+ * Decode `hex:` or `base64:` value into the list of bytes. Hex digits
+ * are case-insensitive, base64 uses the standard alphabet with padding.
+ *
+ * @param value string value to decode, empty or only the prefix for no bytes
+ * @param values_ptr pointer to store bytes, NULL for no bytes
+ * @return true if value is valid, false if it's not or out of memory
+ */
+bool c_flags_parse_binary(const char *value, const void **values_ptr);
+
+/**
+ * Describe why the binary value is invalid for error messages
+ *
+ * @param value string value rejected by `c_flags_parse_binary()`
+ * @param buffer buffer for the description
+ * @param size size of the buffer
+ * @return description like `hex:0g (invalid hex digit at offset 5)`
+ */
+const char *c_flags_describe_binary(const char *value, char *buffer, size_t size);
+
+/**
+ * Format bytes as `base64:` value like `snprintf()`
+ *
+ * @param values bytes or NULL
+ * @param buffer buffer for formatted value or NULL if size is 0
+ * @param size size of the buffer, the value is truncated to fit
+ * @return length of the whole formatted value, the empty value has no prefix
+ */
+size_t c_flags_format_binary(const void *values, char *buffer, size_t size);
+
+/**
+ * Start collecting occurrences of accumulating flags for one parse
+ * in the arena sized for all arguments
+ *
+ * @param argc number of arguments
+ * @return true on success, false if out of memory
+ */
+bool c_flags_strings_begin(int argc);
+
+/**
+ * Collect occurrence of accumulating flag found by the running parse
+ *
+ * @param flag accumulating flag
+ * @param value value of the occurrence that stays alive while the flags are used
+ */
+void c_flags_strings_collect(CFlag *flag, char *value);
+
+/**
+ * Store collected occurrences as values of accumulating flags. Arenas of
+ * previous parses are released when no flag references them anymore.
+ */
+void c_flags_strings_end(void);
+
+/**
+ * Get memory of accumulating flag value with every element terminated by '\0'
+ *
+ * @param values NULL-terminated array of strings
+ * @param buffer buffer for the memory or NULL to get only the size
+ * @return size of the memory
+ */
+size_t c_flags_strings_memory(char *const *values, char *buffer);
+
+/**
+ * Index elements of the memory returned by `c_flags_strings_memory()` in place
+ *
+ * @param memory memory with every element terminated by '\0'
+ * @param size size of the memory
+ * @param values array for `count + 1` pointers to elements followed by NULL,
+ *               or NULL to get only the number of elements
+ * @return number of elements
+ */
+size_t c_flags_strings_index(const char *memory, size_t size, char **values);
+
+/**
+ * Copy elements of the memory returned by `c_flags_strings_memory()` into
+ * one allocation starting with the array, see `c_flag_value_allocation()`
+ *
+ * @param memory memory with every element terminated by '\0'
+ * @param size size of the memory, zero for the empty array
+ * @param values_ptr pointer to store NULL-terminated array of strings
+ * @return true if the memory is valid, false if it's not or out of memory
+ */
+bool c_flags_strings_copy(const char *memory, size_t size, char ***values_ptr);
+
+/**
+ * Format elements of accumulating flag value separated by commas
+ *
+ * @param values NULL-terminated array of strings
+ * @param buffer buffer for formatted value
+ * @param size size of the buffer, the value is truncated to fit
+ * @return formatted value
+ */
+const char *c_flags_format_strings(char *const *values, char *buffer, size_t size);
+
+/**
+ * Check whether the flag takes a value on the command line,
+ * booleans and counters are given alone like `--verbose` or `-vvv`
+ *
+ * @param flag flag instance
+ * @return true if the flag requires a value, otherwise false
+ */
+bool c_flag_takes_value(const CFlag *flag);
+
+/**
+ * Get memory allocated by `c_flag_convert()` for the value, which is released
+ * with `free()` by the owner of the value, see `CFlagAssignment`
+ *
+ * @param flag flag which type is used
+ * @param value value of the flag type
+ * @return allocation of list and accumulating flag values, otherwise NULL
+ */
+void *c_flag_value_allocation(const CFlag *flag, CFlagValue value);
+
+/**
+ * Describe the invalid value for error messages. Only the invalid element
+ * of lists is shown, since lists may be long, files and binary values are shown
+ * with the reason.
+ *
+ * @param flag flag instance
+ * @param value string value rejected by `c_flag_convert()`
+ * @param buffer buffer for the description
+ * @param size size of the buffer
+ * @return description like `x at index 2` or the value itself
+ */
+const char *c_flag_describe_invalid(const CFlag *flag,
+                                    const char *value,
+                                    char *buffer,
+                                    size_t size);
+
+/**
+ * Apply already validated assignments to the flags.
+ * Only flags whose values differ are changed, unchanged assignments
+ * release their owned memory. Observers are notified once about all changed flags.
+ *
+ * @param assignments array of assignments
+ * @param count number of assignments
+ * @param source provenance of the new values
+ * @return number of changed flags
+ */
+size_t c_flags_apply(CFlagAssignment *assignments, size_t count, CFlagSource source);
+
+/**
+ * Lock flags for changes applied from the control thread.
+ * Locking is only required on platforms where such a thread may exist.
+ */
+void c_flags_lock(void);
+
+/**
+ * Unlock flags locked by `c_flags_lock()`.
+ */
+void c_flags_unlock(void);
+
+/**
+ * Remove observer registered with `c_flags_observe_all()`, do nothing if
+ * it isn't registered.
+ *
+ * @param callback callback of the observer
+ * @param user_data user data of the observer
+ */
+void c_flags_unobserve_all(CFlagsObserver callback, void *user_data);
+
+/**
+ * Notify observers about changed flags, must be called without the flags lock.
+ * Every observer is called once with the changed flags it is subscribed to,
+ * notifications from different threads are serialized.
+ *
+ * @param changed array of distinct changed flags
+ * @param count number of changed flags
+ */
+void c_flags_notify(CFlag *const *changed, size_t count);
+
+/**
+ * Write completion script requested with the completion flag to stdout
+ * and exit, do nothing if it wasn't requested
+ *
+ * @param program program path from argv[0]
+ */
+void c_flags_completion_dispatch(const char *program);
+
+#endif // C_FLAGS_INTERNAL_H
@@ -0,0 +1,518 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+
+#if defined(C_FLAGS_SSE2)
+#include <emmintrin.h>
+#elif defined(C_FLAGS_NEON)
+#include <arm_neon.h>
+#endif
+
+#define C_FLAGS_LIST_ONES  0x0101010101010101ULL
+#define C_FLAGS_LIST_HIGHS 0x8080808080808080ULL
+
+/*
+ * The elements follow the header in the same allocation,
+ * the union keeps them aligned for any element type.
+ */
+typedef union {
+    size_t count;
+    uint64_t align_uint64;
+    double align_double;
+} CFlagsListHeader;
+
+static CFlagsListHeader *list_header(const void *values)
+{
+    return (CFlagsListHeader *) values - 1;
+}
+
+bool c_flags_is_list(CFlagType type)
+{
+    return (type >= C_FLAG_INT32_LIST && type <= C_FLAG_DOUBLE_LIST) || type == C_FLAG_BINARY;
+}
+
+size_t c_flags_list_element_size(CFlagType type)
+{
+    switch (type) {
+    case C_FLAG_INT32_LIST:
+        return sizeof(int32_t);
+    case C_FLAG_INT64_LIST:
+        return sizeof(int64_t);
+    case C_FLAG_UINT32_LIST:
+        return sizeof(uint32_t);
+    case C_FLAG_UINT64_LIST:
+        return sizeof(uint64_t);
+    case C_FLAG_DOUBLE_LIST:
+        return sizeof(double);
+    case C_FLAG_BINARY:
+        return sizeof(uint8_t);
+    default:
+        assert(false && "not all list types implements c_flags_list_element_size()");
+    }
+
+    return 0;
+}
+
+size_t c_flags_list_size(const void *values)
+{
+    return values != NULL ? list_header(values)->count : 0;
+}
+
+void *c_flags_list_allocation(const void *values)
+{
+    return values != NULL ? list_header(values) : NULL;
+}
+
+const void *c_flags_list_memory(CFlagType type, const void *values, size_t *size_ptr)
+{
+    size_t count = c_flags_list_size(values);
+
+    *size_ptr = count > 0 ? sizeof(CFlagsListHeader) + count * c_flags_list_element_size(type) : 0;
+    return c_flags_list_allocation(values);
+}
+
+bool c_flags_list_from_memory(CFlagType type,
+                              const void *memory,
+                              size_t size,
+                              const void **values_ptr)
+{
+    size_t element_size = c_flags_list_element_size(type);
+
+    if (size == 0) {
+        *values_ptr = NULL;
+        return true;
+    }
+
+    if (size < sizeof(CFlagsListHeader) || (size - sizeof(CFlagsListHeader)) % element_size)
+        return false;
+
+    const CFlagsListHeader *header = memory;
+    if (header->count == 0 || header->count != (size - sizeof(CFlagsListHeader)) / element_size)
+        return false;
+
+    *values_ptr = header + 1;
+    return true;
+}
+
+bool c_flags_list_allocate(CFlagType type, size_t count, void **values_ptr)
+{
+    size_t element_size = c_flags_list_element_size(type);
+
+    if (count > (SIZE_MAX - sizeof(CFlagsListHeader)) / element_size)
+        return false;
+
+    CFlagsListHeader *header = malloc(sizeof(CFlagsListHeader) + count * element_size);
+    if (header == NULL)
+        return false;
+
+    header->count = count;
+    *values_ptr = header + 1;
+
+    return true;
+}
+
+bool c_flags_list_copy(CFlagType type, const void *data, size_t count, const void **values_ptr)
+{
+    void *values = NULL;
+
+    if (count == 0) {
+        *values_ptr = NULL;
+        return true;
+    }
+
+    if (!c_flags_list_allocate(type, count, &values))
+        return false;
+
+    memcpy(values, data, count * c_flags_list_element_size(type));
+    *values_ptr = values;
+
+    return true;
+}
+
+static bool list_is_separator(char c)
+{
+    return c == ',' || c == ' ' || c == '\t' || c == '\n';
+}
+
+// assemble the word in string order, so the first byte is the lowest on any endianness
+static uint64_t list_load_word(const unsigned char *bytes)
+{
+    uint64_t word = 0;
+
+    for (size_t i = 0; i < sizeof(uint64_t); i++)
+        word |= (uint64_t) bytes[i] << (i * 8);
+
+    return word;
+}
+
+// high bit of every byte equal to the byte of the pattern, without carries between bytes
+static uint64_t list_match(uint64_t word, uint64_t pattern)
+{
+    uint64_t x = word ^ pattern;
+    return ~(((x & ~C_FLAGS_LIST_HIGHS) + ~C_FLAGS_LIST_HIGHS) | x) & C_FLAGS_LIST_HIGHS;
+}
+
+static uint64_t list_separators(uint64_t word)
+{
+    return list_match(word, ',' * C_FLAGS_LIST_ONES) | list_match(word, ' ' * C_FLAGS_LIST_ONES) |
+           list_match(word, '\t' * C_FLAGS_LIST_ONES) | list_match(word, '\n' * C_FLAGS_LIST_ONES);
+}
+
+#if defined(C_FLAGS_SSE2)
+static __m128i list_separators_sse2(__m128i chunk)
+{
+    __m128i commas = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(','));
+    __m128i spaces = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' '));
+    __m128i tabs = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'));
+    __m128i newlines = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'));
+
+    return _mm_or_si128(_mm_or_si128(commas, spaces), _mm_or_si128(tabs, newlines));
+}
+
+/*
+ * Count starts of elements sixteen bytes at a time, a byte is a start when it
+ * isn't a separator and the byte before it is. Returns the number of counted
+ * bytes, `previous_ptr` is updated with whether the last of them is a separator.
+ */
+static size_t list_count_vector(const unsigned char *bytes,
+                                size_t size,
+                                size_t *count_ptr,
+                                bool *previous_ptr)
+{
+    __m128i previous = _mm_set1_epi8(*previous_ptr ? -1 : 0);
+    __m128i ones = _mm_set1_epi8(1);
+    __m128i sums = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+        __m128i separators = list_separators_sse2(_mm_loadu_si128((const __m128i *) (bytes + i)));
+        __m128i before = _mm_or_si128(_mm_slli_si128(separators, 1), _mm_srli_si128(previous, 15));
+        __m128i starts = _mm_andnot_si128(separators, before);
+
+        // bytes of the starts are summed into two 64-bit halves
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_and_si128(starts, ones), _mm_setzero_si128()));
+        previous = separators;
+    }
+
+    uint64_t halves[2];
+    _mm_storeu_si128((__m128i *) halves, sums);
+
+    *count_ptr += (size_t) (halves[0] + halves[1]);
+    *previous_ptr = (_mm_movemask_epi8(previous) & 0x8000) != 0;
+
+    return i;
+}
+#elif defined(C_FLAGS_NEON)
+static uint8x16_t list_separators_neon(uint8x16_t chunk)
+{
+    uint8x16_t commas = vceqq_u8(chunk, vdupq_n_u8(','));
+    uint8x16_t spaces = vceqq_u8(chunk, vdupq_n_u8(' '));
+    uint8x16_t tabs = vceqq_u8(chunk, vdupq_n_u8('\t'));
+    uint8x16_t newlines = vceqq_u8(chunk, vdupq_n_u8('\n'));
+
+    return vorrq_u8(vorrq_u8(commas, spaces), vorrq_u8(tabs, newlines));
+}
+
+/*
+ * Count starts of elements sixteen bytes at a time, a byte is a start when it
+ * isn't a separator and the byte before it is. Returns the number of counted
+ * bytes, `previous_ptr` is updated with whether the last of them is a separator.
+ */
+static size_t list_count_vector(const unsigned char *bytes,
+                                size_t size,
+                                size_t *count_ptr,
+                                bool *previous_ptr)
+{
+    uint8x16_t previous = vdupq_n_u8(*previous_ptr ? 0xFF : 0);
+    size_t i = 0;
+
+    for (; i + sizeof(uint8x16_t) <= size; i += sizeof(uint8x16_t)) {
+        uint8x16_t separators = list_separators_neon(vld1q_u8(bytes + i));
+        uint8x16_t starts = vbicq_u8(vextq_u8(previous, separators, 15), separators);
+
+        *count_ptr += vaddvq_u8(vshrq_n_u8(starts, 7));
+        previous = separators;
+    }
+
+    *previous_ptr = vgetq_lane_u8(previous, 15) != 0;
+    return i;
+}
+#endif
+
+/*
+ * Elements are counted as bytes that start a run of non-separators, sixteen
+ * bytes at a time with vector kernels and eight bytes at a time with SWAR.
+ */
+size_t c_flags_list_count(const char *value, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *) value;
+    bool previous_separator = true;
+    size_t count = 0;
+    size_t i = 0;
+
+#if defined(C_FLAGS_SSE2) || defined(C_FLAGS_NEON)
+    i = list_count_vector(bytes, size, &count, &previous_separator);
+#endif
+
+    uint64_t previous = previous_separator ? C_FLAGS_LIST_HIGHS : 0;
+
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t separators = list_separators(list_load_word(bytes + i));
+        uint64_t starts = ~separators & C_FLAGS_LIST_HIGHS & ((separators << 8) | (previous >> 56));
+
+        count += (size_t) (((starts >> 7) * C_FLAGS_LIST_ONES) >> 56);
+        previous = separators;
+    }
+
+    previous_separator = (previous >> 63) != 0;
+
+    for (; i < size; i++) {
+        bool separator = list_is_separator(value[i]);
+
+        if (!separator && previous_separator)
+            count += 1;
+
+        previous_separator = separator;
+    }
+
+    return count;
+}
+
+static bool list_element_end(const char *end)
+{
+    return *end == '\0' || list_is_separator(*end);
+}
+
+static bool list_convert(CFlagType type, const char *text, void *values, size_t index)
+{
+    char *end = NULL;
+    errno = 0;
+
+    switch (type) {
+    case C_FLAG_INT32_LIST:
+    case C_FLAG_INT64_LIST: {
+        long long number = strtoll(text, &end, 10);
+
+        if (errno != 0 || end == text || !list_element_end(end))
+            return false;
+
+        if (type == C_FLAG_INT32_LIST) {
+            if (number < INT32_MIN || number > INT32_MAX)
+                return false;
+
+            ((int32_t *) values)[index] = (int32_t) number;
+        }
+        else {
+            ((int64_t *) values)[index] = (int64_t) number;
+        }
+
+        return true;
+    }
+    case C_FLAG_UINT32_LIST:
+    case C_FLAG_UINT64_LIST: {
+        unsigned long long number = strtoull(text, &end, 10);
+
+        if (errno != 0 || end == text || *text == '-' || !list_element_end(end))
+            return false;
+
+        if (type == C_FLAG_UINT32_LIST) {
+            if (number > UINT32_MAX)
+                return false;
+
+            ((uint32_t *) values)[index] = (uint32_t) number;
+        }
+        else {
+            ((uint64_t *) values)[index] = (uint64_t) number;
+        }
+
+        return true;
+    }
+    case C_FLAG_DOUBLE_LIST: {
+        double number = strtod(text, &end);
+
+        if (errno != 0 || end == text || !list_element_end(end))
+            return false;
+
+        ((double *) values)[index] = number;
+        return true;
+    }
+    default:
+        assert(false && "not all list types implements list_convert()");
+    }
+
+    return false;
+}
+
+/*
+ * Elements are separated by one comma with optional whitespace around it
+ * or by whitespace only, empty elements are invalid.
+ */
+bool c_flags_parse_list(CFlagType type,
+                        const char *value,
+                        const void **values_ptr,
+                        size_t *error_index_ptr)
+{
+    // the list is allocated with its final size
+    size_t count = c_flags_list_count(value, strlen(value));
+    void *values = NULL;
+
+    if (error_index_ptr != NULL)
+        *error_index_ptr = 0;
+
+    if (count == 0 && strchr(value, ',') == NULL) {
+        *values_ptr = NULL;
+        return true;
+    }
+
+    if (!c_flags_list_allocate(type, count, &values)) {
+        if (error_index_ptr != NULL)
+            *error_index_ptr = SIZE_MAX;
+        return false;
+    }
+
+    const char *text = value;
+    size_t index = 0;
+
+    while (true) {
+        while (*text != '\0' && *text != ',' && list_is_separator(*text))
+            text++;
+
+        // the element is missing before the comma or after the last comma
+        if (*text == ',' || (*text == '\0' && index > 0) || index == count ||
+            !list_convert(type, text, values, index)) {
+            break;
+        }
+
+        index += 1;
+
+        while (!list_element_end(text))
+            text++;
+        while (*text != '\0' && *text != ',' && list_is_separator(*text))
+            text++;
+
+        if (*text == '\0') {
+            *values_ptr = values;
+            return true;
+        }
+
+        if (*text == ',')
+            text++;
+    }
+
+    if (error_index_ptr != NULL)
+        *error_index_ptr = index;
+
+    free(list_header(values));
+    return false;
+}
+
+size_t c_flags_format_list(CFlagType type, const void *values, char *buffer, size_t size)
+{
+    if (type == C_FLAG_BINARY)
+        return c_flags_format_binary(values, buffer, size);
+
+    size_t count = c_flags_list_size(values);
+    size_t offset = 0;
+
+    if (size > 0)
+        buffer[0] = '\0';
+
+    for (size_t i = 0; i < count; i++) {
+        char *out = offset < size ? buffer + offset : NULL;
+        size_t out_size = offset < size ? size - offset : 0;
+        const char *separator = i > 0 ? "," : "";
+        int written = 0;
+
+        switch (type) {
+        case C_FLAG_INT32_LIST:
+            written =
+                snprintf(out, out_size, "%s%" PRId32, separator, ((const int32_t *) values)[i]);
+            break;
+        case C_FLAG_INT64_LIST:
+            written =
+                snprintf(out, out_size, "%s%" PRId64, separator, ((const int64_t *) values)[i]);
+            break;
+        case C_FLAG_UINT32_LIST:
+            written =
+                snprintf(out, out_size, "%s%" PRIu32, separator, ((const uint32_t *) values)[i]);
+            break;
+        case C_FLAG_UINT64_LIST:
+            written =
+                snprintf(out, out_size, "%s%" PRIu64, separator, ((const uint64_t *) values)[i]);
+            break;
+        case C_FLAG_DOUBLE_LIST:
+            written = snprintf(out, out_size, "%s%.17g", separator, ((const double *) values)[i]);
+            break;
+        default:
+            assert(false && "not all list types implements c_flags_format_list()");
+        }
+
+        offset += (size_t) written;
+    }
+
+    return offset;
+}
+
+static CFlag *list_declare(CFlagType type,
+                           const char *long_name,
+                           const char *short_name,
+                           const char *desc,
+                           const char *default_val,
+                           void *var)
+{
+    const void *values = NULL;
+    size_t error_index = 0;
+
+    if (default_val != NULL && !c_flags_parse_list(type, default_val, &values, &error_index)) {
+        assert(error_index == SIZE_MAX && "the default value must be a valid list");
+        return NULL;
+    }
+
+    CFlag *flag = c_flags_declare(type, long_name, short_name, desc, var);
+    flag->default_value.as_list = values;
+
+    c_flag_set_value(flag, flag->default_value);
+    return flag;
+}
+
+#define DECLARE_C_FLAG_LIST_IMPL(type, ptr_type, postfix)                                         \
+    const ptr_type **c_flag_##postfix##_list(const char *long_name,                               \
+                                             const char *short_name,                              \
+                                             const char *desc,                                    \
+                                             const char *default_val)                             \
+    {                                                                                             \
+        CFlag *flag = list_declare(type, long_name, short_name, desc, default_val, NULL);         \
+        if (flag == NULL)                                                                         \
+            return NULL;                                                                          \
+                                                                                                  \
+        return (const ptr_type **) flag->value;                                                   \
+    }                                                                                             \
+                                                                                                  \
+    bool c_flag_##postfix##_list_var(const ptr_type **var,                                        \
+                                     const char *long_name,                                       \
+                                     const char *short_name,                                      \
+                                     const char *desc,                                            \
+                                     const char *default_val)                                     \
+    {                                                                                             \
+        assert(var != NULL && "the variable is required and cannot be NULL");                     \
+                                                                                                  \
+        CFlag *flag = list_declare(type, long_name, short_name, desc, default_val, (void *) var); \
+        return flag != NULL;                                                                      \
+    }
+
+DECLARE_C_FLAG_LIST_IMPL(C_FLAG_INT32_LIST, int32_t, int32)
+DECLARE_C_FLAG_LIST_IMPL(C_FLAG_INT64_LIST, int64_t, int64)
+DECLARE_C_FLAG_LIST_IMPL(C_FLAG_UINT32_LIST, uint32_t, uint32)
+DECLARE_C_FLAG_LIST_IMPL(C_FLAG_UINT64_LIST, uint64_t, uint64)
+DECLARE_C_FLAG_LIST_IMPL(C_FLAG_DOUBLE_LIST, double, double)
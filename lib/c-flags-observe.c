@@ -0,0 +1,241 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <stdlib.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+
+typedef struct CFlagObserverEntry CFlagObserverEntry;
+
+/*
+ * Observer is identified by callback and user data pair,
+ * so that one observer subscribed to several flags
+ * receives a single notification per batch of changes.
+ */
+struct CFlagObserverEntry
+{
+    CFlagsObserver callback;
+    void *user_data;
+    CFlagObserverEntry *next;
+
+    // notification state of the current batch
+    unsigned notify_stamp;
+    CFlagObserverEntry *next_pending;
+    const void **changed;
+    size_t changed_size;
+    size_t changed_capacity;
+
+    // changed flags never outnumber subscriptions, so notification doesn't allocate
+    size_t subscriptions_size;
+};
+
+struct CFlagSubscription
+{
+    CFlagObserverEntry *observer;
+    CFlagSubscription *next;
+};
+
+static CFlagObserverEntry *observers = NULL;
+static CFlagObserverEntry *global_observers = NULL;
+
+static unsigned notify_stamp = 0;
+static bool notifying = false;
+
+#if defined(__linux__)
+/*
+ * Notifications run without the flags lock, so observers can read flags,
+ * they are serialized by the error checking mutex, which reports an
+ * observer changing flags instead of deadlocking.
+ */
+static pthread_mutex_t notify_lock;
+static pthread_once_t notify_lock_once = PTHREAD_ONCE_INIT;
+
+static void notify_lock_init(void)
+{
+    pthread_mutexattr_t attributes;
+
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_ERRORCHECK);
+    pthread_mutex_init(&notify_lock, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+}
+#endif
+
+static bool notify_begin(void)
+{
+#if defined(__linux__)
+    pthread_once(&notify_lock_once, notify_lock_init);
+    return pthread_mutex_lock(&notify_lock) == 0;
+#else
+    return !notifying;
+#endif
+}
+
+static void notify_end(void)
+{
+#if defined(__linux__)
+    pthread_mutex_unlock(&notify_lock);
+#endif
+}
+
+static CFlagObserverEntry *find_or_create_observer(CFlagsObserver callback,
+                                                   void *user_data,
+                                                   bool global)
+{
+    CFlagObserverEntry **head = global ? &global_observers : &observers;
+
+    for (CFlagObserverEntry *observer = *head; observer != NULL; observer = observer->next) {
+        if (observer->callback == callback && observer->user_data == user_data)
+            return observer;
+    }
+
+    CFlagObserverEntry *observer = calloc(1, sizeof(CFlagObserverEntry));
+    if (observer == NULL)
+        return NULL;
+
+    observer->callback = callback;
+    observer->user_data = user_data;
+    observer->next = *head;
+    *head = observer;
+
+    return observer;
+}
+
+static bool observer_reserve_changed(CFlagObserverEntry *observer, size_t size)
+{
+    if (size <= observer->changed_capacity)
+        return true;
+
+    size_t capacity = observer->changed_capacity ? observer->changed_capacity * 2 : 4;
+    const void **grown = realloc((void *) observer->changed, capacity * sizeof(void *));
+    if (grown == NULL)
+        return false;
+
+    observer->changed = grown;
+    observer->changed_capacity = capacity;
+
+    return true;
+}
+
+bool c_flags_observe(const void *value, CFlagsObserver observer, void *user_data)
+{
+    assert(observer != NULL && "observer callback cannot be NULL");
+    assert(!notifying && "observers cannot be changed during notification");
+
+    CFlag *flag = c_flags_find_by_data(value);
+    assert(flag != NULL && "value must be a pointer returned by c_flag_* function");
+
+    CFlagObserverEntry *entry = find_or_create_observer(observer, user_data, false);
+    if (entry == NULL)
+        return false;
+
+    for (CFlagSubscription *subscription = flag->subscriptions; subscription != NULL;
+         subscription = subscription->next) {
+        if (subscription->observer == entry)
+            return true;
+    }
+
+    if (!observer_reserve_changed(entry, entry->subscriptions_size + 1))
+        return false;
+
+    CFlagSubscription *subscription = malloc(sizeof(CFlagSubscription));
+    if (subscription == NULL)
+        return false;
+
+    entry->subscriptions_size += 1;
+    subscription->observer = entry;
+    subscription->next = flag->subscriptions;
+    flag->subscriptions = subscription;
+
+    return true;
+}
+
+bool c_flags_observe_all(CFlagsObserver observer, void *user_data)
+{
+    assert(observer != NULL && "observer callback cannot be NULL");
+    assert(!notifying && "observers cannot be changed during notification");
+
+    return find_or_create_observer(observer, user_data, true) != NULL;
+}
+
+void c_flags_unobserve_all(CFlagsObserver callback, void *user_data)
+{
+    assert(!notifying && "observers cannot be changed during notification");
+
+    for (CFlagObserverEntry **link = &global_observers; *link != NULL; link = &(*link)->next) {
+        CFlagObserverEntry *observer = *link;
+
+        if (observer->callback == callback && observer->user_data == user_data) {
+            *link = observer->next;
+
+            free((void *) observer->changed);
+            free(observer);
+            return;
+        }
+    }
+}
+
+void c_flags_notify(CFlag *const *changed, size_t count)
+{
+    static const void *changed_values[C_FLAGS_CAPACITY];
+
+    assert(count <= C_FLAGS_CAPACITY);
+
+    // values are already changed, observers changing flags aren't notified about their changes
+    if (!notify_begin()) {
+        assert(false && "flags cannot be changed from observer");
+        return;
+    }
+
+    notifying = true;
+    notify_stamp += 1;
+
+    CFlagObserverEntry *pending = NULL;
+
+    /*
+     * Collect changed flags per observer walking only subscriptions
+     * of the changed flags, the rest of the registry is not touched.
+     */
+    for (size_t i = 0; i < count; i++) {
+        const void *value = changed[i]->value;
+        changed_values[i] = value;
+
+        for (CFlagSubscription *subscription = changed[i]->subscriptions; subscription != NULL;
+             subscription = subscription->next) {
+            CFlagObserverEntry *observer = subscription->observer;
+
+            if (observer->notify_stamp != notify_stamp) {
+                observer->notify_stamp = notify_stamp;
+                observer->changed_size = 0;
+                observer->next_pending = pending;
+                pending = observer;
+            }
+
+            observer->changed[observer->changed_size++] = value;
+        }
+    }
+
+    for (CFlagObserverEntry *observer = pending; observer != NULL;
+         observer = observer->next_pending) {
+        if (observer->changed_size > 0)
+            observer->callback(observer->changed, observer->changed_size, observer->user_data);
+    }
+
+    for (CFlagObserverEntry *observer = global_observers; observer != NULL;
+         observer = observer->next) {
+        observer->callback(changed_values, count, observer->user_data);
+    }
+
+    notifying = false;
+    notify_end();
+}
@@ -0,0 +1,467 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+
+#define C_FLAGS_SHM_MAGIC   0x48534643U // "CFSH"
+#define C_FLAGS_SHM_VERSION 1U
+
+#define C_FLAGS_SHM_NULL_STRING UINT32_MAX
+
+/*
+ * Segment layout:
+ *
+ *  CFlagsShmHeader
+ *  CFlagsShmEntry[count]     - one entry per flag in declaration order
+ *  char[strings_capacity]    - terminated string values
+ *
+ * Entries and strings are protected with a seqlock: the sequence is odd
+ * while the master writes, readers retry when the sequence was changed.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t schema;
+    uint32_t sequence;
+    uint32_t count;
+    uint64_t strings_offset;
+    uint64_t strings_capacity;
+    uint64_t size;
+} CFlagsShmHeader;
+
+typedef struct
+{
+    uintmax_t data;
+    uint32_t string_offset;
+    uint32_t string_size;
+} CFlagsShmEntry;
+
+static int shm_fd = -1;
+static bool shm_master = false;
+static CFlagsShmHeader *shm_header = NULL;
+static uint32_t shm_synced_sequence = 0;
+
+static CFlagsShmEntry *shm_entries(const CFlagsShmHeader *header)
+{
+    return (CFlagsShmEntry *) ((char *) header + sizeof(CFlagsShmHeader));
+}
+
+static char *shm_strings(const CFlagsShmHeader *header)
+{
+    return (char *) header + header->strings_offset;
+}
+
+/*
+ * Pointers make no sense in other processes, so such values are stored
+ * after the entries: strings, CPU sets and paths of files as text, lists as
+ * their memory, accumulating flags as terminated elements.
+ */
+static bool shm_is_indirect(CFlagType type)
+{
+    return type == C_FLAG_STRING || type == C_FLAG_STRINGS || c_flags_is_reconverted(type) ||
+           c_flags_is_list(type);
+}
+
+static const void *shm_data(const CFlag *flag, char *buffer, size_t *size_ptr)
+{
+    CFlagValue value = c_flag_get_value(flag);
+    const char *text = value.as_string;
+
+    if (c_flags_is_list(flag->type)) {
+        const void *memory = c_flags_list_memory(flag->type, value.as_list, size_ptr);
+        return memory != NULL ? memory : "";
+    }
+
+    // elements are written directly into the segment
+    if (flag->type == C_FLAG_STRINGS) {
+        *size_ptr = c_flags_strings_memory(value.as_strings, NULL);
+        return "";
+    }
+
+    if (c_flags_is_reconverted(flag->type))
+        text = c_flag_format(flag, value, buffer, C_FLAGS_CPUS_FORMAT_SIZE);
+
+    if (text != NULL)
+        *size_ptr = strlen(text);
+
+    return text;
+}
+
+static size_t shm_strings_size(void)
+{
+    char buffer[C_FLAGS_CPUS_FORMAT_SIZE];
+    size_t size = 0;
+
+    for (size_t i = 0; i < c_flags_count(); i++) {
+        const CFlag *flag = c_flags_at(i);
+        size_t value_size = 0;
+
+        if (!shm_is_indirect(flag->type))
+            continue;
+
+        if (shm_data(flag, buffer, &value_size) != NULL)
+            size += value_size + 1;
+    }
+
+    return size;
+}
+
+static bool shm_write(void)
+{
+    if (shm_strings_size() > shm_header->strings_capacity)
+        return false;
+
+    CFlagsShmEntry *entries = shm_entries(shm_header);
+    char *strings = shm_strings(shm_header);
+    size_t strings_size = 0;
+    char text_buffer[C_FLAGS_CPUS_FORMAT_SIZE];
+
+    uint32_t sequence = shm_header->sequence;
+
+    __atomic_store_n(&shm_header->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    for (size_t i = 0; i < shm_header->count; i++) {
+        const CFlag *flag = c_flags_at(i);
+        CFlagsShmEntry *entry = &entries[i];
+
+        entry->data = c_flag_get_value(flag).raw;
+        entry->string_offset = 0;
+        entry->string_size = 0;
+
+        if (!shm_is_indirect(flag->type))
+            continue;
+
+        entry->data = 0;
+
+        size_t value_size = 0;
+        const void *value = shm_data(flag, text_buffer, &value_size);
+        if (value == NULL) {
+            entry->string_size = C_FLAGS_SHM_NULL_STRING;
+            continue;
+        }
+
+        if (flag->type == C_FLAG_STRINGS)
+            c_flags_strings_memory(c_flag_get_value(flag).as_strings, strings + strings_size);
+        else
+            memcpy(strings + strings_size, value, value_size);
+
+        strings[strings_size + value_size] = '\0';
+
+        entry->string_offset = (uint32_t) strings_size;
+        entry->string_size = (uint32_t) value_size;
+        strings_size += value_size + 1;
+    }
+
+    __atomic_store_n(&shm_header->sequence, sequence + 2, __ATOMIC_RELEASE);
+    return true;
+}
+
+static void shm_publish_observer(const void *const *changed, size_t changed_size, void *user_data)
+{
+    (void) changed;
+    (void) changed_size;
+    (void) user_data;
+
+    if (!shm_master || shm_header == NULL)
+        return;
+
+    // workers keep previous values of all flags, so they never see a part of the change
+    if (!c_flags_shm_publish())
+        printf("ERROR: string values don't fit into shared memory, changes aren't published\n");
+}
+
+int c_flags_shm_create(const char *name)
+{
+    assert(shm_header == NULL && "shared memory segment is already opened");
+
+    if (name != NULL)
+        shm_fd = shm_open(name, O_CREAT | O_TRUNC | O_RDWR | O_CLOEXEC, 0600);
+    else
+        shm_fd = memfd_create("c-flags", 0);
+
+    if (shm_fd < 0)
+        return -1;
+
+    size_t count = c_flags_count();
+    size_t strings_offset = sizeof(CFlagsShmHeader) + count * sizeof(CFlagsShmEntry);
+
+    // leave room for string values changed at runtime
+    size_t strings_capacity = shm_strings_size() * 2;
+    if (strings_capacity < 4096)
+        strings_capacity = 4096;
+
+    size_t size = strings_offset + strings_capacity;
+
+    if (ftruncate(shm_fd, (off_t) size) < 0)
+        goto error;
+
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    if (memory == MAP_FAILED)
+        goto error;
+
+    shm_header = memory;
+    shm_header->magic = C_FLAGS_SHM_MAGIC;
+    shm_header->version = C_FLAGS_SHM_VERSION;
+    shm_header->schema = c_flags_schema_hash();
+    shm_header->sequence = 0;
+    shm_header->count = (uint32_t) count;
+    shm_header->strings_offset = strings_offset;
+    shm_header->strings_capacity = strings_capacity;
+    shm_header->size = size;
+
+    shm_master = true;
+
+    if (!c_flags_shm_publish() || !c_flags_observe_all(shm_publish_observer, NULL))
+        goto error;
+
+    return shm_fd;
+
+error:
+    c_flags_shm_close();
+    return -1;
+}
+
+bool c_flags_shm_publish(void)
+{
+    assert(shm_header != NULL && shm_master && "shared memory segment is not created");
+
+    c_flags_lock();
+    bool published = shm_write();
+    c_flags_unlock();
+
+    return published;
+}
+
+bool c_flags_shm_attach_fd(int fd)
+{
+    // a worker forked from the master inherits the writable mapping
+    if (shm_header != NULL && shm_master) {
+        c_flags_unobserve_all(shm_publish_observer, NULL);
+        munmap(shm_header, shm_header->size);
+
+        if (shm_fd != fd)
+            close(shm_fd);
+
+        shm_fd = -1;
+        shm_master = false;
+        shm_header = NULL;
+    }
+
+    assert(shm_header == NULL && "shared memory segment is already opened");
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t) st.st_size < sizeof(CFlagsShmHeader))
+        return false;
+
+    void *memory = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED)
+        return false;
+
+    const CFlagsShmHeader *header = memory;
+
+    // entries and strings are copied as one block, that must end with the mapping
+    uint64_t strings_offset =
+        sizeof(CFlagsShmHeader) + (uint64_t) header->count * sizeof(CFlagsShmEntry);
+
+    if (header->magic != C_FLAGS_SHM_MAGIC || header->version != C_FLAGS_SHM_VERSION ||
+        header->schema != c_flags_schema_hash() || header->count != c_flags_count() ||
+        header->size != (uint64_t) st.st_size || header->strings_offset != strings_offset ||
+        strings_offset > header->size ||
+        header->strings_capacity != header->size - strings_offset) {
+        munmap(memory, (size_t) st.st_size);
+        return false;
+    }
+
+    shm_fd = fd;
+    shm_master = false;
+    shm_header = memory;
+    shm_synced_sequence = 0;
+
+    return true;
+}
+
+bool c_flags_shm_attach(const char *name)
+{
+    int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+
+    if (!c_flags_shm_attach_fd(fd)) {
+        close(fd);
+        return false;
+    }
+
+    return true;
+}
+
+int c_flags_shm_sync(void)
+{
+    assert(shm_header != NULL && !shm_master && "shared memory segment is not attached");
+
+    size_t count = shm_header->count;
+    size_t strings_capacity = shm_header->strings_capacity;
+
+    uint32_t sequence = __atomic_load_n(&shm_header->sequence, __ATOMIC_ACQUIRE);
+    if (sequence == shm_synced_sequence)
+        return 0;
+
+    if (c_flags_is_frozen())
+        return -1;
+
+    // entries and strings are copied first, so that the master is never blocked
+    size_t copy_size = count * sizeof(CFlagsShmEntry) + strings_capacity;
+    char *copy = malloc(copy_size);
+    if (copy == NULL)
+        return -1;
+
+    for (;;) {
+        if (sequence & 1U) {
+            sequence = __atomic_load_n(&shm_header->sequence, __ATOMIC_ACQUIRE);
+            continue;
+        }
+
+        memcpy(copy, shm_entries(shm_header), copy_size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        uint32_t sequence_after = __atomic_load_n(&shm_header->sequence, __ATOMIC_RELAXED);
+        if (sequence_after == sequence)
+            break;
+
+        sequence = sequence_after;
+    }
+
+    const CFlagsShmEntry *entries = (const CFlagsShmEntry *) copy;
+    const char *strings = copy + count * sizeof(CFlagsShmEntry);
+
+    CFlagAssignment *assignments = calloc(count ? count : 1, sizeof(CFlagAssignment));
+    if (assignments == NULL) {
+        free(copy);
+        return -1;
+    }
+
+    size_t assignments_size = 0;
+    int changed = -1;
+
+    c_flags_files_begin();
+
+    for (size_t i = 0; i < count; i++) {
+        const CFlagsShmEntry *entry = &entries[i];
+        CFlagAssignment *assignment = &assignments[assignments_size++];
+
+        assignment->flag = c_flags_at(i);
+        assignment->value.raw = entry->data;
+
+        if (!shm_is_indirect(assignment->flag->type))
+            continue;
+
+        assignment->value.as_string = NULL;
+
+        if (entry->string_size == C_FLAGS_SHM_NULL_STRING) {
+            CFlagType type = assignment->flag->type;
+
+            if (type != C_FLAG_STRING && !c_flags_is_file(type))
+                goto cleanup;
+            continue;
+        }
+
+        if ((uint64_t) entry->string_offset + entry->string_size >= strings_capacity)
+            goto cleanup;
+
+        assignment->owned = malloc(entry->string_size + 1);
+        if (assignment->owned == NULL)
+            goto cleanup;
+
+        memcpy(assignment->owned, strings + entry->string_offset, entry->string_size);
+        ((char *) assignment->owned)[entry->string_size] = '\0';
+
+        assignment->value.as_string = assignment->owned;
+
+        // CPU sets and files are converted again and don't keep the text
+        if (c_flags_is_reconverted(assignment->flag->type)) {
+            bool converted =
+                c_flag_convert(assignment->flag, assignment->owned, &assignment->value);
+
+            free(assignment->owned);
+            assignment->owned = NULL;
+
+            if (!converted)
+                goto cleanup;
+        }
+
+        // accumulating flags index elements in their own allocation
+        if (assignment->flag->type == C_FLAG_STRINGS) {
+            bool copied = c_flags_strings_copy(assignment->owned,
+                                               entry->string_size,
+                                               &assignment->value.as_strings);
+
+            free(assignment->owned);
+            assignment->owned = NULL;
+
+            if (!copied)
+                goto cleanup;
+
+            assignment->owned = c_flag_value_allocation(assignment->flag, assignment->value);
+        }
+
+        // lists use the copy of their memory
+        if (c_flags_is_list(assignment->flag->type)) {
+            if (!c_flags_list_from_memory(assignment->flag->type,
+                                          assignment->owned,
+                                          entry->string_size,
+                                          &assignment->value.as_list)) {
+                goto cleanup;
+            }
+
+            if (assignment->value.as_list == NULL) {
+                free(assignment->owned);
+                assignment->owned = NULL;
+            }
+        }
+    }
+
+    changed = (int) c_flags_apply(assignments, assignments_size, C_FLAG_SOURCE_SHARED_MEMORY);
+    shm_synced_sequence = sequence;
+
+cleanup:
+    for (size_t i = 0; i < assignments_size; i++)
+        free(assignments[i].owned);
+
+    free(assignments);
+    free(copy);
+    c_flags_files_end();
+
+    return changed;
+}
+
+void c_flags_shm_close(void)
+{
+    if (shm_master)
+        c_flags_unobserve_all(shm_publish_observer, NULL);
+
+    if (shm_header != NULL)
+        munmap(shm_header, shm_header->size);
+
+    if (shm_fd != -1)
+        close(shm_fd);
+
+    shm_fd = -1;
+    shm_master = false;
+    shm_header = NULL;
+    shm_synced_sequence = 0;
+}
@@ -0,0 +1,478 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+
+#define C_FLAGS_SNAPSHOT_MAGIC   0x4E534643U // "CFSN"
+#define C_FLAGS_SNAPSHOT_VERSION 1U
+
+#define C_FLAGS_SNAPSHOT_NULL_STRING UINT32_MAX
+
+/*
+ * Snapshot layout, all references are offsets from the snapshot start:
+ *
+ *  CFlagsSnapshotHeader
+ *  CFlagsSnapshotEntry[count]   - one entry per flag in declaration order
+ *  char[]                       - terminated string values
+ *
+ * The checksum covers everything after the header.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t schema;
+    uint64_t checksum;
+    uint64_t size;
+    uint32_t count;
+    uint32_t reserved;
+} CFlagsSnapshotHeader;
+
+typedef struct
+{
+    uintmax_t data;
+    uint32_t string_offset;
+    uint32_t string_size;
+    uint32_t source;
+    uint32_t reserved;
+} CFlagsSnapshotEntry;
+
+// memory referenced by string values of the last loaded snapshot
+static void *snapshot_memory = NULL;
+static size_t snapshot_mapped_size = 0;
+
+// arrays of accumulating flag values that reference the snapshot memory
+static char **snapshot_arrays = NULL;
+
+static uint64_t snapshot_checksum(const unsigned char *data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    size_t i = 0;
+
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+
+        hash = (hash ^ word) * 1099511628211ULL;
+        hash ^= hash >> 29;
+    }
+
+    for (; i < size; i++)
+        hash = (hash ^ data[i]) * 1099511628211ULL;
+
+    return hash;
+}
+
+static size_t snapshot_strings_offset(size_t count)
+{
+    return sizeof(CFlagsSnapshotHeader) + count * sizeof(CFlagsSnapshotEntry);
+}
+
+/*
+ * Pointers make no sense in other processes, so such values are stored
+ * after the entries: strings, CPU sets and paths of files as text, lists as
+ * their memory aligned to be used in place, accumulating flags as terminated elements.
+ */
+static bool snapshot_is_indirect(CFlagType type)
+{
+    return type == C_FLAG_STRING || type == C_FLAG_STRINGS || c_flags_is_reconverted(type) ||
+           c_flags_is_list(type);
+}
+
+static const void *snapshot_data(const CFlag *flag, char *buffer, size_t *size_ptr)
+{
+    CFlagValue value = c_flag_get_value(flag);
+    const char *text = value.as_string;
+
+    if (c_flags_is_list(flag->type)) {
+        const void *memory = c_flags_list_memory(flag->type, value.as_list, size_ptr);
+        return memory != NULL ? memory : "";
+    }
+
+    // elements are written directly into the snapshot
+    if (flag->type == C_FLAG_STRINGS) {
+        *size_ptr = c_flags_strings_memory(value.as_strings, NULL);
+        return "";
+    }
+
+    if (c_flags_is_reconverted(flag->type))
+        text = c_flag_format(flag, value, buffer, C_FLAGS_CPUS_FORMAT_SIZE);
+
+    if (text != NULL)
+        *size_ptr = strlen(text);
+
+    return text;
+}
+
+// offset of the value after the entries, the strings offset is aligned as well
+static size_t snapshot_align(CFlagType type, size_t offset)
+{
+    if (!c_flags_is_list(type))
+        return offset;
+
+    return (offset + C_FLAGS_LIST_ALIGNMENT - 1) / C_FLAGS_LIST_ALIGNMENT * C_FLAGS_LIST_ALIGNMENT;
+}
+
+size_t c_flags_snapshot_size(void)
+{
+    char buffer[C_FLAGS_CPUS_FORMAT_SIZE];
+    size_t size = snapshot_strings_offset(c_flags_count());
+
+    for (size_t i = 0; i < c_flags_count(); i++) {
+        const CFlag *flag = c_flags_at(i);
+        size_t value_size = 0;
+
+        if (!snapshot_is_indirect(flag->type))
+            continue;
+
+        if (snapshot_data(flag, buffer, &value_size) != NULL)
+            size = snapshot_align(flag->type, size) + value_size + 1;
+    }
+
+    return size;
+}
+
+size_t c_flags_snapshot_write(void *buffer, size_t size)
+{
+    c_flags_lock();
+
+    size_t count = c_flags_count();
+    size_t snapshot_size = c_flags_snapshot_size();
+
+    if (size < snapshot_size) {
+        c_flags_unlock();
+        return 0;
+    }
+
+    unsigned char *snapshot = buffer;
+    CFlagsSnapshotEntry *entries =
+        (CFlagsSnapshotEntry *) (snapshot + sizeof(CFlagsSnapshotHeader));
+    char *strings = (char *) snapshot + snapshot_strings_offset(count);
+    size_t strings_size = 0;
+    char text_buffer[C_FLAGS_CPUS_FORMAT_SIZE];
+
+    for (size_t i = 0; i < count; i++) {
+        const CFlag *flag = c_flags_at(i);
+        CFlagsSnapshotEntry *entry = &entries[i];
+
+        memset(entry, 0, sizeof(CFlagsSnapshotEntry));
+        entry->data = c_flag_get_value(flag).raw;
+        entry->source = (uint32_t) flag->source;
+
+        if (!snapshot_is_indirect(flag->type))
+            continue;
+
+        entry->data = 0;
+
+        size_t value_size = 0;
+        const void *value = snapshot_data(flag, text_buffer, &value_size);
+        if (value == NULL) {
+            entry->string_size = C_FLAGS_SNAPSHOT_NULL_STRING;
+            continue;
+        }
+
+        size_t aligned_size = snapshot_align(flag->type, strings_size);
+        memset(strings + strings_size, 0, aligned_size - strings_size);
+        strings_size = aligned_size;
+
+        if (flag->type == C_FLAG_STRINGS)
+            c_flags_strings_memory(c_flag_get_value(flag).as_strings, strings + strings_size);
+        else
+            memcpy(strings + strings_size, value, value_size);
+
+        strings[strings_size + value_size] = '\0';
+
+        entry->string_offset = (uint32_t) strings_size;
+        entry->string_size = (uint32_t) value_size;
+        strings_size += value_size + 1;
+    }
+
+    c_flags_unlock();
+
+    CFlagsSnapshotHeader header = {
+        .magic = C_FLAGS_SNAPSHOT_MAGIC,
+        .version = C_FLAGS_SNAPSHOT_VERSION,
+        .schema = c_flags_schema_hash(),
+        .checksum = snapshot_checksum(snapshot + sizeof(CFlagsSnapshotHeader),
+                                      snapshot_size - sizeof(CFlagsSnapshotHeader)),
+        .size = snapshot_size,
+        .count = (uint32_t) count,
+        .reserved = 0,
+    };
+
+    memcpy(snapshot, &header, sizeof(header));
+    return snapshot_size;
+}
+
+static bool snapshot_valid(const unsigned char *snapshot, size_t size)
+{
+    CFlagsSnapshotHeader header;
+
+    if (size < sizeof(header))
+        return false;
+
+    memcpy(&header, snapshot, sizeof(header));
+
+    if (header.magic != C_FLAGS_SNAPSHOT_MAGIC || header.version != C_FLAGS_SNAPSHOT_VERSION ||
+        header.schema != c_flags_schema_hash() || header.count != c_flags_count() ||
+        header.size != size || size < snapshot_strings_offset(header.count)) {
+        return false;
+    }
+
+    if (header.checksum != snapshot_checksum(snapshot + sizeof(header), size - sizeof(header)))
+        return false;
+
+    const CFlagsSnapshotEntry *entries =
+        (const CFlagsSnapshotEntry *) (snapshot + sizeof(CFlagsSnapshotHeader));
+    const char *strings = (const char *) snapshot + snapshot_strings_offset(header.count);
+    size_t strings_size = size - snapshot_strings_offset(header.count);
+
+    for (size_t i = 0; i < header.count; i++) {
+        const CFlagsSnapshotEntry *entry = &entries[i];
+        const CFlag *flag = c_flags_at(i);
+
+        bool nullable = flag->type == C_FLAG_STRING || c_flags_is_file(flag->type);
+
+        if (entry->source > C_FLAG_SOURCE_SHARED_MEMORY)
+            return false;
+
+        if (!snapshot_is_indirect(flag->type) ||
+            (nullable && entry->string_size == C_FLAGS_SNAPSHOT_NULL_STRING)) {
+            continue;
+        }
+
+        if ((uint64_t) entry->string_offset + entry->string_size >= strings_size)
+            return false;
+
+        // lists are used in place
+        const void *values = NULL;
+        if (c_flags_is_list(flag->type) &&
+            (snapshot_align(flag->type, entry->string_offset) != entry->string_offset ||
+             !c_flags_list_from_memory(flag->type,
+                                       strings + entry->string_offset,
+                                       entry->string_size,
+                                       &values))) {
+            return false;
+        }
+
+        if (flag->type == C_FLAG_STRINGS && entry->string_size > 0 &&
+            strings[entry->string_offset + entry->string_size - 1] != '\0') {
+            return false;
+        }
+
+        // strings are used in place and reconverted values are parsed, so they're terminated
+        bool terminated = strings[entry->string_offset + entry->string_size] == '\0';
+        if ((flag->type == C_FLAG_STRING || c_flags_is_reconverted(flag->type)) && !terminated)
+            return false;
+
+        // CPU sets and files are converted again, so CPUs must still be online
+        // and files must still exist
+        CFlagValue value;
+        if (c_flags_is_reconverted(flag->type) &&
+            !c_flag_convert(flag, strings + entry->string_offset, &value)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// number of pointers in arrays of accumulating flag values with their NULL terminators
+static size_t snapshot_arrays_size(const unsigned char *snapshot)
+{
+    size_t count = c_flags_count();
+    size_t size = 0;
+
+    const CFlagsSnapshotEntry *entries =
+        (const CFlagsSnapshotEntry *) (snapshot + sizeof(CFlagsSnapshotHeader));
+    const char *strings = (const char *) snapshot + snapshot_strings_offset(count);
+
+    for (size_t i = 0; i < count; i++) {
+        if (c_flags_at(i)->type == C_FLAG_STRINGS) {
+            size += c_flags_strings_index(strings + entries[i].string_offset,
+                                          entries[i].string_size,
+                                          NULL) +
+                    1;
+        }
+    }
+
+    return size;
+}
+
+/*
+ * Values are loaded in place, string and list values reference the passed memory,
+ * that must stay alive while the flags are used. Arrays of accumulating flag values
+ * are taken from `arrays` sized with `snapshot_arrays_size()`.
+ */
+static void snapshot_apply(const unsigned char *snapshot, char **arrays)
+{
+    size_t count = c_flags_count();
+
+    const CFlagsSnapshotEntry *entries =
+        (const CFlagsSnapshotEntry *) (snapshot + sizeof(CFlagsSnapshotHeader));
+    const char *strings = (const char *) snapshot + snapshot_strings_offset(count);
+
+    c_flags_files_begin();
+
+    for (size_t i = 0; i < count; i++) {
+        const CFlagsSnapshotEntry *entry = &entries[i];
+        CFlag *flag = c_flags_at(i);
+
+        free(flag->owned);
+        flag->owned = NULL;
+
+        CFlagValue value = {.raw = entry->data};
+        flag->source = (CFlagSource) entry->source;
+
+        if (flag->type == C_FLAG_STRING) {
+            value.as_string = (entry->string_size == C_FLAGS_SNAPSHOT_NULL_STRING)
+                                  ? NULL
+                                  : (char *) strings + entry->string_offset;
+        }
+        else if (c_flags_is_reconverted(flag->type) &&
+                 entry->string_size != C_FLAGS_SNAPSHOT_NULL_STRING) {
+            c_flag_convert(flag, strings + entry->string_offset, &value);
+        }
+        else if (c_flags_is_list(flag->type)) {
+            c_flags_list_from_memory(flag->type,
+                                     strings + entry->string_offset,
+                                     entry->string_size,
+                                     &value.as_list);
+        }
+        else if (flag->type == C_FLAG_STRINGS) {
+            value.as_strings = arrays;
+            arrays += c_flags_strings_index(strings + entry->string_offset,
+                                            entry->string_size,
+                                            arrays) +
+                      1;
+        }
+
+        c_flag_set_value(flag, value);
+    }
+
+    c_flags_files_end();
+}
+
+static void snapshot_release(void)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    if (snapshot_mapped_size > 0) {
+        munmap(snapshot_memory, snapshot_mapped_size);
+        snapshot_memory = NULL;
+        snapshot_mapped_size = 0;
+    }
+#endif
+
+    free(snapshot_memory);
+    snapshot_memory = NULL;
+
+    free(snapshot_arrays);
+    snapshot_arrays = NULL;
+}
+
+static bool snapshot_alloc_arrays(const unsigned char *snapshot, char ***arrays_ptr)
+{
+    size_t size = snapshot_arrays_size(snapshot);
+
+    *arrays_ptr = NULL;
+    if (size == 0)
+        return true;
+
+    *arrays_ptr = malloc(size * sizeof(char *));
+    return *arrays_ptr != NULL;
+}
+
+bool c_flags_snapshot_load(const void *buffer, size_t size)
+{
+    if (c_flags_is_frozen() || !snapshot_valid(buffer, size))
+        return false;
+
+    char **arrays = NULL;
+    if (!snapshot_alloc_arrays(buffer, &arrays))
+        return false;
+
+    void *memory = malloc(size);
+    if (memory == NULL) {
+        free(arrays);
+        return false;
+    }
+
+    memcpy(memory, buffer, size);
+
+    c_flags_lock();
+
+    snapshot_release();
+    snapshot_memory = memory;
+    snapshot_arrays = arrays;
+    snapshot_apply(memory, arrays);
+
+    c_flags_unlock();
+    return true;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+bool c_flags_snapshot_write_fd(int fd)
+{
+    size_t size = c_flags_snapshot_size();
+    unsigned char *snapshot = malloc(size);
+
+    if (snapshot == NULL)
+        return false;
+
+    size = c_flags_snapshot_write(snapshot, size);
+
+    size_t written = 0;
+    while (size > 0 && written < size) {
+        ssize_t result = write(fd, snapshot + written, size - written);
+        if (result <= 0)
+            break;
+
+        written += (size_t) result;
+    }
+
+    free(snapshot);
+    return size > 0 && written == size;
+}
+
+bool c_flags_snapshot_load_fd(int fd)
+{
+    struct stat st;
+    if (c_flags_is_frozen() || fstat(fd, &st) < 0 || st.st_size <= 0)
+        return false;
+
+    size_t size = (size_t) st.st_size;
+
+    void *memory = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (memory == MAP_FAILED)
+        return false;
+
+    char **arrays = NULL;
+    if (!snapshot_valid(memory, size) || !snapshot_alloc_arrays(memory, &arrays)) {
+        munmap(memory, size);
+        return false;
+    }
+
+    c_flags_lock();
+
+    snapshot_release();
+    snapshot_memory = memory;
+    snapshot_mapped_size = size;
+    snapshot_arrays = arrays;
+    snapshot_apply(memory, arrays);
+
+    c_flags_unlock();
+    return true;
+}
+#endif
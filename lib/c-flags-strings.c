@@ -0,0 +1,281 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+
+typedef struct
+{
+    CFlag *flag;
+    char *value;
+} CFlagsOccurrence;
+
+typedef struct CFlagsArena CFlagsArena;
+
+/*
+ * Arena of one parse, allocated at once right after the header:
+ *
+ *  CFlagsOccurrence[capacity]          - occurrences in the order of arguments
+ *  char *[capacity + accumulating]     - NULL-terminated arrays of flag values
+ *
+ * Every occurrence takes at least one argument, so `argc` occurrences are enough.
+ */
+struct CFlagsArena
+{
+    CFlagsArena *next;
+    size_t size;
+    size_t capacity;
+    CFlagsOccurrence *occurrences;
+    char **arrays;
+    size_t arrays_size;
+};
+
+static char *empty_strings[] = {NULL};
+
+// arena of the running parse and arenas of previous parses referenced by values
+static CFlagsArena *parse_arena = NULL;
+static CFlagsArena *arenas = NULL;
+
+bool c_flags_strings_begin(int argc)
+{
+    size_t accumulating = 0;
+
+    for (size_t i = 0; i < c_flags_count(); i++)
+        accumulating += c_flags_at(i)->type == C_FLAG_STRINGS;
+
+    parse_arena = NULL;
+
+    // programs without accumulating flags don't allocate anything
+    if (accumulating == 0)
+        return true;
+
+    size_t capacity = argc > 0 ? (size_t) argc : 0;
+    size_t arrays_size = capacity + accumulating;
+
+    CFlagsArena *arena = malloc(sizeof(CFlagsArena) + capacity * sizeof(CFlagsOccurrence) +
+                                arrays_size * sizeof(char *));
+    if (arena == NULL)
+        return false;
+
+    arena->next = NULL;
+    arena->size = 0;
+    arena->capacity = capacity;
+    arena->occurrences = (CFlagsOccurrence *) (arena + 1);
+    arena->arrays = (char **) (arena->occurrences + capacity);
+    arena->arrays_size = arrays_size;
+
+    parse_arena = arena;
+    return true;
+}
+
+void c_flags_strings_collect(CFlag *flag, char *value)
+{
+    assert(parse_arena != NULL && "accumulating flags are collected only while parsing");
+    assert(parse_arena->size < parse_arena->capacity && "more occurrences than arguments");
+
+    parse_arena->occurrences[parse_arena->size].flag = flag;
+    parse_arena->occurrences[parse_arena->size].value = value;
+    parse_arena->size += 1;
+}
+
+static bool arena_referenced(const CFlagsArena *arena)
+{
+    uintptr_t begin = (uintptr_t) arena->arrays;
+    uintptr_t end = (uintptr_t) (arena->arrays + arena->arrays_size);
+
+    for (size_t i = 0; i < c_flags_count(); i++) {
+        const CFlag *flag = c_flags_at(i);
+
+        if (flag->type != C_FLAG_STRINGS)
+            continue;
+
+        uintptr_t values = (uintptr_t) c_flag_get_value(flag).as_strings;
+        if (values >= begin && values < end)
+            return true;
+    }
+
+    return false;
+}
+
+void c_flags_strings_end(void)
+{
+    CFlagsArena *arena = parse_arena;
+    parse_arena = NULL;
+
+    if (arena == NULL)
+        return;
+
+    if (arena->size == 0) {
+        free(arena);
+        return;
+    }
+
+    size_t counts[C_FLAGS_CAPACITY] = {0};
+    size_t ends[C_FLAGS_CAPACITY];
+    const CFlag *first = c_flags_at(0);
+
+    for (size_t i = 0; i < arena->size; i++)
+        counts[arena->occurrences[i].flag - first] += 1;
+
+    // arrays follow each other in declaration order, occurrences keep their order
+    size_t offset = 0;
+    for (size_t i = 0; i < c_flags_count(); i++) {
+        ends[i] = offset;
+        offset += counts[i] > 0 ? counts[i] + 1 : 0;
+    }
+
+    for (size_t i = 0; i < arena->size; i++) {
+        size_t index = (size_t) (arena->occurrences[i].flag - first);
+        arena->arrays[ends[index]++] = arena->occurrences[i].value;
+    }
+
+    for (size_t i = 0; i < c_flags_count(); i++) {
+        if (counts[i] == 0)
+            continue;
+
+        CFlag *flag = c_flags_at(i);
+        CFlagValue value = {.raw = 0};
+
+        arena->arrays[ends[i]] = NULL;
+        value.as_strings = arena->arrays + ends[i] - counts[i];
+
+        free(flag->owned);
+        flag->owned = NULL;
+
+        c_flag_set_value(flag, value);
+        flag->source = C_FLAG_SOURCE_COMMAND_LINE;
+    }
+
+    arena->next = arenas;
+    arenas = arena;
+
+    // values replaced by this parse may be the last references to older arenas
+    CFlagsArena **link = &arenas->next;
+    while (*link != NULL) {
+        CFlagsArena *older = *link;
+
+        if (arena_referenced(older)) {
+            link = &older->next;
+            continue;
+        }
+
+        *link = older->next;
+        free(older);
+    }
+}
+
+size_t c_flags_strings_memory(char *const *values, char *buffer)
+{
+    size_t size = 0;
+
+    for (; *values != NULL; values++) {
+        size_t value_size = strlen(*values) + 1;
+
+        if (buffer != NULL)
+            memcpy(buffer + size, *values, value_size);
+
+        size += value_size;
+    }
+
+    return size;
+}
+
+size_t c_flags_strings_index(const char *memory, size_t size, char **values)
+{
+    size_t count = 0;
+
+    for (size_t offset = 0; offset < size; count++) {
+        const char *value = memory + offset;
+        const char *end = memchr(value, '\0', size - offset);
+
+        if (values != NULL)
+            values[count] = (char *) value;
+
+        offset += (size_t) (end - value) + 1;
+    }
+
+    if (values != NULL)
+        values[count] = NULL;
+
+    return count;
+}
+
+bool c_flags_strings_copy(const char *memory, size_t size, char ***values_ptr)
+{
+    if (size == 0) {
+        *values_ptr = empty_strings;
+        return true;
+    }
+
+    if (memory[size - 1] != '\0')
+        return false;
+
+    size_t count = c_flags_strings_index(memory, size, NULL);
+    size_t array_size = (count + 1) * sizeof(char *);
+
+    char **values = malloc(array_size + size);
+    if (values == NULL)
+        return false;
+
+    char *copy = (char *) values + array_size;
+    memcpy(copy, memory, size);
+
+    c_flags_strings_index(copy, size, values);
+
+    *values_ptr = values;
+    return true;
+}
+
+const char *c_flags_format_strings(char *const *values, char *buffer, size_t size)
+{
+    size_t offset = 0;
+
+    buffer[0] = '\0';
+
+    for (size_t i = 0; values[i] != NULL && offset < size; i++) {
+        const char *separator = i > 0 ? "," : "";
+        offset += (size_t) snprintf(buffer + offset, size - offset, "%s%s", separator, values[i]);
+    }
+
+    return buffer;
+}
+
+static CFlag *strings_declare(const char *long_name,
+                              const char *short_name,
+                              const char *desc,
+                              char **default_val,
+                              void *var)
+{
+    CFlag *flag = c_flags_declare(C_FLAG_STRINGS, long_name, short_name, desc, var);
+
+    flag->default_value.as_strings = default_val != NULL ? default_val : empty_strings;
+    c_flag_set_value(flag, flag->default_value);
+
+    return flag;
+}
+
+char ***c_flag_strings(const char *long_name,
+                       const char *short_name,
+                       const char *desc,
+                       char **default_val)
+{
+    return (char ***) strings_declare(long_name, short_name, desc, default_val, NULL)->value;
+}
+
+void c_flag_strings_var(char ***var,
+                        const char *long_name,
+                        const char *short_name,
+                        const char *desc,
+                        char **default_val)
+{
+    assert(var != NULL && "the variable is required and cannot be NULL");
+
+    strings_declare(long_name, short_name, desc, default_val, (void *) var);
+}
@@ -0,0 +1,304 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "c-flags-internal.h"
+
+typedef struct
+{
+    const char *name;
+    uint64_t scale;
+} CFlagsUnit;
+
+#define C_FLAGS_KB 1000ULL
+#define C_FLAGS_MB (C_FLAGS_KB * 1000ULL)
+#define C_FLAGS_GB (C_FLAGS_MB * 1000ULL)
+#define C_FLAGS_TB (C_FLAGS_GB * 1000ULL)
+#define C_FLAGS_PB (C_FLAGS_TB * 1000ULL)
+#define C_FLAGS_EB (C_FLAGS_PB * 1000ULL)
+
+#define C_FLAGS_KIB 1024ULL
+#define C_FLAGS_MIB (C_FLAGS_KIB * 1024ULL)
+#define C_FLAGS_GIB (C_FLAGS_MIB * 1024ULL)
+#define C_FLAGS_TIB (C_FLAGS_GIB * 1024ULL)
+#define C_FLAGS_PIB (C_FLAGS_TIB * 1024ULL)
+#define C_FLAGS_EIB (C_FLAGS_PIB * 1024ULL)
+
+#define C_FLAGS_SECOND 1000000000ULL
+
+// suffixes are matched exactly, formatting uses units from the head of the table
+static const CFlagsUnit byte_units[] = {
+    {"EiB", C_FLAGS_EIB}, {"PiB", C_FLAGS_PIB}, {"TiB", C_FLAGS_TIB}, {"GiB", C_FLAGS_GIB},
+    {"MiB", C_FLAGS_MIB}, {"KiB", C_FLAGS_KIB}, {"EB", C_FLAGS_EB},   {"PB", C_FLAGS_PB},
+    {"TB", C_FLAGS_TB},   {"GB", C_FLAGS_GB},   {"MB", C_FLAGS_MB},   {"kB", C_FLAGS_KB},
+    {"B", 1},             {"", 1},              {"Ei", C_FLAGS_EIB},  {"Pi", C_FLAGS_PIB},
+    {"Ti", C_FLAGS_TIB},  {"Gi", C_FLAGS_GIB},  {"Mi", C_FLAGS_MIB},  {"Ki", C_FLAGS_KIB},
+    {"E", C_FLAGS_EB},    {"P", C_FLAGS_PB},    {"T", C_FLAGS_TB},    {"G", C_FLAGS_GB},
+    {"M", C_FLAGS_MB},    {"KB", C_FLAGS_KB},   {"K", C_FLAGS_KB},    {"e", C_FLAGS_EB},
+    {"p", C_FLAGS_PB},    {"t", C_FLAGS_TB},    {"g", C_FLAGS_GB},    {"m", C_FLAGS_MB},
+    {"k", C_FLAGS_KB},
+};
+
+// formatting uses units from the largest to the smallest
+static const CFlagsUnit duration_units[] = {
+    {"h", 3600 * C_FLAGS_SECOND},
+    {"m", 60 * C_FLAGS_SECOND},
+    {"s", C_FLAGS_SECOND},
+    {"ms", C_FLAGS_SECOND / 1000},
+    {"us", C_FLAGS_SECOND / 1000000},
+    {"ns", 1},
+    {"d", 86400 * C_FLAGS_SECOND},
+    {"\xC2\xB5s", C_FLAGS_SECOND / 1000000}, // µs
+};
+
+#define C_FLAGS_UNITS_SIZE(units) (sizeof(units) / sizeof((units)[0]))
+
+static const CFlagsUnit *unit_find(const CFlagsUnit *units,
+                                   size_t count,
+                                   const char *name,
+                                   size_t size)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (strlen(units[i].name) == size && !memcmp(units[i].name, name, size))
+            return &units[i];
+    }
+
+    return NULL;
+}
+
+static bool multiply_overflows(uint64_t a, uint64_t b, uint64_t *result_ptr)
+{
+    if (a != 0 && b > UINT64_MAX / a)
+        return true;
+
+    *result_ptr = a * b;
+    return false;
+}
+
+static bool add_overflows(uint64_t a, uint64_t b, uint64_t *result_ptr)
+{
+    if (b > UINT64_MAX - a)
+        return true;
+
+    *result_ptr = a + b;
+    return false;
+}
+
+static uint64_t gcd(uint64_t a, uint64_t b)
+{
+    while (b != 0) {
+        uint64_t r = a % b;
+        a = b;
+        b = r;
+    }
+
+    return a;
+}
+
+/*
+ * Parse `<digits>[.<digits>]` at the text start and multiply it by the scale
+ * in integers. Fractions must give a whole number of units after scaling.
+ */
+typedef struct
+{
+    uint64_t integer;
+    uint64_t fraction;
+    uint64_t denominator;
+} CFlagsDecimal;
+
+static const char *decimal_parse(const char *text, CFlagsDecimal *decimal)
+{
+    const char *start = text;
+
+    decimal->integer = 0;
+    decimal->fraction = 0;
+    decimal->denominator = 1;
+
+    for (; isdigit((unsigned char) *text); text++) {
+        uint64_t digit = (uint64_t) (*text - '0');
+
+        if (multiply_overflows(decimal->integer, 10, &decimal->integer) ||
+            add_overflows(decimal->integer, digit, &decimal->integer))
+            return NULL;
+    }
+
+    bool integer_digits = text != start;
+
+    if (*text == '.') {
+        text++;
+
+        const char *fraction_start = text;
+
+        for (; isdigit((unsigned char) *text); text++) {
+            // digits beyond the precision must be zeros
+            if (decimal->denominator > UINT64_MAX / 10) {
+                if (*text != '0')
+                    return NULL;
+                continue;
+            }
+
+            decimal->fraction = decimal->fraction * 10 + (uint64_t) (*text - '0');
+            decimal->denominator *= 10;
+        }
+
+        if (text == fraction_start)
+            return NULL;
+    }
+    else if (!integer_digits) {
+        return NULL;
+    }
+
+    return text;
+}
+
+static bool decimal_scale(const CFlagsDecimal *decimal, uint64_t scale, uint64_t *result_ptr)
+{
+    uint64_t result = 0;
+
+    if (multiply_overflows(decimal->integer, scale, &result))
+        return false;
+
+    if (decimal->fraction != 0) {
+        uint64_t divisor = gcd(decimal->fraction, decimal->denominator);
+        uint64_t fraction = decimal->fraction / divisor;
+        uint64_t denominator = decimal->denominator / divisor;
+
+        if (scale % denominator != 0)
+            return false;
+
+        uint64_t fraction_scaled = 0;
+
+        if (multiply_overflows(fraction, scale / denominator, &fraction_scaled) ||
+            add_overflows(result, fraction_scaled, &result))
+            return false;
+    }
+
+    *result_ptr = result;
+    return true;
+}
+
+bool c_flags_parse_bytes(const char *value, uint64_t *bytes_ptr)
+{
+    CFlagsDecimal decimal;
+
+    const char *suffix = decimal_parse(value, &decimal);
+    if (suffix == NULL)
+        return false;
+
+    const CFlagsUnit *unit = unit_find(byte_units,
+                                       C_FLAGS_UNITS_SIZE(byte_units),
+                                       suffix,
+                                       strlen(suffix));
+    if (unit == NULL)
+        return false;
+
+    return decimal_scale(&decimal, unit->scale, bytes_ptr);
+}
+
+bool c_flags_parse_duration(const char *value, int64_t *duration_ptr)
+{
+    bool negative = *value == '-';
+    if (*value == '-' || *value == '+')
+        value++;
+
+    uint64_t total = 0;
+
+    // special case of the duration without unit
+    if (!strcmp(value, "0")) {
+        *duration_ptr = 0;
+        return true;
+    }
+
+    if (*value == '\0')
+        return false;
+
+    while (*value != '\0') {
+        CFlagsDecimal decimal;
+
+        const char *unit_start = decimal_parse(value, &decimal);
+        if (unit_start == NULL)
+            return false;
+
+        const char *unit_end = unit_start;
+        while (*unit_end != '\0' && *unit_end != '.' && !isdigit((unsigned char) *unit_end))
+            unit_end++;
+
+        const CFlagsUnit *unit = unit_find(duration_units,
+                                           C_FLAGS_UNITS_SIZE(duration_units),
+                                           unit_start,
+                                           (size_t) (unit_end - unit_start));
+        uint64_t component = 0;
+
+        if (unit == NULL || !decimal_scale(&decimal, unit->scale, &component) ||
+            add_overflows(total, component, &total))
+            return false;
+
+        value = unit_end;
+    }
+
+    // the magnitude of INT64_MIN is representable only for negative durations
+    if (total > (uint64_t) INT64_MAX + (negative ? 1 : 0))
+        return false;
+
+    *duration_ptr = negative ? (int64_t) (0 - total) : (int64_t) total;
+    return true;
+}
+
+const char *c_flags_format_bytes(uint64_t bytes, char *buffer, size_t size)
+{
+    const CFlagsUnit *unit = NULL;
+
+    // the largest unit from the head of the table that divides the value
+    for (size_t i = 0; bytes != 0 && byte_units[i].scale != 1; i++) {
+        if (bytes % byte_units[i].scale == 0) {
+            unit = &byte_units[i];
+            break;
+        }
+    }
+
+    if (unit == NULL)
+        snprintf(buffer, size, "%llu", (unsigned long long) bytes);
+    else
+        snprintf(buffer, size, "%llu%s", (unsigned long long) (bytes / unit->scale), unit->name);
+
+    return buffer;
+}
+
+const char *c_flags_format_duration(int64_t duration, char *buffer, size_t size)
+{
+    uint64_t magnitude = duration < 0 ? 0 - (uint64_t) duration : (uint64_t) duration;
+    size_t offset = 0;
+
+    if (magnitude == 0) {
+        snprintf(buffer, size, "0s");
+        return buffer;
+    }
+
+    if (duration < 0)
+        offset += (size_t) snprintf(buffer, size, "-");
+
+    // units up to nanoseconds are at the head of the table
+    for (size_t i = 0; i < C_FLAGS_UNITS_SIZE(duration_units) && magnitude != 0; i++) {
+        const CFlagsUnit *unit = &duration_units[i];
+
+        if (magnitude < unit->scale)
+            continue;
+
+        if (offset < size) {
+            offset += (size_t) snprintf(buffer + offset,
+                                        size - offset,
+                                        "%llu%s",
+                                        (unsigned long long) (magnitude / unit->scale),
+                                        unit->name);
+        }
+
+        magnitude %= unit->scale;
+    }
+
+    return buffer;
+}
@@ -0,0 +1,425 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+// macOS hides the terminal size request in strict POSIX mode
+#define _DARWIN_C_SOURCE
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+#include "c-flags-internal.h"
+#include "c-flags.h"
+
+#define C_FLAGS_USAGE_DESCRIPTION_INDENT 3
+#define C_FLAGS_USAGE_FLAG_INDENT        20
+#define C_FLAGS_USAGE_ALLOWED_INDENT     16
+
+typedef struct
+{
+    char *data;
+    size_t size;
+    size_t capacity;
+    bool failed;
+} UsageBuffer;
+
+static unsigned usage_width = 0;
+
+// help rendered for the registry version and width
+static UsageBuffer usage_cache = {0};
+static unsigned usage_cache_version = 0;
+static unsigned usage_cache_width = 0;
+
+static void usage_append(UsageBuffer *buffer, const char *text, size_t size)
+{
+    if (buffer->failed)
+        return;
+
+    if (buffer->size + size + 1 > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 1024;
+        while (buffer->size + size + 1 > capacity)
+            capacity *= 2;
+
+        char *data = realloc(buffer->data, capacity);
+        if (data == NULL) {
+            buffer->failed = true;
+            return;
+        }
+
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+
+    memcpy(buffer->data + buffer->size, text, size);
+    buffer->size += size;
+    buffer->data[buffer->size] = '\0';
+}
+
+static void usage_append_string(UsageBuffer *buffer, const char *text)
+{
+    usage_append(buffer, text, strlen(text));
+}
+
+static void usage_append_indent(UsageBuffer *buffer, size_t indent)
+{
+    static const char spaces[] = "                                ";
+
+    while (indent > 0) {
+        size_t size = indent < sizeof(spaces) - 1 ? indent : sizeof(spaces) - 1;
+        usage_append(buffer, spaces, size);
+        indent -= size;
+    }
+}
+
+/*
+ * Append text starting at the column, words that don't fit the width are moved
+ * to the next line with the indent. Text is appended as is if width is 0.
+ */
+static void usage_append_wrapped(UsageBuffer *buffer,
+                                 const char *text,
+                                 size_t column,
+                                 size_t indent,
+                                 size_t width)
+{
+    if (width == 0) {
+        usage_append_string(buffer, text);
+        return;
+    }
+
+    bool line_start = true;
+
+    while (*text != '\0') {
+        if (*text == ' ') {
+            text++;
+            continue;
+        }
+
+        if (*text == '\n') {
+            usage_append_string(buffer, "\n");
+            usage_append_indent(buffer, indent);
+
+            column = indent;
+            line_start = true;
+            text++;
+            continue;
+        }
+
+        size_t word_size = strcspn(text, " \n");
+
+        if (!line_start && column + 1 + word_size > width) {
+            usage_append_string(buffer, "\n");
+            usage_append_indent(buffer, indent);
+            column = indent;
+        }
+        else if (!line_start) {
+            usage_append_string(buffer, " ");
+            column += 1;
+        }
+
+        usage_append(buffer, text, word_size);
+
+        column += word_size;
+        line_start = false;
+        text += word_size;
+    }
+}
+
+static const char *usage_default_to_str(const CFlag *flag, char *buffer, size_t size)
+{
+    switch (flag->type) {
+    case C_FLAG_INT:
+        snprintf(buffer, size, "%d", flag->default_value.as_int);
+        return buffer;
+    case C_FLAG_INT_8:
+        snprintf(buffer, size, "%" PRId8, flag->default_value.as_int8);
+        return buffer;
+    case C_FLAG_INT_16:
+        snprintf(buffer, size, "%" PRId16, flag->default_value.as_int16);
+        return buffer;
+    case C_FLAG_INT_32:
+        snprintf(buffer, size, "%" PRId32, flag->default_value.as_int32);
+        return buffer;
+    case C_FLAG_INT_64:
+        snprintf(buffer, size, "%" PRId64, flag->default_value.as_int64);
+        return buffer;
+    case C_FLAG_UNSIGNED:
+        snprintf(buffer, size, "%u", flag->default_value.as_unsigned);
+        return buffer;
+    case C_FLAG_UINT_8:
+        snprintf(buffer, size, "%" PRIu8, flag->default_value.as_uint8);
+        return buffer;
+    case C_FLAG_UINT_16:
+        snprintf(buffer, size, "%" PRIu16, flag->default_value.as_uint16);
+        return buffer;
+    case C_FLAG_UINT_32:
+        snprintf(buffer, size, "%" PRIu32, flag->default_value.as_uint32);
+        return buffer;
+    case C_FLAG_UINT_64:
+        snprintf(buffer, size, "%" PRIu64, flag->default_value.as_uint64);
+        return buffer;
+    case C_FLAG_SIZE_T:
+        snprintf(buffer, size, "%zu", flag->default_value.as_size_t);
+        return buffer;
+    case C_FLAG_BOOL:
+        return flag->default_value.as_bool ? "true" : "false";
+    case C_FLAG_STRING:
+        return flag->default_value.as_string;
+    case C_FLAG_FLOAT:
+        snprintf(buffer, size, "%f", flag->default_value.as_float);
+        return buffer;
+    case C_FLAG_DOUBLE:
+        snprintf(buffer, size, "%lf", flag->default_value.as_double);
+        return buffer;
+    case C_FLAG_BYTES:
+        return c_flags_format_bytes(flag->default_value.as_bytes, buffer, size);
+    case C_FLAG_DURATION:
+        return c_flags_format_duration(flag->default_value.as_duration, buffer, size);
+    case C_FLAG_CHOICE:
+        return c_flags_format_choice(flag->choices, flag->default_value.as_choice, buffer, size);
+    case C_FLAG_SET:
+        return c_flags_format_set(flag->choices, flag->default_value.as_set, buffer, size);
+#if defined(__linux__)
+    case C_FLAG_CPUS:
+        return c_flags_format_cpus(flag->default_value.as_cpus, buffer, size);
+#endif
+    case C_FLAG_INT32_LIST:
+    case C_FLAG_INT64_LIST:
+    case C_FLAG_UINT32_LIST:
+    case C_FLAG_UINT64_LIST:
+    case C_FLAG_DOUBLE_LIST:
+    case C_FLAG_BINARY:
+        c_flags_format_list(flag->type, flag->default_value.as_list, buffer, size);
+        return buffer;
+    case C_FLAG_COUNTER:
+        snprintf(buffer, size, "%u", flag->default_value.as_counter);
+        return buffer;
+    case C_FLAG_STRINGS:
+        if (flag->default_value.as_strings[0] == NULL)
+            return NULL;
+
+        return c_flags_format_strings(flag->default_value.as_strings, buffer, size);
+#if defined(__linux__)
+    case C_FLAG_PATH:
+    case C_FLAG_DIRECTORY:
+    case C_FLAG_FILE:
+    case C_FLAG_MAPPED_FILE:
+        return c_flag_format(flag, flag->default_value, buffer, size);
+#endif
+    default:
+        assert(false && "not all flag types implements usage_default_to_str()");
+    }
+
+    return "unreachable";
+}
+
+static void usage_render(UsageBuffer *buffer, size_t width)
+{
+    // enough for numbers printed with `%f` and for the names of set flags
+    char default_buffer[C_FLAGS_FORMAT_SIZE];
+
+    size_t visible_count = 0;
+    for (size_t i = 0; i < c_flags_count(); i++)
+        visible_count += !c_flags_at(i)->hidden;
+
+    const char *appname = c_flags_application_name();
+    const char *pos_args_desc = c_flags_positional_args_description();
+    const char *description = c_flags_description();
+
+    if (appname) {
+        usage_append_string(buffer, "USAGE:\n   ");
+        usage_append_string(buffer, appname);
+        usage_append_string(buffer, (visible_count > 0) ? " [OPTIONS] " : " ");
+        usage_append_string(buffer, pos_args_desc ? pos_args_desc : "");
+        usage_append_string(buffer, "\n\n");
+    }
+
+    if (description) {
+        usage_append_string(buffer, "DESCRIPTION:\n   ");
+        usage_append_wrapped(buffer,
+                             description,
+                             C_FLAGS_USAGE_DESCRIPTION_INDENT,
+                             C_FLAGS_USAGE_DESCRIPTION_INDENT,
+                             width);
+        usage_append_string(buffer, "\n\n");
+    }
+
+    // hidden flags aren't listed, so there are no options when all of them are hidden
+    if (visible_count > 0)
+        usage_append_string(buffer, "OPTIONS:");
+
+    for (size_t i = 0; i < c_flags_count(); i++) {
+        const CFlag *flag = c_flags_at(i);
+
+        if (flag->hidden)
+            continue;
+
+        usage_append_string(buffer, "\n   --");
+        usage_append_string(buffer, flag->long_name);
+
+        if (flag->short_name != NULL) {
+            usage_append_string(buffer, ", -");
+            usage_append_string(buffer, flag->short_name);
+        }
+
+        usage_append_string(buffer, "\n");
+
+        if (flag->desc != NULL) {
+            usage_append_string(buffer, "       Description: ");
+            usage_append_wrapped(buffer,
+                                 flag->desc,
+                                 C_FLAGS_USAGE_FLAG_INDENT,
+                                 C_FLAGS_USAGE_FLAG_INDENT,
+                                 width);
+            usage_append_string(buffer, "\n");
+        }
+
+        if (c_flags_format_choices(flag, ", ", default_buffer, sizeof(default_buffer)) != NULL) {
+            usage_append_string(buffer, "       Allowed: ");
+            usage_append_wrapped(buffer,
+                                 default_buffer,
+                                 C_FLAGS_USAGE_ALLOWED_INDENT,
+                                 C_FLAGS_USAGE_ALLOWED_INDENT,
+                                 width);
+            usage_append_string(buffer, "\n");
+        }
+
+        const char *default_val = usage_default_to_str(flag,
+                                                       default_buffer,
+                                                       sizeof(default_buffer));
+        if (default_val != NULL) {
+            usage_append_string(buffer, "       Default: ");
+            usage_append_string(buffer, default_val);
+            usage_append_string(buffer, "\n");
+        }
+    }
+}
+
+static unsigned terminal_width(int fd)
+{
+#if defined(_WIN32)
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    HANDLE handle = (HANDLE) _get_osfhandle(fd);
+
+    if (_isatty(fd) && GetConsoleScreenBufferInfo(handle, &info))
+        return (unsigned) (info.srWindow.Right - info.srWindow.Left + 1);
+#elif defined(TIOCGWINSZ)
+    struct winsize size;
+
+    if (isatty(fd) && ioctl(fd, TIOCGWINSZ, &size) == 0)
+        return size.ws_col;
+#else
+    (void) fd;
+#endif
+
+    return 0;
+}
+
+static const char *usage_text(unsigned width, size_t *size_ptr)
+{
+    if (usage_cache.data == NULL || usage_cache.failed ||
+        usage_cache_version != c_flags_registry_version() || usage_cache_width != width) {
+        usage_cache.size = 0;
+        usage_cache.failed = false;
+
+        usage_render(&usage_cache, width);
+
+        usage_cache_version = c_flags_registry_version();
+        usage_cache_width = width;
+    }
+
+    if (usage_cache.failed || usage_cache.data == NULL) {
+        *size_ptr = 0;
+        return NULL;
+    }
+
+    *size_ptr = usage_cache.size;
+    return usage_cache.data;
+}
+
+void c_flags_set_usage_width(unsigned width)
+{
+    usage_width = width;
+}
+
+const char *c_flags_usage_text(size_t *size_ptr)
+{
+    size_t size = 0;
+    const char *text = usage_text(usage_width, &size);
+
+    if (size_ptr != NULL)
+        *size_ptr = size;
+
+    return text;
+}
+
+void c_flags_usage_to_sink(CFlagsUsageSink sink, void *user_data)
+{
+    size_t size = 0;
+    const char *text = usage_text(usage_width, &size);
+
+    if (text != NULL)
+        sink(text, size, user_data);
+}
+
+void c_flags_usage_to_file(FILE *file)
+{
+    unsigned width = usage_width;
+
+#if defined(_WIN32)
+    if (width == 0)
+        width = terminal_width(_fileno(file));
+#else
+    if (width == 0)
+        width = terminal_width(fileno(file));
+#endif
+
+    size_t size = 0;
+    const char *text = usage_text(width, &size);
+
+    if (text != NULL)
+        fwrite(text, 1, size, file);
+}
+
+bool c_flags_usage_to_fd(int fd)
+{
+    unsigned width = usage_width ? usage_width : terminal_width(fd);
+
+    size_t size = 0;
+    const char *text = usage_text(width, &size);
+
+    if (text == NULL)
+        return false;
+
+    while (size > 0) {
+#if defined(_WIN32)
+        int written = _write(fd, text, (unsigned) size);
+#else
+        ssize_t written = write(fd, text, size);
+#endif
+        if (written <= 0)
+            return false;
+
+        text += written;
+        size -= (size_t) written;
+    }
+
+    return true;
+}
+
+void c_flags_usage(void)
+{
+    c_flags_usage_to_file(stdout);
+}
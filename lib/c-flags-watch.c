@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "c-flags.h"
+
+static int c_flags_watch_fd = -1;
+static char *c_flags_watch_path = NULL;
+static const char *c_flags_watch_filename = NULL;
+
+int c_flags_watch_config(const char *path)
+{
+    assert(path != NULL && "config path cannot be NULL");
+    assert(c_flags_watch_fd == -1 && "config is already watched");
+
+    size_t path_size = strlen(path);
+
+    /*
+     * The directory is watched instead of the file itself,
+     * so that editors and deploy tools that replace the config
+     * with `rename()` are noticed as well.
+     */
+    char *dir = malloc(path_size + 2);
+    c_flags_watch_path = malloc(path_size + 1);
+
+    if (dir == NULL || c_flags_watch_path == NULL)
+        goto error;
+
+    memcpy(c_flags_watch_path, path, path_size + 1);
+
+    char *slash = strrchr(c_flags_watch_path, '/');
+    if (slash == NULL) {
+        strcpy(dir, ".");
+        c_flags_watch_filename = c_flags_watch_path;
+    }
+    else {
+        size_t dir_size = (slash == c_flags_watch_path) ? 1 : (size_t) (slash - c_flags_watch_path);
+        memcpy(dir, c_flags_watch_path, dir_size);
+        dir[dir_size] = '\0';
+        c_flags_watch_filename = slash + 1;
+    }
+
+    c_flags_watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (c_flags_watch_fd < 0)
+        goto error;
+
+    if (inotify_add_watch(c_flags_watch_fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        goto error;
+
+    free(dir);
+    return c_flags_watch_fd;
+
+error:
+    free(dir);
+    c_flags_unwatch_config();
+
+    return -1;
+}
+
+int c_flags_watch_dispatch(void)
+{
+    assert(c_flags_watch_fd != -1 && "config is not watched");
+
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool config_changed = false;
+
+    /*
+     * Drain all pending events before reloading,
+     * so that a burst of writes results in a single reload.
+     */
+    for (;;) {
+        ssize_t size = read(c_flags_watch_fd, buffer, sizeof(buffer));
+
+        if (size < 0 && errno == EINTR)
+            continue;
+
+        if (size < 0 && errno == EAGAIN)
+            break;
+
+        if (size <= 0)
+            return -1;
+
+        for (char *ptr = buffer; ptr < buffer + size;) {
+            const struct inotify_event *event = (const struct inotify_event *) ptr;
+
+            if (event->len > 0 && !strcmp(event->name, c_flags_watch_filename))
+                config_changed = true;
+
+            ptr += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    if (!config_changed)
+        return 0;
+
+    return c_flags_load_config(c_flags_watch_path);
+}
+
+void c_flags_unwatch_config(void)
+{
+    if (c_flags_watch_fd != -1)
+        close(c_flags_watch_fd);
+
+    free(c_flags_watch_path);
+
+    c_flags_watch_fd = -1;
+    c_flags_watch_path = NULL;
+    c_flags_watch_filename = NULL;
+}
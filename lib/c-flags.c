@@ -6,54 +6,56 @@
 #include <assert.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+#include "c-flags-internal.h"
 #include "c-flags.h"
+#include "edit-distance.h"
 #include "string-view.h"
 
-#ifndef C_FLAGS_CAPACITY
-#define C_FLAGS_CAPACITY 64
-#endif
-
-typedef enum {
-    C_FLAG_INT,
-    C_FLAG_INT_8,
-    C_FLAG_INT_16,
-    C_FLAG_INT_32,
-    C_FLAG_INT_64,
-    C_FLAG_UNSIGNED,
-    C_FLAG_UINT_8,
-    C_FLAG_UINT_16,
-    C_FLAG_UINT_32,
-    C_FLAG_UINT_64,
-    C_FLAG_SIZE_T,
-    C_FLAG_BOOL,
-    C_FLAG_STRING,
-    C_FLAG_FLOAT,
-    C_FLAG_DOUBLE,
-} CFlagType;
+static CFlag flags[C_FLAGS_CAPACITY] = {0};
+static size_t flags_size = 0;
 
+/*
+ * Values read after parsing are kept apart from the metadata in dense slots,
+ * followed by the bitset of packed boolean flags. The storage occupies whole
+ * pages, so it can be made read-only by `c_flags_freeze()`.
+ */
 typedef struct
 {
-    CFlagType type;
-    const char *long_name;
-    const char *short_name;
-    const char *desc;
-    uintmax_t default_data;
-    uintmax_t data;
-} CFlag;
+    CFlagSlot slots[C_FLAGS_CAPACITY];
+    C_FLAGS_ALIGNED(C_FLAGS_CACHE_LINE_SIZE) uint64_t bits[(C_FLAGS_CAPACITY + 63) / 64];
+} CFlagsStorage;
 
-static CFlag flags[C_FLAGS_CAPACITY] = {0};
-static size_t flags_size = 0;
+#define C_FLAGS_STORAGE_PAGES ((sizeof(CFlagsStorage) + C_FLAGS_PAGE_SIZE - 1) / C_FLAGS_PAGE_SIZE)
+
+static C_FLAGS_ALIGNED(C_FLAGS_PAGE_SIZE) union {
+    CFlagsStorage storage;
+    unsigned char pages[C_FLAGS_STORAGE_PAGES * C_FLAGS_PAGE_SIZE];
+} value_storage = {0};
+
+#define flag_slots (value_storage.storage.slots)
+#define flag_bits  (value_storage.storage.bits)
+
+static unsigned flag_bits_size = 0;
+
+#if defined(__linux__)
+static pthread_mutex_t flags_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 static char *c_flags_appname_message = NULL;
 static char *c_flags_pos_args_desc = NULL;
 static char *c_flags_description_message = NULL;
 
-#define C_FLAG_DATA_AS_PTR(flag, ptr_type)         ((ptr_type *) (&((flag)->data)))
-#define C_FLAG_DEFAULT_DATA_AS_PTR(flag, ptr_type) ((ptr_type *) (&((flag)->default_data)))
+// changed when flags are declared or help messages are customized
+static unsigned registry_version = 0;
 
 // clang-format off
 #define C_FLAG_FILL(flag, _type, _long_name, _short_name, _desc) \
@@ -70,22 +72,29 @@ static char *c_flags_description_message = NULL;
                                const char *desc,                                            \
                                const ptr_type default_val)                                  \
     {                                                                                       \
-        assert(flags_size < C_FLAGS_CAPACITY && "exceeding the maximum number of flags, "   \
-                                                "please define C_FLAGS_CAPACITY according " \
-                                                "to your needs when compile");              \
-        assert(long_name != NULL && "the long name is required and cannot be NULL");        \
-        assert(flag_names_unique(long_name, short_name) && "flag names must be unique");    \
+        CFlag *flag = c_flags_declare(type, long_name, short_name, desc, NULL);             \
                                                                                             \
-        CFlag *flag = &flags[flags_size++];                                                 \
+        flag->default_value.as_##postfix = (ptr_type) default_val;                          \
+        *((ptr_type *) flag->value) = (ptr_type) default_val;                               \
                                                                                             \
-        C_FLAG_FILL(flag, type, long_name, short_name, desc)                                \
-        *C_FLAG_DEFAULT_DATA_AS_PTR(flag, ptr_type) = (ptr_type) default_val;               \
-        *C_FLAG_DATA_AS_PTR(flag, ptr_type) = (ptr_type) default_val;                       \
+        return (ptr_type *) flag->value;                                                    \
+    }                                                                                       \
                                                                                             \
-        return C_FLAG_DATA_AS_PTR(flag, ptr_type);                                          \
+    void c_flag_##postfix##_var(ptr_type *var,                                              \
+                                const char *long_name,                                      \
+                                const char *short_name,                                     \
+                                const char *desc,                                           \
+                                const ptr_type default_val)                                 \
+    {                                                                                       \
+        assert(var != NULL && "the variable is required and cannot be NULL");               \
+                                                                                            \
+        CFlag *flag = c_flags_declare(type, long_name, short_name, desc, var);              \
+                                                                                            \
+        flag->default_value.as_##postfix = (ptr_type) default_val;                          \
+        *var = (ptr_type) default_val;                                                      \
     }
 
-#define C_FLAG_LOAD_SIGNED_VALUE(flag, is_flag_long, ptr_type, value, usage_on_error)              \
+#define C_FLAG_CONVERT_SIGNED_VALUE(ptr_type, value, member)                                     \
 {                                                                                                  \
     char *end_ptr;                                                                                 \
     errno = 0;                                                                                     \
@@ -102,22 +111,14 @@ static char *c_flags_description_message = NULL;
     ptr_type min = (max) << (sizeof(ptr_type) * 8 - 1);                                            \
     (max) = ~(min);                                                                                \
                                                                                                    \
-    if (errno != 0 || !value_fully_parsed || number < (min) || number > (max)) {                   \
-        printf("ERROR: invalid value %s for " #ptr_type " flag %s%s\n",                            \
-               (value),                                                                            \
-               (is_flag_long) ? "--" : "-",                                                        \
-               (is_flag_long) ? (flag)->long_name : (flag)->short_name);                           \
-                                                                                                   \
-        if (usage_on_error)                                                                        \
-            c_flags_usage();                                                                       \
+    if (errno != 0 || !value_fully_parsed || number < (min) || number > (max))                     \
+        return false;                                                                              \
                                                                                                    \
-        exit(1);                                                                                   \
-    }                                                                                              \
-                                                                                                   \
-    *C_FLAG_DATA_AS_PTR(flag, ptr_type) = (ptr_type) number;                                       \
+    value_ptr->member = (ptr_type) number;                                                         \
+    return true;                                                                                   \
 }
 
-#define C_FLAG_LOAD_UNSIGNED_VALUE(flag, is_flag_long, ptr_type, value, usage_on_error)            \
+#define C_FLAG_CONVERT_UNSIGNED_VALUE(ptr_type, value, member)                                   \
 {                                                                                                  \
     char *end_ptr;                                                                                 \
     errno = 0;                                                                                     \
@@ -132,22 +133,14 @@ static char *c_flags_description_message = NULL;
     ptr_type max = 0;                                                                              \
     (max) = ~(max);                                                                                \
                                                                                                    \
-    if (errno != 0 || (value)[0] == '-' || !value_fully_parsed || number > (max)) {                \
-        printf("ERROR: invalid value %s for " #ptr_type " flag %s%s\n",                            \
-               (value),                                                                            \
-               (is_flag_long) ? "--" : "-",                                                        \
-               (is_flag_long) ? (flag)->long_name : (flag)->short_name);                           \
-                                                                                                   \
-        if (usage_on_error)                                                                        \
-            c_flags_usage();                                                                       \
+    if (errno != 0 || (value)[0] == '-' || !value_fully_parsed || number > (max))                  \
+        return false;                                                                              \
                                                                                                    \
-        exit(1);                                                                                   \
-    }                                                                                              \
-                                                                                                   \
-    *C_FLAG_DATA_AS_PTR(flag, ptr_type) = (ptr_type) number;                                       \
+    value_ptr->member = (ptr_type) number;                                                         \
+    return true;                                                                                   \
 }
 
-#define C_FLAG_LOAD_FLOATING_VALUE(flag, is_flag_long, ptr_type, value, strtox_fun, usage_on_error)\
+#define C_FLAG_CONVERT_FLOATING_VALUE(ptr_type, value, strtox_fun, member)                       \
 {                                                                                                  \
     char *end_ptr;                                                                                 \
     errno = 0;                                                                                     \
@@ -155,37 +148,107 @@ static char *c_flags_description_message = NULL;
     ptr_type number = strtox_fun(value, &end_ptr);                                                 \
     bool value_fully_parsed = (size_t) (end_ptr - (value)) == strlen(value);                       \
                                                                                                    \
-    if (errno != 0 || !value_fully_parsed) {                                                       \
-        printf("ERROR: invalid value %s for " #ptr_type " flag %s%s\n",                            \
-               (value),                                                                            \
-               (is_flag_long) ? "--" : "-",                                                        \
-               (is_flag_long) ? (flag)->long_name : (flag)->short_name);                           \
-                                                                                                   \
-        if (usage_on_error)                                                                        \
-            c_flags_usage();                                                                       \
+    if (errno != 0 || !value_fully_parsed)                                                         \
+        return false;                                                                              \
                                                                                                    \
-        exit(1);                                                                                   \
-    }                                                                                              \
-                                                                                                   \
-    *C_FLAG_DATA_AS_PTR(flag, ptr_type) = number;                                                  \
+    value_ptr->member = number;                                                                    \
+    return true;                                                                                   \
 }
 // clang-format on
 
-static bool flag_names_unique(const char *long_name, const char *short_name)
+/*
+ * Long and short names are indexed by open addressing tables with linear
+ * probing, entries hold indexes of flags plus one, so zero is an empty entry.
+ * Tables are twice as large as the registry, so probe sequences stay short
+ * and lookups don't depend on the number of declared flags.
+ */
+#define C_FLAGS_NAMES_INDEX_SIZE (2 * C_FLAGS_CAPACITY)
+
+static uint32_t long_names_index[C_FLAGS_NAMES_INDEX_SIZE] = {0};
+static uint32_t short_names_index[C_FLAGS_NAMES_INDEX_SIZE] = {0};
+
+static size_t names_index_hash(StringView name)
 {
-    for (size_t i = 0; i < flags_size; i++) {
-        CFlag *flag = &flags[i];
+    // FNV-1a
+    uint32_t hash = 2166136261U;
 
-        if (!strcmp(long_name, flag->long_name))
-            return false;
+    for (size_t i = 0; i < name.size; i++)
+        hash = (hash ^ (unsigned char) name.data[i]) * 16777619U;
 
-        if (short_name && flag->short_name && !strcmp(short_name, flag->short_name))
-            return false;
+    return (hash ^ (hash >> 16)) % C_FLAGS_NAMES_INDEX_SIZE;
+}
+
+/*
+ * Find the entry of the name in the index, or the empty entry where
+ * the name would be inserted.
+ */
+static uint32_t *names_index_entry(uint32_t *index, StringView name, bool short_names)
+{
+    size_t position = names_index_hash(name);
+
+    while (index[position] != 0) {
+        const CFlag *flag = &flags[index[position] - 1];
+        const char *flag_name = short_names ? flag->short_name : flag->long_name;
+
+        if (!strncmp(flag_name, name.data, name.size) && flag_name[name.size] == '\0')
+            return &index[position];
+
+        position = (position + 1) % C_FLAGS_NAMES_INDEX_SIZE;
     }
 
+    return &index[position];
+}
+
+static bool flag_names_unique(const char *long_name, const char *short_name)
+{
+    if (*names_index_entry(long_names_index, sv_from_string(long_name), false) != 0)
+        return false;
+
+    if (short_name && *names_index_entry(short_names_index, sv_from_string(short_name), true))
+        return false;
+
     return true;
 }
 
+// the first declared flag is found when names are repeated with disabled asserts
+static void names_index_insert(const CFlag *flag, uint32_t position)
+{
+    uint32_t *entry = names_index_entry(long_names_index, sv_from_string(flag->long_name), false);
+    if (*entry == 0)
+        *entry = position;
+
+    if (flag->short_name == NULL)
+        return;
+
+    entry = names_index_entry(short_names_index, sv_from_string(flag->short_name), true);
+    if (*entry == 0)
+        *entry = position;
+}
+
+CFlag *c_flags_declare(CFlagType type,
+                       const char *long_name,
+                       const char *short_name,
+                       const char *desc,
+                       void *var)
+{
+    assert(flags_size < C_FLAGS_CAPACITY && "exceeding the maximum number of flags, "
+                                            "please define C_FLAGS_CAPACITY according "
+                                            "to your needs when compile");
+    assert(long_name != NULL && "the long name is required and cannot be NULL");
+    assert(flag_names_unique(long_name, short_name) && "flag names must be unique");
+    assert(!c_flags_is_frozen() && "flags cannot be declared after c_flags_freeze()");
+
+    CFlag *flag = &flags[flags_size];
+    flag->value = var != NULL ? var : (void *) &flag_slots[flags_size].value;
+    flags_size += 1;
+    registry_version += 1;
+
+    C_FLAG_FILL(flag, type, long_name, short_name, desc)
+    names_index_insert(flag, (uint32_t) flags_size);
+
+    return flag;
+}
+
 DECLARE_C_FLAG_IMPL(C_FLAG_INT, int, int)
 DECLARE_C_FLAG_IMPL(C_FLAG_INT_8, int8_t, int8)
 DECLARE_C_FLAG_IMPL(C_FLAG_INT_16, int16_t, int16)
@@ -201,280 +264,1101 @@ DECLARE_C_FLAG_IMPL(C_FLAG_BOOL, bool, bool)
 DECLARE_C_FLAG_IMPL(C_FLAG_STRING, char *, string)
 DECLARE_C_FLAG_IMPL(C_FLAG_FLOAT, float, float)
 DECLARE_C_FLAG_IMPL(C_FLAG_DOUBLE, double, double)
+DECLARE_C_FLAG_IMPL(C_FLAG_BYTES, uint64_t, bytes)
+DECLARE_C_FLAG_IMPL(C_FLAG_DURATION, int64_t, duration)
+DECLARE_C_FLAG_IMPL(C_FLAG_COUNTER, unsigned, counter)
+
+CFlagsBit c_flag_bit(const char *long_name,
+                     const char *short_name,
+                     const char *desc,
+                     bool default_val)
+{
+    CFlag *flag = c_flags_declare(C_FLAG_BOOL, long_name, short_name, desc, NULL);
+
+    flag->packed = true;
+    flag->bit = flag_bits_size++;
+    flag->default_value.as_bool = default_val;
+    c_flag_set_value(flag, flag->default_value);
+
+    return flag->bit;
+}
+
+const uint64_t *c_flags_bits(void)
+{
+    return flag_bits;
+}
+
+bool c_flags_bit_of(const void *changed, CFlagsBit *bit_ptr)
+{
+    const CFlag *flag = c_flags_find_by_data(changed);
+    if (flag == NULL || !flag->packed)
+        return false;
+
+    *bit_ptr = flag->bit;
+    return true;
+}
+
+#define C_FLAGS_BIND_FIELD(postfix, ptr_type, config, field)                                     \
+    c_flag_##postfix##_var((ptr_type *) ((char *) (config) + (field)->offset),                    \
+                           (field)->long_name,                                                   \
+                           (field)->short_name,                                                  \
+                           (field)->desc,                                                        \
+                           *((ptr_type *) ((char *) (config) + (field)->offset)))
+
+void c_flags_bind_struct(void *config, const CFlagsField *fields, size_t count)
+{
+    assert(config != NULL && "the config is required and cannot be NULL");
+
+    for (size_t i = 0; i < count; i++) {
+        const CFlagsField *field = &fields[i];
+
+        switch (field->type) {
+        case C_FLAGS_FIELD_INT:
+            C_FLAGS_BIND_FIELD(int, int, config, field);
+            break;
+        case C_FLAGS_FIELD_INT8:
+            C_FLAGS_BIND_FIELD(int8, int8_t, config, field);
+            break;
+        case C_FLAGS_FIELD_INT16:
+            C_FLAGS_BIND_FIELD(int16, int16_t, config, field);
+            break;
+        case C_FLAGS_FIELD_INT32:
+            C_FLAGS_BIND_FIELD(int32, int32_t, config, field);
+            break;
+        case C_FLAGS_FIELD_INT64:
+            C_FLAGS_BIND_FIELD(int64, int64_t, config, field);
+            break;
+        case C_FLAGS_FIELD_UNSIGNED:
+            C_FLAGS_BIND_FIELD(unsigned, unsigned, config, field);
+            break;
+        case C_FLAGS_FIELD_UINT8:
+            C_FLAGS_BIND_FIELD(uint8, uint8_t, config, field);
+            break;
+        case C_FLAGS_FIELD_UINT16:
+            C_FLAGS_BIND_FIELD(uint16, uint16_t, config, field);
+            break;
+        case C_FLAGS_FIELD_UINT32:
+            C_FLAGS_BIND_FIELD(uint32, uint32_t, config, field);
+            break;
+        case C_FLAGS_FIELD_UINT64:
+            C_FLAGS_BIND_FIELD(uint64, uint64_t, config, field);
+            break;
+        case C_FLAGS_FIELD_SIZE_T:
+            C_FLAGS_BIND_FIELD(size_t, size_t, config, field);
+            break;
+        case C_FLAGS_FIELD_BOOL:
+            C_FLAGS_BIND_FIELD(bool, bool, config, field);
+            break;
+        case C_FLAGS_FIELD_STRING:
+            C_FLAGS_BIND_FIELD(string, char *, config, field);
+            break;
+        case C_FLAGS_FIELD_FLOAT:
+            C_FLAGS_BIND_FIELD(float, float, config, field);
+            break;
+        case C_FLAGS_FIELD_DOUBLE:
+            C_FLAGS_BIND_FIELD(double, double, config, field);
+            break;
+        case C_FLAGS_FIELD_BYTES:
+            C_FLAGS_BIND_FIELD(bytes, uint64_t, config, field);
+            break;
+        case C_FLAGS_FIELD_DURATION:
+            C_FLAGS_BIND_FIELD(duration, int64_t, config, field);
+            break;
+        default:
+            assert(false && "not all field types implements c_flags_bind_struct()");
+        }
+    }
+}
 
 void c_flags_set_application_name(const char *appname)
 {
     c_flags_appname_message = (char *) appname;
+    registry_version += 1;
 }
 
 void c_flags_set_positional_args_description(const char *description)
 {
     c_flags_pos_args_desc = (char *) description;
+    registry_version += 1;
 }
 
 void c_flags_set_description(const char *description)
 {
     c_flags_description_message = (char *) description;
+    registry_version += 1;
 }
 
-static CFlag *find_c_flag_by_long_name(StringView long_name)
+const char *c_flags_application_name(void)
 {
-    for (size_t i = 0; i < flags_size; i++) {
-        CFlag *flag = &flags[i];
+    return c_flags_appname_message;
+}
+
+const char *c_flags_positional_args_description(void)
+{
+    return c_flags_pos_args_desc;
+}
+
+const char *c_flags_description(void)
+{
+    return c_flags_description_message;
+}
+
+unsigned c_flags_registry_version(void)
+{
+    return registry_version;
+}
+
+CFlag *c_flags_find_by_long_name(StringView long_name)
+{
+    if (long_name.data == NULL)
+        return NULL;
+
+    uint32_t entry = *names_index_entry(long_names_index, long_name, false);
+    return entry != 0 ? &flags[entry - 1] : NULL;
+}
+
+static CFlag *find_c_flag_by_short_name(StringView short_name)
+{
+    if (short_name.data == NULL)
+        return NULL;
+
+    uint32_t entry = *names_index_entry(short_names_index, short_name, true);
+    return entry != 0 ? &flags[entry - 1] : NULL;
+}
+
+size_t c_flags_count(void)
+{
+    return flags_size;
+}
 
-        if (sv_equal(sv_from_string(flag->long_name), long_name))
-            return flag;
+CFlag *c_flags_at(size_t index)
+{
+    assert(index < flags_size && "flag index is out of range");
+    return &flags[index];
+}
+
+void *c_flags_value_storage(size_t *size_ptr)
+{
+    *size_ptr = sizeof(value_storage);
+    return &value_storage;
+}
+
+CFlag *c_flags_find_by_data(const void *value)
+{
+    uintptr_t address = (uintptr_t) value;
+    uintptr_t begin = (uintptr_t) &flag_slots[0];
+
+    // values in the value storage are found by index, bound variables are searched
+    if (address >= begin && (address - begin) % sizeof(CFlagSlot) == 0) {
+        size_t index = (address - begin) / sizeof(CFlagSlot);
+
+        if (index < flags_size && flags[index].value == value)
+            return &flags[index];
+    }
+
+    for (size_t i = 0; i < flags_size; i++) {
+        if (flags[i].value == value)
+            return &flags[i];
     }
 
     return NULL;
 }
 
-static CFlag *find_c_flag_by_short_name(StringView short_name)
+uint64_t c_flags_schema_hash(void)
 {
+    // FNV-1a over names and types of declared flags
+    uint64_t hash = 14695981039346656037ULL;
+
     for (size_t i = 0; i < flags_size; i++) {
-        CFlag *flag = &flags[i];
+        const CFlag *flag = &flags[i];
 
-        if (sv_equal(sv_from_string(flag->short_name), short_name))
-            return flag;
+        for (const char *c = flag->long_name; *c != '\0'; c++)
+            hash = (hash ^ (unsigned char) *c) * 1099511628211ULL;
+
+        hash = (hash ^ 0xFF) * 1099511628211ULL;
+        hash = (hash ^ (uint64_t) flag->type) * 1099511628211ULL;
     }
 
-    return NULL;
+    return hash;
 }
 
-void c_flags_parse(int *argc_ptr, char ***argv_ptr, bool usage_on_error)
+const char *c_flag_type_name(CFlagType type)
 {
-    int argc = *argc_ptr;
-    char **argv = *argv_ptr;
+    switch (type) {
+    case C_FLAG_INT:
+        return "int";
+    case C_FLAG_INT_8:
+        return "int8_t";
+    case C_FLAG_INT_16:
+        return "int16_t";
+    case C_FLAG_INT_32:
+        return "int32_t";
+    case C_FLAG_INT_64:
+        return "int64_t";
+    case C_FLAG_UNSIGNED:
+        return "unsigned";
+    case C_FLAG_UINT_8:
+        return "uint8_t";
+    case C_FLAG_UINT_16:
+        return "uint16_t";
+    case C_FLAG_UINT_32:
+        return "uint32_t";
+    case C_FLAG_UINT_64:
+        return "uint64_t";
+    case C_FLAG_SIZE_T:
+        return "size_t";
+    case C_FLAG_BOOL:
+        return "bool";
+    case C_FLAG_STRING:
+        return "char *";
+    case C_FLAG_FLOAT:
+        return "float";
+    case C_FLAG_DOUBLE:
+        return "double";
+    case C_FLAG_BYTES:
+        return "bytes";
+    case C_FLAG_DURATION:
+        return "duration";
+    case C_FLAG_CHOICE:
+        return "choice";
+    case C_FLAG_SET:
+        return "set";
+    case C_FLAG_CPUS:
+        return "cpus";
+    case C_FLAG_INT32_LIST:
+        return "int32_t list";
+    case C_FLAG_INT64_LIST:
+        return "int64_t list";
+    case C_FLAG_UINT32_LIST:
+        return "uint32_t list";
+    case C_FLAG_UINT64_LIST:
+        return "uint64_t list";
+    case C_FLAG_DOUBLE_LIST:
+        return "double list";
+    case C_FLAG_COUNTER:
+        return "counter";
+    case C_FLAG_STRINGS:
+        return "strings";
+    case C_FLAG_PATH:
+        return "path";
+    case C_FLAG_DIRECTORY:
+        return "directory";
+    case C_FLAG_FILE:
+        return "file";
+    case C_FLAG_MAPPED_FILE:
+        return "mapped file";
+    case C_FLAG_BINARY:
+        return "binary";
+    default:
+        assert(false && "not all flag types implements c_flag_type_name()");
+    }
 
-    assert(argc > 0 && "argc must be grater then 0");
+    return "unreachable";
+}
 
-    int arg = 1;
-    while (arg < argc) {
-        StringView token = sv_from_string(argv[arg]);
-        assert(token.data != NULL && "argv cannot be NULL");
-
-        CFlag *flag = NULL;
-        bool flag_long = false;
-        StringView sv_value = sv_from_string(NULL);
-
-        // `--flag value` or `--flag=value`
-        if (sv_starts_with(token, sv_from_string("--"))) {
-            // `--flag value`
-            if (!sv_contains(token, sv_from_string("="))) {
-                StringView sv_long_name = sv_chop_left(token, strlen("--"));
-
-                flag = find_c_flag_by_long_name(sv_long_name);
-                if (flag == NULL) {
-                    printf("ERROR: unknown flag --" SVFMT "\n", SVARG(sv_long_name));
-                    goto error;
-                }
+bool c_flag_convert(const CFlag *flag, const char *value, CFlagValue *value_ptr)
+{
+    value_ptr->raw = 0;
 
-                if (flag->type != C_FLAG_BOOL) {
-                    if (arg + 1 >= argc) {
-                        printf("ERROR: no value for flag --" SVFMT "\n", SVARG(sv_long_name));
-                        goto error;
-                    }
+    switch (flag->type) {
+    case C_FLAG_INT:
+        C_FLAG_CONVERT_SIGNED_VALUE(int, value, as_int)
+    case C_FLAG_INT_8:
+        C_FLAG_CONVERT_SIGNED_VALUE(int8_t, value, as_int8)
+    case C_FLAG_INT_16:
+        C_FLAG_CONVERT_SIGNED_VALUE(int16_t, value, as_int16)
+    case C_FLAG_INT_32:
+        C_FLAG_CONVERT_SIGNED_VALUE(int32_t, value, as_int32)
+    case C_FLAG_INT_64:
+        C_FLAG_CONVERT_SIGNED_VALUE(int64_t, value, as_int64)
+    case C_FLAG_UNSIGNED:
+        C_FLAG_CONVERT_UNSIGNED_VALUE(unsigned, value, as_unsigned)
+    case C_FLAG_UINT_8:
+        C_FLAG_CONVERT_UNSIGNED_VALUE(uint8_t, value, as_uint8)
+    case C_FLAG_UINT_16:
+        C_FLAG_CONVERT_UNSIGNED_VALUE(uint16_t, value, as_uint16)
+    case C_FLAG_UINT_32:
+        C_FLAG_CONVERT_UNSIGNED_VALUE(uint32_t, value, as_uint32)
+    case C_FLAG_UINT_64:
+        C_FLAG_CONVERT_UNSIGNED_VALUE(uint64_t, value, as_uint64)
+    case C_FLAG_SIZE_T:
+        C_FLAG_CONVERT_UNSIGNED_VALUE(size_t, value, as_size_t)
+    case C_FLAG_BOOL:
+        if (strcmp(value, "true") && strcmp(value, "false"))
+            return false;
 
-                    sv_value = sv_from_string(argv[++arg]);
-                }
-            }
-            // `--flag=value`
-            else {
-                size_t index_of_eq = (size_t) sv_index_of(token, sv_from_string("="));
-                StringView sv_long_name = sv_chop_left(sv_slice_left(token, index_of_eq),
-                                                       strlen("--"));
+        value_ptr->as_bool = !strcmp(value, "true");
+        return true;
+    case C_FLAG_STRING:
+        value_ptr->as_string = (char *) value;
+        return true;
+    case C_FLAG_FLOAT:
+        C_FLAG_CONVERT_FLOATING_VALUE(float, value, strtof, as_float)
+    case C_FLAG_DOUBLE:
+        C_FLAG_CONVERT_FLOATING_VALUE(double, value, strtod, as_double)
+    case C_FLAG_BYTES:
+        return c_flags_parse_bytes(value, &value_ptr->as_bytes);
+    case C_FLAG_DURATION:
+        return c_flags_parse_duration(value, &value_ptr->as_duration);
+    case C_FLAG_CHOICE:
+        return c_flags_parse_choice(flag->choices, value, &value_ptr->as_choice);
+    case C_FLAG_SET:
+        return c_flags_parse_set(flag->choices, value, &value_ptr->as_set);
+#if defined(__linux__)
+    case C_FLAG_CPUS:
+        return c_flags_parse_cpus(value, &value_ptr->as_cpus);
+#endif
+    case C_FLAG_INT32_LIST:
+    case C_FLAG_INT64_LIST:
+    case C_FLAG_UINT32_LIST:
+    case C_FLAG_UINT64_LIST:
+    case C_FLAG_DOUBLE_LIST:
+        return c_flags_parse_list(flag->type, value, &value_ptr->as_list, NULL);
+    case C_FLAG_COUNTER:
+        C_FLAG_CONVERT_UNSIGNED_VALUE(unsigned, value, as_counter)
+    case C_FLAG_STRINGS:
+        // a value from a config or the control socket is the only element
+        return c_flags_strings_copy(value, strlen(value) + 1, &value_ptr->as_strings);
+#if defined(__linux__)
+    case C_FLAG_PATH:
+    case C_FLAG_DIRECTORY:
+    case C_FLAG_FILE:
+    case C_FLAG_MAPPED_FILE:
+        return c_flags_open_file(flag->type, value, &value_ptr->as_file);
+#endif
+    case C_FLAG_BINARY:
+        return c_flags_parse_binary(value, &value_ptr->as_list);
+    default:
+        assert(false && "not all flag types implements c_flag_convert()");
+    }
 
-                sv_value = sv_chop_left(token, index_of_eq + 1);
+    return false;
+}
 
-                if (sv_value.data == NULL) { // `--flag=`
-                    printf("ERROR: no value for flag --" SVFMT "\n", SVARG(sv_long_name));
-                    goto error;
-                }
+const char *c_flag_source_name(CFlagSource source)
+{
+    switch (source) {
+    case C_FLAG_SOURCE_DEFAULT:
+        return "default";
+    case C_FLAG_SOURCE_COMMAND_LINE:
+        return "command-line";
+    case C_FLAG_SOURCE_CONFIG:
+        return "config";
+    case C_FLAG_SOURCE_CONTROL:
+        return "control";
+    case C_FLAG_SOURCE_SHARED_MEMORY:
+        return "shared-memory";
+    default:
+        assert(false && "not all flag sources implements c_flag_source_name()");
+    }
 
-                flag = find_c_flag_by_long_name(sv_long_name);
-                if (flag == NULL) {
-                    printf("ERROR: unknown flag --" SVFMT "\n", SVARG(sv_long_name));
-                    goto error;
-                }
-            }
+    return "unreachable";
+}
 
-            flag_long = true;
-        }
-        // `-f value`
-        else if (sv_starts_with(token, sv_from_string("-"))) {
-            StringView sv_short_name = sv_chop_left(token, strlen("-"));
+const char *c_flag_format(const CFlag *flag, CFlagValue value, char *buffer, size_t size)
+{
+    switch (flag->type) {
+    case C_FLAG_INT:
+        snprintf(buffer, size, "%d", value.as_int);
+        return buffer;
+    case C_FLAG_INT_8:
+        snprintf(buffer, size, "%" PRId8, value.as_int8);
+        return buffer;
+    case C_FLAG_INT_16:
+        snprintf(buffer, size, "%" PRId16, value.as_int16);
+        return buffer;
+    case C_FLAG_INT_32:
+        snprintf(buffer, size, "%" PRId32, value.as_int32);
+        return buffer;
+    case C_FLAG_INT_64:
+        snprintf(buffer, size, "%" PRId64, value.as_int64);
+        return buffer;
+    case C_FLAG_UNSIGNED:
+        snprintf(buffer, size, "%u", value.as_unsigned);
+        return buffer;
+    case C_FLAG_UINT_8:
+        snprintf(buffer, size, "%" PRIu8, value.as_uint8);
+        return buffer;
+    case C_FLAG_UINT_16:
+        snprintf(buffer, size, "%" PRIu16, value.as_uint16);
+        return buffer;
+    case C_FLAG_UINT_32:
+        snprintf(buffer, size, "%" PRIu32, value.as_uint32);
+        return buffer;
+    case C_FLAG_UINT_64:
+        snprintf(buffer, size, "%" PRIu64, value.as_uint64);
+        return buffer;
+    case C_FLAG_SIZE_T:
+        snprintf(buffer, size, "%zu", value.as_size_t);
+        return buffer;
+    case C_FLAG_BOOL:
+        return value.as_bool ? "true" : "false";
+    case C_FLAG_STRING:
+        return value.as_string;
+    case C_FLAG_FLOAT:
+        snprintf(buffer, size, "%.9g", (double) value.as_float);
+        return buffer;
+    case C_FLAG_DOUBLE:
+        snprintf(buffer, size, "%.17g", value.as_double);
+        return buffer;
+    case C_FLAG_BYTES:
+        return c_flags_format_bytes(value.as_bytes, buffer, size);
+    case C_FLAG_DURATION:
+        return c_flags_format_duration(value.as_duration, buffer, size);
+    case C_FLAG_CHOICE:
+        return c_flags_format_choice(flag->choices, value.as_choice, buffer, size);
+    case C_FLAG_SET:
+        return c_flags_format_set(flag->choices, value.as_set, buffer, size);
+#if defined(__linux__)
+    case C_FLAG_CPUS:
+        return c_flags_format_cpus(value.as_cpus, buffer, size);
+#endif
+    case C_FLAG_INT32_LIST:
+    case C_FLAG_INT64_LIST:
+    case C_FLAG_UINT32_LIST:
+    case C_FLAG_UINT64_LIST:
+    case C_FLAG_DOUBLE_LIST:
+        c_flags_format_list(flag->type, value.as_list, buffer, size);
+        return buffer;
+    case C_FLAG_COUNTER:
+        snprintf(buffer, size, "%u", value.as_counter);
+        return buffer;
+    case C_FLAG_STRINGS:
+        return c_flags_format_strings(value.as_strings, buffer, size);
+#if defined(__linux__)
+    case C_FLAG_PATH:
+    case C_FLAG_DIRECTORY:
+    case C_FLAG_FILE:
+    case C_FLAG_MAPPED_FILE:
+        return value.as_file != NULL ? ((const CFlagsFile *) value.as_file)->path : NULL;
+#endif
+    case C_FLAG_BINARY:
+        c_flags_format_binary(value.as_list, buffer, size);
+        return buffer;
+    default:
+        assert(false && "not all flag types implements c_flag_format()");
+    }
 
-            flag = find_c_flag_by_short_name(sv_short_name);
-            if (flag == NULL) {
-                printf("ERROR: unknown flag -" SVFMT "\n", SVARG(sv_short_name));
-                goto error;
-            }
+    return "unreachable";
+}
 
-            if (flag->type != C_FLAG_BOOL) {
-                if (arg + 1 >= argc) {
-                    printf("ERROR: no value for flag -" SVFMT "\n", SVARG(sv_short_name));
-                    goto error;
-                }
+bool c_flag_value_equal(const CFlag *flag, CFlagValue a, CFlagValue b)
+{
+    if (flag->type == C_FLAG_STRING) {
+        if (a.as_string == NULL || b.as_string == NULL)
+            return a.as_string == b.as_string;
 
-                sv_value = sv_from_string(argv[++arg]);
-            }
-        }
-        // positional arguments
-        else {
-            break;
-        }
+        return !strcmp(a.as_string, b.as_string);
+    }
 
-        char *value = (char *) sv_value.data;
+    if (c_flags_is_list(flag->type)) {
+        size_t size = c_flags_list_size(a.as_list);
 
-        switch (flag->type) {
-        case C_FLAG_INT:
-            C_FLAG_LOAD_SIGNED_VALUE(flag, flag_long, int, value, usage_on_error)
-            break;
-        case C_FLAG_INT_8:
-            C_FLAG_LOAD_SIGNED_VALUE(flag, flag_long, int8_t, value, usage_on_error)
-            break;
-        case C_FLAG_INT_16:
-            C_FLAG_LOAD_SIGNED_VALUE(flag, flag_long, int16_t, value, usage_on_error)
-            break;
-        case C_FLAG_INT_32:
-            C_FLAG_LOAD_SIGNED_VALUE(flag, flag_long, int32_t, value, usage_on_error)
-            break;
-        case C_FLAG_INT_64:
-            C_FLAG_LOAD_SIGNED_VALUE(flag, flag_long, int64_t, value, usage_on_error)
-            break;
-        case C_FLAG_UNSIGNED:
-            C_FLAG_LOAD_UNSIGNED_VALUE(flag, flag_long, unsigned, value, usage_on_error)
-            break;
-        case C_FLAG_UINT_8:
-            C_FLAG_LOAD_UNSIGNED_VALUE(flag, flag_long, uint8_t, value, usage_on_error)
-            break;
-        case C_FLAG_UINT_16:
-            C_FLAG_LOAD_UNSIGNED_VALUE(flag, flag_long, uint16_t, value, usage_on_error)
-            break;
-        case C_FLAG_UINT_32:
-            C_FLAG_LOAD_UNSIGNED_VALUE(flag, flag_long, uint32_t, value, usage_on_error)
-            break;
-        case C_FLAG_UINT_64:
-            C_FLAG_LOAD_UNSIGNED_VALUE(flag, flag_long, uint64_t, value, usage_on_error)
-            break;
-        case C_FLAG_SIZE_T:
-            C_FLAG_LOAD_UNSIGNED_VALUE(flag, flag_long, size_t, value, usage_on_error)
-            break;
-        case C_FLAG_BOOL:
-            *C_FLAG_DATA_AS_PTR(flag, bool) = true;
-            break;
-        case C_FLAG_STRING:
-            *C_FLAG_DATA_AS_PTR(flag, char *) = value;
-            break;
-        case C_FLAG_FLOAT:
-            C_FLAG_LOAD_FLOATING_VALUE(flag, flag_long, float, value, strtof, usage_on_error);
-            break;
-        case C_FLAG_DOUBLE:
-            C_FLAG_LOAD_FLOATING_VALUE(flag, flag_long, double, value, strtod, usage_on_error);
-            break;
-        default:
-            assert(false && "not all flag types implements c_flags_parse()");
+        return size == c_flags_list_size(b.as_list) &&
+               (size == 0 || !memcmp(a.as_list,
+                                     b.as_list,
+                                     size * c_flags_list_element_size(flag->type)));
+    }
+
+    if (flag->type == C_FLAG_STRINGS) {
+        size_t i = 0;
+
+        while (a.as_strings[i] != NULL && b.as_strings[i] != NULL &&
+               !strcmp(a.as_strings[i], b.as_strings[i])) {
+            i++;
         }
 
-        arg += 1;
+        return a.as_strings[i] == NULL && b.as_strings[i] == NULL;
     }
 
-    *argc_ptr = argc - arg;
-    *argv_ptr = argv + arg;
+    return a.raw == b.raw;
+}
 
-    return;
+void *c_flag_value_allocation(const CFlag *flag, CFlagValue value)
+{
+    // the empty array of accumulating flags is static
+    if (flag->type == C_FLAG_STRINGS)
+        return value.as_strings[0] != NULL ? value.as_strings : NULL;
 
-error:
-    if (usage_on_error) {
-        printf("\n");
-        c_flags_usage();
-    }
+    return c_flags_is_list(flag->type) ? c_flags_list_allocation(value.as_list) : NULL;
+}
 
-    exit(1);
+bool c_flags_is_file(CFlagType type)
+{
+    return type >= C_FLAG_PATH && type <= C_FLAG_MAPPED_FILE;
 }
 
-static char *c_flag_default_to_str(const CFlag *flag)
+bool c_flags_is_reconverted(CFlagType type)
 {
-    static char buff[32] = {0};
+    return type == C_FLAG_CPUS || c_flags_is_file(type);
+}
 
-    switch (flag->type) {
+bool c_flag_takes_value(const CFlag *flag)
+{
+    return flag->type != C_FLAG_BOOL && flag->type != C_FLAG_COUNTER;
+}
+
+const char *c_flag_describe_invalid(const CFlag *flag,
+                                    const char *value,
+                                    char *buffer,
+                                    size_t size)
+{
+    const void *values = NULL;
+    size_t index = 0;
+
+#if defined(__linux__)
+    if (c_flags_is_file(flag->type))
+        return c_flags_describe_file(flag->type, value, buffer, size);
+#endif
+
+    if (flag->type == C_FLAG_BINARY)
+        return c_flags_describe_binary(value, buffer, size);
+
+    if (!c_flags_is_list(flag->type) || c_flags_parse_list(flag->type, value, &values, &index)) {
+        free(c_flags_list_allocation(values));
+        return value;
+    }
+
+    if (index == SIZE_MAX) {
+        snprintf(buffer, size, "(out of memory)");
+        return buffer;
+    }
+
+    // skip separators and elements before the invalid one
+    const char *element = value;
+
+    for (size_t i = 0; i <= index; i++) {
+        while (*element == ' ' || *element == '\t' || *element == '\n')
+            element++;
+
+        if (i == index)
+            break;
+
+        element += strcspn(element, ", \t\n");
+        element += strspn(element, " \t\n");
+        element += *element == ',';
+    }
+
+    int element_size = (int) strcspn(element, ", \t\n");
+
+    if (element_size == 0)
+        snprintf(buffer, size, "\"\" at index %zu", index);
+    else
+        snprintf(buffer, size, "%.*s at index %zu", element_size, element, index);
+
+    return buffer;
+}
+
+static size_t flag_value_size(CFlagType type)
+{
+    switch (type) {
     case C_FLAG_INT:
-        snprintf(buff, sizeof(buff), "%d", *C_FLAG_DEFAULT_DATA_AS_PTR(flag, int));
-        return buff;
+        return sizeof(int);
     case C_FLAG_INT_8:
-        snprintf(buff, sizeof(buff), "%" PRId8, *C_FLAG_DEFAULT_DATA_AS_PTR(flag, int8_t));
-        return buff;
+        return sizeof(int8_t);
     case C_FLAG_INT_16:
-        snprintf(buff, sizeof(buff), "%" PRId16, *C_FLAG_DEFAULT_DATA_AS_PTR(flag, int16_t));
-        return buff;
+        return sizeof(int16_t);
     case C_FLAG_INT_32:
-        snprintf(buff, sizeof(buff), "%" PRId32, *C_FLAG_DEFAULT_DATA_AS_PTR(flag, int32_t));
-        return buff;
+        return sizeof(int32_t);
     case C_FLAG_INT_64:
-        snprintf(buff, sizeof(buff), "%" PRId64, *C_FLAG_DEFAULT_DATA_AS_PTR(flag, int64_t));
-        return buff;
+        return sizeof(int64_t);
     case C_FLAG_UNSIGNED:
-        snprintf(buff, sizeof(buff), "%u", *C_FLAG_DEFAULT_DATA_AS_PTR(flag, unsigned));
-        return buff;
+        return sizeof(unsigned);
     case C_FLAG_UINT_8:
-        snprintf(buff, sizeof(buff), "%" PRIu8, *C_FLAG_DEFAULT_DATA_AS_PTR(flag, uint8_t));
-        return buff;
+        return sizeof(uint8_t);
     case C_FLAG_UINT_16:
-        snprintf(buff, sizeof(buff), "%" PRIu16, *C_FLAG_DEFAULT_DATA_AS_PTR(flag, uint16_t));
-        return buff;
+        return sizeof(uint16_t);
     case C_FLAG_UINT_32:
-        snprintf(buff, sizeof(buff), "%" PRIu32, *C_FLAG_DEFAULT_DATA_AS_PTR(flag, uint32_t));
-        return buff;
+        return sizeof(uint32_t);
     case C_FLAG_UINT_64:
-        snprintf(buff, sizeof(buff), "%" PRIu64, *C_FLAG_DEFAULT_DATA_AS_PTR(flag, uint64_t));
-        return buff;
+        return sizeof(uint64_t);
     case C_FLAG_SIZE_T:
-        snprintf(buff, sizeof(buff), "%zu", *C_FLAG_DEFAULT_DATA_AS_PTR(flag, size_t));
-        return buff;
+        return sizeof(size_t);
     case C_FLAG_BOOL:
-        return *C_FLAG_DEFAULT_DATA_AS_PTR(flag, bool) ? "true" : "false";
+        return sizeof(bool);
     case C_FLAG_STRING:
-        return *C_FLAG_DEFAULT_DATA_AS_PTR(flag, char *);
+        return sizeof(char *);
     case C_FLAG_FLOAT:
-        snprintf(buff, sizeof(buff), "%f", *C_FLAG_DEFAULT_DATA_AS_PTR(flag, float));
-        return buff;
+        return sizeof(float);
     case C_FLAG_DOUBLE:
-        snprintf(buff, sizeof(buff), "%lf", *C_FLAG_DEFAULT_DATA_AS_PTR(flag, double));
-        return buff;
+        return sizeof(double);
+    case C_FLAG_BYTES:
+        return sizeof(uint64_t);
+    case C_FLAG_DURATION:
+        return sizeof(int64_t);
+    case C_FLAG_CHOICE:
+        return sizeof(int);
+    case C_FLAG_SET:
+        return sizeof(uint64_t);
+    case C_FLAG_CPUS:
+    case C_FLAG_INT32_LIST:
+    case C_FLAG_INT64_LIST:
+    case C_FLAG_UINT32_LIST:
+    case C_FLAG_UINT64_LIST:
+    case C_FLAG_DOUBLE_LIST:
+        return sizeof(void *);
+    case C_FLAG_COUNTER:
+        return sizeof(unsigned);
+    case C_FLAG_STRINGS:
+        return sizeof(char **);
+    case C_FLAG_PATH:
+    case C_FLAG_DIRECTORY:
+    case C_FLAG_FILE:
+    case C_FLAG_MAPPED_FILE:
+    case C_FLAG_BINARY:
+        return sizeof(void *);
     default:
-        assert(false && "not all flag types implements c_flag_default_to_str()");
+        assert(false && "not all flag types implements flag_value_size()");
     }
 
-    return "unreachable";
+    return 0;
 }
 
-void c_flags_usage(void)
+CFlagValue c_flag_get_value(const CFlag *flag)
 {
-    if (c_flags_appname_message)
-        printf("USAGE:\n   %s%s%s\n\n",
-               c_flags_appname_message,
-               (flags_size > 0) ? " [OPTIONS] " : " ",
-               c_flags_pos_args_desc ? c_flags_pos_args_desc : "");
+    CFlagValue value = {.raw = 0};
 
-    if (c_flags_description_message)
-        printf("DESCRIPTION:\n   %s\n\n", c_flags_description_message);
+    if (flag->packed) {
+        value.as_bool = C_FLAGS_BIT_TEST(flag_bits, flag->bit);
+        return value;
+    }
 
-    if (flags_size > 0)
-        printf("OPTIONS:");
+    // bound variables have only the size of the flag type
+    memcpy(&value, flag->value, flag_value_size(flag->type));
+    return value;
+}
 
-    for (size_t i = 0; i < flags_size; i++) {
+void c_flag_set_value(CFlag *flag, CFlagValue value)
+{
+    assert(!c_flags_is_frozen() && "flags cannot be changed after c_flags_freeze()");
+
+    if (flag->packed) {
+        if (value.as_bool)
+            flag_bits[C_FLAGS_BIT_WORD(flag->bit)] |= C_FLAGS_BIT_MASK(flag->bit);
+        else
+            flag_bits[C_FLAGS_BIT_WORD(flag->bit)] &= ~C_FLAGS_BIT_MASK(flag->bit);
+
+        return;
+    }
+
+    memcpy(flag->value, &value, flag_value_size(flag->type));
+}
+
+size_t c_flags_apply(CFlagAssignment *assignments, size_t count, CFlagSource source)
+{
+    // observers are notified without the lock, so changed flags aren't shared between threads
+    CFlag *changed_flags[C_FLAGS_CAPACITY];
+    static unsigned change_stamp = 0;
+
+    assert(!c_flags_is_frozen() && "flags cannot be changed after c_flags_freeze()");
+
+    c_flags_lock();
+
+    size_t changed = 0;
+    change_stamp += 1;
+
+    for (size_t i = 0; i < count; i++) {
+        CFlagAssignment *assignment = &assignments[i];
+        CFlag *flag = assignment->flag;
+
+        if (c_flag_value_equal(flag, c_flag_get_value(flag), assignment->value)) {
+            free(assignment->owned);
+            assignment->owned = NULL;
+            continue;
+        }
+
+        free(flag->owned);
+        flag->owned = assignment->owned;
+        assignment->owned = NULL;
+
+        c_flag_set_value(flag, assignment->value);
+        flag->source = source;
+
+        // the same flag may be assigned several times in one batch
+        if (flag->change_stamp != change_stamp) {
+            flag->change_stamp = change_stamp;
+            changed_flags[changed++] = flag;
+        }
+    }
+
+    c_flags_unlock();
+
+    // observers may read flags with functions taking the lock
+    if (changed > 0)
+        c_flags_notify(changed_flags, changed);
+
+    return changed;
+}
+
+void c_flags_lock(void)
+{
+#if defined(__linux__)
+    pthread_mutex_lock(&flags_lock);
+#endif
+}
+
+void c_flags_unlock(void)
+{
+#if defined(__linux__)
+    pthread_mutex_unlock(&flags_lock);
+#endif
+}
+
+/*
+ * Print unknown flag error with the nearest declared long or short name
+ * if it's close enough to be a typo.
+ */
+static void print_unknown_flag(const char *prefix, StringView name)
+{
+    EditDistancePattern pattern;
+    ed_pattern_init(&pattern, name);
+
+    const char *suggestion_prefix = NULL;
+    const char *suggestion = NULL;
+    size_t best_distance = (name.size + 2) / 3 + 1;
+
+    for (size_t i = 0; i < flags_size && name.size > 0; i++) {
         const CFlag *flag = &flags[i];
 
-        printf("\n   --%s", flag->long_name);
-        if (flag->short_name != NULL)
-            printf(", -%s", flag->short_name);
+        if (flag->hidden)
+            continue;
+
+        const char *names[] = {flag->long_name, flag->short_name};
+        const char *prefixes[] = {"--", "-"};
+
+        for (size_t j = 0; j < 2; j++) {
+            StringView candidate = sv_from_string(names[j]);
+
+            if (candidate.data == NULL)
+                continue;
+
+            size_t distance = ed_distance(&pattern, candidate, best_distance - 1);
+
+            // don't suggest names that share nothing with the unknown one
+            if (distance < best_distance && distance < name.size && distance < candidate.size) {
+                best_distance = distance;
+                suggestion_prefix = prefixes[j];
+                suggestion = names[j];
+            }
+        }
+    }
+
+    if (suggestion == NULL) {
+        printf("ERROR: unknown flag %s" SVFMT "\n", prefix, SVARG(name));
+        return;
+    }
+
+    printf("ERROR: unknown flag %s" SVFMT ", did you mean %s%s?\n",
+           prefix,
+           SVARG(name),
+           suggestion_prefix,
+           suggestion);
+}
+
+/*
+ * Find counter flag with one character short name repeated like `-vvv`,
+ * which is counted as many times as the name is repeated.
+ */
+static CFlag *find_counter_by_short_run(StringView run, unsigned *count_ptr)
+{
+    if (run.size < 2 || run.size > UINT_MAX)
+        return NULL;
+
+    for (size_t i = 1; i < run.size; i++) {
+        if (run.data[i] != run.data[0])
+            return NULL;
+    }
+
+    CFlag *flag = find_c_flag_by_short_name(sv_slice_left(run, 1));
+    if (flag == NULL || flag->type != C_FLAG_COUNTER)
+        return NULL;
+
+    *count_ptr = (unsigned) run.size;
+    return flag;
+}
+
+typedef enum
+{
+    C_FLAGS_TOKEN_FLAG,       // known flag with its value
+    C_FLAGS_TOKEN_UNKNOWN,    // unknown flag
+    C_FLAGS_TOKEN_POSITIONAL, // positional argument
+    C_FLAGS_TOKEN_ERROR,      // invalid known flag
+} CFlagsToken;
+
+/*
+ * Parse token at `*arg_ptr` and apply it if it's a known flag, `*arg_ptr` is
+ * moved to the value of the flag if the value is a separate token.
+ * Errors are printed, unknown flags are printed only if they aren't allowed.
+ */
+static CFlagsToken parse_token(int argc, char **argv, int *arg_ptr, bool unknown_allowed)
+{
+    int arg = *arg_ptr;
+
+    StringView token = sv_from_string(argv[arg]);
+    assert(token.data != NULL && "argv cannot be NULL");
+
+    CFlag *flag = NULL;
+    bool flag_long = false;
+    unsigned increment = 1;
+    StringView sv_value = sv_from_string(NULL);
+
+    // `--flag value` or `--flag=value`
+    if (sv_starts_with(token, sv_from_string("--"))) {
+        int index_of_eq = sv_index_of(token, sv_from_string("="));
+
+        // `--flag value`
+        if (index_of_eq == -1) {
+            StringView sv_long_name = sv_chop_left(token, strlen("--"));
+
+            flag = c_flags_find_by_long_name(sv_long_name);
+            if (flag == NULL) {
+                if (!unknown_allowed)
+                    print_unknown_flag("--", sv_long_name);
+                return C_FLAGS_TOKEN_UNKNOWN;
+            }
+
+            if (c_flag_takes_value(flag)) {
+                if (arg + 1 >= argc) {
+                    printf("ERROR: no value for flag --" SVFMT "\n", SVARG(sv_long_name));
+                    return C_FLAGS_TOKEN_ERROR;
+                }
+
+                sv_value = sv_from_string(argv[++arg]);
+            }
+        }
+        // `--flag=value`
+        else {
+            StringView sv_long_name = sv_chop_left(sv_slice_left(token, (size_t) index_of_eq),
+                                                   strlen("--"));
+
+            sv_value = sv_chop_left(token, (size_t) index_of_eq + 1);
+
+            flag = c_flags_find_by_long_name(sv_long_name);
+            if (flag == NULL) {
+                if (!unknown_allowed)
+                    print_unknown_flag("--", sv_long_name);
+                return C_FLAGS_TOKEN_UNKNOWN;
+            }
+
+            if (sv_value.data == NULL) { // `--flag=`
+                printf("ERROR: no value for flag --" SVFMT "\n", SVARG(sv_long_name));
+                return C_FLAGS_TOKEN_ERROR;
+            }
+        }
+
+        flag_long = true;
+    }
+    // `-f value`
+    else if (sv_starts_with(token, sv_from_string("-"))) {
+        StringView sv_short_name = sv_chop_left(token, strlen("-"));
+
+        flag = find_c_flag_by_short_name(sv_short_name);
+        if (flag == NULL)
+            flag = find_counter_by_short_run(sv_short_name, &increment);
+
+        if (flag == NULL) {
+            if (!unknown_allowed)
+                print_unknown_flag("-", sv_short_name);
+            return C_FLAGS_TOKEN_UNKNOWN;
+        }
+
+        if (c_flag_takes_value(flag)) {
+            if (arg + 1 >= argc) {
+                printf("ERROR: no value for flag -" SVFMT "\n", SVARG(sv_short_name));
+                return C_FLAGS_TOKEN_ERROR;
+            }
+
+            sv_value = sv_from_string(argv[++arg]);
+        }
+    }
+    // positional arguments
+    else {
+        return C_FLAGS_TOKEN_POSITIONAL;
+    }
+
+    char *value = (char *) sv_value.data;
+
+    // `--flag` or `-f` for booleans, `--flag=false` is accepted too
+    CFlagValue converted;
+
+    if (flag->type == C_FLAG_STRINGS) {
+        // occurrences are stored together when the parse ends
+        c_flags_strings_collect(flag, value);
+        flag->source = C_FLAG_SOURCE_COMMAND_LINE;
+        *arg_ptr = arg;
+
+        return C_FLAGS_TOKEN_FLAG;
+    }
+
+    if (flag->type == C_FLAG_BOOL && value == NULL) {
+        c_flag_set_value(flag, (CFlagValue) {.as_bool = true});
+    }
+    else if (flag->type == C_FLAG_COUNTER && value == NULL) {
+        // `--flag`, `-f` or `-fff` are counted, `--flag=3` sets the count
+        unsigned count = c_flag_get_value(flag).as_counter;
+        converted.raw = 0;
+        converted.as_counter = count > UINT_MAX - increment ? UINT_MAX : count + increment;
+
+        c_flag_set_value(flag, converted);
+    }
+    else if (c_flag_convert(flag, value, &converted)) {
+        c_flag_set_value(flag, converted);
+    }
+    else {
+        char allowed[C_FLAGS_FORMAT_SIZE];
+        char invalid[C_FLAGS_FORMAT_SIZE];
+
+        printf("ERROR: invalid value %s for %s flag %s%s\n",
+               c_flag_describe_invalid(flag, value, invalid, sizeof(invalid)),
+               c_flag_type_name(flag->type),
+               flag_long ? "--" : "-",
+               flag_long ? flag->long_name : flag->short_name);
+
+        if (c_flags_format_choices(flag, ", ", allowed, sizeof(allowed)) != NULL)
+            printf("       allowed values: %s\n", allowed);
+
+        return C_FLAGS_TOKEN_ERROR;
+    }
+
+    // strings reference argv, lists own the parsed elements
+    free(flag->owned);
+    flag->owned = c_flag_value_allocation(flag, c_flag_get_value(flag));
+
+    flag->source = C_FLAG_SOURCE_COMMAND_LINE;
+    *arg_ptr = arg;
+
+    return C_FLAGS_TOKEN_FLAG;
+}
+
+static void parse_error(bool usage_on_error)
+{
+    if (usage_on_error) {
         printf("\n");
+        c_flags_usage();
+    }
+
+    exit(1);
+}
 
-        if (flag->desc != NULL)
-            printf("       Description: %s\n", flag->desc);
+static void parse_begin(int argc, bool usage_on_error)
+{
+    if (!c_flags_strings_begin(argc)) {
+        printf("ERROR: out of memory while parsing flags\n");
+        parse_error(usage_on_error);
+    }
+
+    c_flags_files_begin();
+}
+
+void c_flags_parse(int *argc_ptr, char ***argv_ptr, bool usage_on_error)
+{
+    int argc = *argc_ptr;
+    char **argv = *argv_ptr;
+
+    assert(argc > 0 && "argc must be grater then 0");
+
+    parse_begin(argc, usage_on_error);
+
+    int arg = 1;
+    while (arg < argc) {
+        CFlagsToken token = parse_token(argc, argv, &arg, false);
 
-        char *default_val = c_flag_default_to_str(flag);
-        if (default_val != NULL)
-            printf("       Default: %s\n", c_flag_default_to_str(flag));
+        if (token == C_FLAGS_TOKEN_POSITIONAL)
+            break;
+
+        if (token != C_FLAGS_TOKEN_FLAG)
+            parse_error(usage_on_error);
+
+        arg += 1;
     }
+
+    c_flags_strings_end();
+    c_flags_files_end();
+    c_flags_completion_dispatch(argv[0]);
+
+    *argc_ptr = argc - arg;
+    *argv_ptr = argv + arg;
+}
+
+static void swap_args(char **argv, int a, int b)
+{
+    char *tmp = argv[a];
+    argv[a] = argv[b];
+    argv[b] = tmp;
+}
+
+static void reverse_args(char **argv, int begin, int end)
+{
+    while (begin < end - 1)
+        swap_args(argv, begin++, --end);
+}
+
+/*
+ * Parse flags found anywhere in argv and partition it in place in linear time
+ * to the program name, the tokens of parsed flags and the remaining arguments
+ * in their original order. Returns the number of the remaining arguments.
+ */
+static int parse_partition(int argc, char **argv, bool unknown_allowed, bool usage_on_error)
+{
+    assert(argc > 0 && "argc must be grater then 0");
+
+    /*
+     * Remaining arguments are swapped to the front keeping their order,
+     * the tokens of parsed flags are collected behind them.
+     */
+    int remaining_end = 1;
+    bool terminated = false;
+
+    parse_begin(argc, usage_on_error);
+
+    for (int arg = 1; arg < argc; arg++) {
+        int first = arg;
+
+        if (!terminated) {
+            if (!strcmp(argv[arg], "--")) {
+                terminated = true;
+                continue;
+            }
+
+            CFlagsToken token = parse_token(argc, argv, &arg, unknown_allowed);
+
+            if (token == C_FLAGS_TOKEN_ERROR ||
+                (token == C_FLAGS_TOKEN_UNKNOWN && !unknown_allowed)) {
+                parse_error(usage_on_error);
+            }
+
+            if (token == C_FLAGS_TOKEN_FLAG)
+                continue;
+        }
+
+        for (int i = first; i <= arg; i++)
+            swap_args(argv, remaining_end++, i);
+    }
+
+    // move the parsed tokens in front of the remaining ones with three reversals
+    reverse_args(argv, 1, remaining_end);
+    reverse_args(argv, remaining_end, argc);
+    reverse_args(argv, 1, argc);
+
+    c_flags_strings_end();
+    c_flags_files_end();
+    c_flags_completion_dispatch(argv[0]);
+
+    return remaining_end - 1;
+}
+
+void c_flags_parse_permute(int *argc_ptr, char ***argv_ptr, bool usage_on_error)
+{
+    int remaining = parse_partition(*argc_ptr, *argv_ptr, false, usage_on_error);
+
+    *argv_ptr += *argc_ptr - remaining;
+    *argc_ptr = remaining;
+}
+
+void c_flags_parse_pass_through(int *argc_ptr, char ***argv_ptr, bool usage_on_error)
+{
+    int forwarded = parse_partition(*argc_ptr, *argv_ptr, true, usage_on_error);
+
+    *argv_ptr += *argc_ptr - forwarded;
+    *argc_ptr = forwarded;
 }
@@ -33,8 +33,13 @@ extern "C" {
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <sys/types.h>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 // clang-format off
 /**
  * Declare `c_flag_*` function definition for any type.
@@ -42,14 +47,32 @@ extern "C" {
  * @param ptr_type Flag type (size_t, int, bool, ...)
  * @param postfix Function name postfix
  */
-#define DECLARE_C_FLAG_DEF(ptr_type, postfix)              \
-    C_FLAGS_EXPORT                                         \
-    ptr_type *c_flag_##postfix(const char *long_name,      \
-                               const char *short_name,     \
-                               const char *desc,           \
-                               const ptr_type default_val);
+#define DECLARE_C_FLAG_DEF(ptr_type, postfix)               \
+    C_FLAGS_EXPORT                                          \
+    ptr_type *c_flag_##postfix(const char *long_name,       \
+                               const char *short_name,      \
+                               const char *desc,            \
+                               const ptr_type default_val); \
+                                                            \
+    C_FLAGS_EXPORT                                          \
+    void c_flag_##postfix##_var(ptr_type *var,              \
+                                const char *long_name,      \
+                                const char *short_name,     \
+                                const char *desc,           \
+                                const ptr_type default_val);
 // clang-format on
 
+/*
+ * Every `c_flag_*` function has a `c_flag_*_var` variant that stores the value
+ * in the passed variable instead of the library storage, for example:
+ *
+ *  static size_t batch;
+ *  c_flag_size_t_var(&batch, "batch", "b", "batch size", 64);
+ *
+ * The variable is set to the default value and must stay alive while the flags are used.
+ * The variable address is used instead of the returned pointer in other functions.
+ */
+
 DECLARE_C_FLAG_DEF(int, int)
 DECLARE_C_FLAG_DEF(int8_t, int8)
 DECLARE_C_FLAG_DEF(int16_t, int16)
@@ -66,6 +89,457 @@ DECLARE_C_FLAG_DEF(char *, string)
 DECLARE_C_FLAG_DEF(float, float)
 DECLARE_C_FLAG_DEF(double, double)
 
+/*
+ * Byte size flags accept `4096`, `512MiB`, `4k` or `1.5G` and store exact
+ * number of bytes. Decimal suffixes are k, K, kB, KB, M, MB, G, GB, T, TB,
+ * P, PB, E, EB and binary suffixes are Ki, KiB, Mi, MiB, ... EiB. One-letter
+ * decimal suffixes are accepted in lower case too, so `512m` is `512M`.
+ */
+DECLARE_C_FLAG_DEF(uint64_t, bytes)
+
+/*
+ * Duration flags accept a sequence of numbers with units like `250ms`,
+ * `2m30s` or `1.5h` and store nanoseconds. Units are ns, us, µs, ms, s, m, h, d.
+ */
+DECLARE_C_FLAG_DEF(int64_t, duration)
+
+// clang-format off
+/**
+ * Declare `c_flag_*_list` function definitions for the element type.
+ *
+ * @param type Element type (int32_t, double, ...)
+ * @param postfix Function name postfix
+ */
+#define DECLARE_C_FLAG_LIST_DEF(type, postfix)                       \
+    C_FLAGS_EXPORT                                                   \
+    const type **c_flag_##postfix##_list(const char *long_name,      \
+                                         const char *short_name,     \
+                                         const char *desc,           \
+                                         const char *default_val);   \
+                                                                     \
+    C_FLAGS_EXPORT                                                   \
+    bool c_flag_##postfix##_list_var(const type **var,               \
+                                     const char *long_name,          \
+                                     const char *short_name,         \
+                                     const char *desc,               \
+                                     const char *default_val);
+// clang-format on
+
+/*
+ * List flags accept numbers separated by commas or whitespace like `1,2,3`
+ * or `1 2 3` and store them in one contiguous array, the number of elements
+ * is returned by `c_flags_list_size()`. The default is a list in the same
+ * syntax or NULL for the empty list, the empty list is a NULL array.
+ * Invalid values are reported with the index of the invalid element.
+ *
+ *  const int64_t **ids = c_flag_int64_list("shard-ids", NULL, "shard ids", NULL);
+ *  for (size_t i = 0; i < c_flags_list_size(*ids); i++) ...
+ *
+ * Functions return NULL or false if out of memory.
+ */
+DECLARE_C_FLAG_LIST_DEF(int32_t, int32)
+DECLARE_C_FLAG_LIST_DEF(int64_t, int64)
+DECLARE_C_FLAG_LIST_DEF(uint32_t, uint32)
+DECLARE_C_FLAG_LIST_DEF(uint64_t, uint64)
+DECLARE_C_FLAG_LIST_DEF(double, double)
+
+/**
+ * Get number of elements of the list flag value.
+ *
+ * @param values Array of the list flag
+ * @return Number of elements, 0 for NULL
+ */
+C_FLAGS_EXPORT
+size_t c_flags_list_size(const void *values);
+
+/**
+ * Declare flag which value is bytes given as `hex:` or `base64:` value like
+ * `hex:00ff` or `base64:AP8=` and decoded while parsing into one array,
+ * the number of bytes is returned by `c_flags_list_size()`. Hex digits are
+ * case-insensitive, base64 uses the standard alphabet with padding. The empty
+ * value gives no bytes and a NULL array.
+ *
+ *  const uint8_t **key = c_flag_binary("key", "k", "encryption key", NULL);
+ *  encrypt(*key, c_flags_list_size(*key));
+ *
+ * @param long_name Long name of the flag
+ * @param short_name Short name of the flag or NULL
+ * @param desc Description of the flag or NULL
+ * @param default_val Default value in the same syntax or NULL
+ * @return Pointer to the array or NULL if out of memory
+ */
+C_FLAGS_EXPORT
+const uint8_t **c_flag_binary(const char *long_name,
+                              const char *short_name,
+                              const char *desc,
+                              const char *default_val);
+
+/**
+ * Declare binary flag stored in the variable, see `c_flag_binary()`.
+ *
+ * @return true on success, false if out of memory
+ */
+C_FLAGS_EXPORT
+bool c_flag_binary_var(const uint8_t **var,
+                       const char *long_name,
+                       const char *short_name,
+                       const char *desc,
+                       const char *default_val);
+
+/*
+ * Counter flags count their occurrences on the command line, `-v -v`,
+ * `--verbose --verbose` and `-vv` all give 2. `--verbose=5` sets the count,
+ * configs and the control socket set it too.
+ */
+DECLARE_C_FLAG_DEF(unsigned, counter)
+
+/**
+ * Declare flag that collects every occurrence on the command line, for example
+ * `-I a -I b` gives `{"a", "b", NULL}`. The value is a NULL-terminated array
+ * that references argv, all arrays of one parse are taken from one allocation
+ * sized from argc. A config or the control socket sets the only element.
+ *
+ *  char ***includes = c_flag_strings("include", "I", "include directories", NULL);
+ *  for (char **include = *includes; *include != NULL; include++) ...
+ *
+ * @param long_name Long name of the flag
+ * @param short_name Short name of the flag or NULL
+ * @param desc Description of the flag or NULL
+ * @param default_val NULL-terminated array or NULL for the empty array
+ * @return Pointer to the array that is never NULL
+ */
+C_FLAGS_EXPORT
+char ***c_flag_strings(const char *long_name,
+                       const char *short_name,
+                       const char *desc,
+                       char **default_val);
+
+/**
+ * Declare accumulating flag stored in the variable, see `c_flag_strings()`.
+ */
+C_FLAGS_EXPORT
+void c_flag_strings_var(char ***var,
+                        const char *long_name,
+                        const char *short_name,
+                        const char *desc,
+                        char **default_val);
+
+/**
+ * Declare flag which value is one of the names, for example `--io=epoll`.
+ * The value is the index of the name, so it can be used with the enum
+ * declared in the same order. Names are looked up with a perfect hash
+ * built at declaration, invalid values are reported with allowed names.
+ *
+ *  static const char *const io_names[] = {"uring", "epoll", "poll"};
+ *  int *io = c_flag_choice("io", NULL, "io backend", io_names, 3, IO_EPOLL);
+ *
+ * @param long_name Long name of the flag
+ * @param short_name Short name of the flag or NULL
+ * @param desc Description of the flag or NULL
+ * @param choices Allowed names, must stay alive while the flags are used
+ * @param count Number of names, up to 255
+ * @param default_val Index of the default name, less than `count`
+ * @return Pointer to the index of the name, or NULL if out of memory
+ */
+C_FLAGS_EXPORT
+int *c_flag_choice(const char *long_name,
+                   const char *short_name,
+                   const char *desc,
+                   const char *const *choices,
+                   size_t count,
+                   int default_val);
+
+/**
+ * Declare choice flag stored in the variable, see `c_flag_choice()`.
+ *
+ * @return true on success, false if out of memory
+ */
+C_FLAGS_EXPORT
+bool c_flag_choice_var(int *var,
+                       const char *long_name,
+                       const char *short_name,
+                       const char *desc,
+                       const char *const *choices,
+                       size_t count,
+                       int default_val);
+
+/**
+ * Declare flag which value is a set of comma-separated names, for example
+ * `--features=a,c,f`. The value is the bitmask with bits at name indexes,
+ * the empty value is the empty set.
+ *
+ * @param long_name Long name of the flag
+ * @param short_name Short name of the flag or NULL
+ * @param desc Description of the flag or NULL
+ * @param names Allowed names, must stay alive while the flags are used
+ * @param count Number of names, up to 64
+ * @param default_val Default bitmask
+ * @return Pointer to the bitmask, or NULL if out of memory
+ */
+C_FLAGS_EXPORT
+uint64_t *c_flag_set(const char *long_name,
+                     const char *short_name,
+                     const char *desc,
+                     const char *const *names,
+                     size_t count,
+                     uint64_t default_val);
+
+/**
+ * Declare set flag stored in the variable, see `c_flag_set()`.
+ *
+ * @return true on success, false if out of memory
+ */
+C_FLAGS_EXPORT
+bool c_flag_set_var(uint64_t *var,
+                    const char *long_name,
+                    const char *short_name,
+                    const char *desc,
+                    const char *const *names,
+                    size_t count,
+                    uint64_t default_val);
+
+#if defined(__linux__) && defined(CPU_SETSIZE)
+/**
+ * Declare flag which value is a set of CPUs in the Linux cpulist syntax,
+ * for example `--cpus=0-7,16-23:2,^4`. Items are CPU numbers, ranges, ranges
+ * with a stride `N-M:stride` or with groups `N-M:used/group` as in the kernel,
+ * and `all` for all online CPUs. Items with `^` are excluded from the set.
+ *
+ * The set must be non-empty and contain only online CPUs from
+ * `/sys/devices/system/cpu/online`. Help and errors show the set in the
+ * canonical form like `0-3,16,18,20,22`. The value points to the set kept
+ * by the library, so it can be passed directly to the affinity functions:
+ *
+ *  const cpu_set_t **cpus = c_flag_cpus("cpus", NULL, "worker CPUs", "all");
+ *  pthread_setaffinity_np(thread, sizeof(cpu_set_t), *cpus);
+ *
+ * Requires `_GNU_SOURCE` defined before including system headers.
+ *
+ * @param long_name Long name of the flag
+ * @param short_name Short name of the flag or NULL
+ * @param desc Description of the flag or NULL
+ * @param default_val Default CPU list
+ * @return Pointer to the CPU set. A default that is invalid on this machine
+ *         is reported, and the set holds all online CPUs instead
+ */
+C_FLAGS_EXPORT
+const cpu_set_t **c_flag_cpus(const char *long_name,
+                              const char *short_name,
+                              const char *desc,
+                              const char *default_val);
+
+/**
+ * Declare CPU set flag stored in the variable, see `c_flag_cpus()`.
+ *
+ * @return true on success, false if the default is invalid, the flag is
+ *         declared with all online CPUs anyway
+ */
+C_FLAGS_EXPORT
+bool c_flag_cpus_var(const cpu_set_t **var,
+                     const char *long_name,
+                     const char *short_name,
+                     const char *desc,
+                     const char *default_val);
+#endif
+
+#if defined(__linux__)
+/**
+ * How the path of a file flag is opened at parse time.
+ */
+typedef enum {
+    C_FLAGS_FILE_PATH,      // `O_PATH` descriptor of any file for `openat()` or `fstat()`
+    C_FLAGS_FILE_DIRECTORY, // descriptor of a directory for `openat()`
+    C_FLAGS_FILE_READ,      // descriptor of a file that is not a directory open for reading
+    C_FLAGS_FILE_MAP,       // read-only mapping of the whole regular file
+} CFlagsFileMode;
+
+/**
+ * File opened for a file flag.
+ */
+typedef struct
+{
+    const char *path; // path as it was given
+    int fd;           // descriptor, -1 for mapped files
+    const void *data; // mapped contents, NULL for other modes and empty files
+    size_t size;      // size of the file when it was opened
+} CFlagsFile;
+
+/**
+ * Declare flag which value is a path opened at parse time, so missing files
+ * and wrong file types are reported like other invalid values and the file
+ * is opened once for all users. A file stays open while a value or a default
+ * references it, a handle replaced at runtime is closed once the change is
+ * applied, so read the flag again after changes. The same unchanged file given
+ * again gets the same handle, which is shared by flags of the same mode, so read
+ * it with `pread()`. Snapshots and shared memory store the path and open it again.
+ *
+ *  const CFlagsFile **dict = c_flag_file("dict", NULL, "dictionary", C_FLAGS_FILE_MAP, NULL);
+ *  if (*dict != NULL)
+ *      load_dictionary((*dict)->data, (*dict)->size);
+ *
+ * @param long_name Long name of the flag
+ * @param short_name Short name of the flag or NULL
+ * @param desc Description of the flag or NULL
+ * @param mode How the file is opened
+ * @param default_val Path of the default file or NULL for no file
+ * @return Pointer to the file handle that is NULL if no file is given. A default
+ *         file that cannot be opened is reported, and the handle stays NULL
+ */
+C_FLAGS_EXPORT
+const CFlagsFile **c_flag_file(const char *long_name,
+                               const char *short_name,
+                               const char *desc,
+                               CFlagsFileMode mode,
+                               const char *default_val);
+
+/**
+ * Declare file flag stored in the variable, see `c_flag_file()`.
+ *
+ * @return true on success, false if the default file cannot be opened,
+ *         the flag is declared anyway
+ */
+C_FLAGS_EXPORT
+bool c_flag_file_var(const CFlagsFile **var,
+                     const char *long_name,
+                     const char *short_name,
+                     const char *desc,
+                     CFlagsFileMode mode,
+                     const char *default_val);
+#endif
+
+/**
+ * Index of a boolean flag in the packed bitset returned by `c_flags_bits()`.
+ */
+typedef unsigned CFlagsBit;
+
+/**
+ * Get index of the bitset word that holds the bit.
+ */
+#define C_FLAGS_BIT_WORD(bit) ((bit) / 64)
+
+/**
+ * Get mask of the bit inside of its bitset word.
+ */
+#define C_FLAGS_BIT_MASK(bit) ((uint64_t) 1 << ((bit) % 64))
+
+/**
+ * Test the boolean flag value in the bitset returned by `c_flags_bits()`.
+ */
+#define C_FLAGS_BIT_TEST(bits, bit) (((bits)[C_FLAGS_BIT_WORD(bit)] & C_FLAGS_BIT_MASK(bit)) != 0)
+
+/**
+ * Declare boolean flag stored as one bit of the packed bitset.
+ * Values are read with `C_FLAGS_BIT_TEST()`, several flags sharing a word
+ * can be tested with one load, for example:
+ *
+ *  CFlagsBit fast = c_flag_bit("fast", NULL, NULL, false);
+ *  CFlagsBit safe = c_flag_bit("safe", NULL, NULL, true);
+ *  const uint64_t *bits = c_flags_bits();
+ *
+ *  uint64_t word = bits[C_FLAGS_BIT_WORD(fast)];
+ *  if (word & (C_FLAGS_BIT_MASK(fast) | C_FLAGS_BIT_MASK(safe))) ...
+ *
+ * Bits are allocated in declaration order, so flags declared together share words.
+ * Bit flags are observed with `c_flags_observe_all()`, see `c_flags_bit_of()`.
+ *
+ * @param long_name Long name of the flag
+ * @param short_name Short name of the flag or NULL
+ * @param desc Description of the flag or NULL
+ * @param default_val Default value
+ * @return Index of the flag in the bitset
+ */
+C_FLAGS_EXPORT
+CFlagsBit c_flag_bit(const char *long_name,
+                     const char *short_name,
+                     const char *desc,
+                     bool default_val);
+
+/**
+ * Get cache line aligned bitset of the flags declared with `c_flag_bit()`.
+ * The pointer doesn't change, so it can be loaded once.
+ *
+ * @return Bitset words
+ */
+C_FLAGS_EXPORT
+const uint64_t *c_flags_bits(void);
+
+/**
+ * Get the bit of a bit flag changed at runtime. Observers registered with
+ * `c_flags_observe_all()` get an internal pointer for every changed bit flag,
+ * which is passed here to find out which bit has changed.
+ *
+ * @param changed Pointer from the array passed to the observer
+ * @param bit_ptr Pointer to store the bit
+ * @return true if the pointer belongs to a bit flag, otherwise false
+ */
+C_FLAGS_EXPORT
+bool c_flags_bit_of(const void *changed, CFlagsBit *bit_ptr);
+
+typedef enum {
+    C_FLAGS_FIELD_INT,
+    C_FLAGS_FIELD_INT8,
+    C_FLAGS_FIELD_INT16,
+    C_FLAGS_FIELD_INT32,
+    C_FLAGS_FIELD_INT64,
+    C_FLAGS_FIELD_UNSIGNED,
+    C_FLAGS_FIELD_UINT8,
+    C_FLAGS_FIELD_UINT16,
+    C_FLAGS_FIELD_UINT32,
+    C_FLAGS_FIELD_UINT64,
+    C_FLAGS_FIELD_SIZE_T,
+    C_FLAGS_FIELD_BOOL,
+    C_FLAGS_FIELD_STRING,
+    C_FLAGS_FIELD_FLOAT,
+    C_FLAGS_FIELD_DOUBLE,
+    C_FLAGS_FIELD_BYTES,
+    C_FLAGS_FIELD_DURATION,
+} CFlagsFieldType;
+
+/**
+ * Flag bound to a field of the config struct, see `c_flags_bind_struct()`.
+ */
+typedef struct
+{
+    CFlagsFieldType type;
+    size_t offset;
+    const char *long_name;
+    const char *short_name;
+    const char *desc;
+} CFlagsField;
+
+/**
+ * Describe flag bound to a struct field.
+ *
+ * @param type Field type suffix (INT, UINT64, STRING, ...)
+ * @param struct_type Config struct type
+ * @param member Field name of the config struct
+ * @param long_name Long name of the flag
+ * @param short_name Short name of the flag or NULL
+ * @param desc Description of the flag or NULL
+ */
+#define C_FLAGS_FIELD(type, struct_type, member, long_name, short_name, desc) \
+    {C_FLAGS_FIELD_##type, offsetof(struct_type, member), (long_name), (short_name), (desc)}
+
+/**
+ * Declare flags stored in the fields of the config struct.
+ * Current field values are used as default values, so initialize the struct first.
+ * The struct must stay alive while the flags are used. For example:
+ *
+ *  static Config config = {.batch = 64, .verbose = false};
+ *  static const CFlagsField fields[] = {
+ *      C_FLAGS_FIELD(SIZE_T, Config, batch, "batch", "b", "batch size"),
+ *      C_FLAGS_FIELD(BOOL, Config, verbose, "verbose", "v", NULL),
+ *  };
+ *
+ *  c_flags_bind_struct(&config, fields, sizeof(fields) / sizeof(fields[0]));
+ *
+ * @param config Pointer to the config struct
+ * @param fields Descriptions of bound fields
+ * @param count Number of fields
+ */
+C_FLAGS_EXPORT
+void c_flags_bind_struct(void *config, const CFlagsField *fields, size_t count);
+
 /**
  * Customize usage block of help message.
  * The final help message will contain the following block:
@@ -117,12 +591,443 @@ void c_flags_set_description(const char *description);
 C_FLAGS_EXPORT
 void c_flags_parse(int *argc_ptr, char ***argv_ptr, bool usage_on_error);
 
+/**
+ * Parse command line arguments like `c_flags_parse()`, but accept flags
+ * anywhere among positional arguments. All arguments after `--` are positional.
+ *
+ * The `argv` is reordered in place to the program name, the tokens of parsed
+ * flags in unspecified order and the positional arguments in their original
+ * order, then `argc` and `argv` are set to the positional arguments.
+ *
+ * @param argc_ptr Pointer to program argc
+ * @param argv_ptr Pointer to program argv
+ * @param usage_on_error Show usage on parsing error
+ */
+C_FLAGS_EXPORT
+void c_flags_parse_permute(int *argc_ptr, char ***argv_ptr, bool usage_on_error);
+
+/**
+ * Parse declared flags and keep other arguments for forwarding to another program.
+ * Unknown flags and positional arguments are forwarded in their original order,
+ * all arguments after `--` are forwarded as is. Values of unknown flags cannot
+ * be recognized, so they are forwarded like positional arguments.
+ *
+ * The `argv` is reordered in place to the program name, the tokens of parsed
+ * flags in unspecified order and the forwarded arguments, then `argc` and
+ * `argv` are set to the forwarded arguments. The forwarded arguments are
+ * terminated by the NULL of the original `argv`, and the element before them
+ * can be replaced with the wrapped program name, so `argv - 1` can be passed
+ * to `execv()` directly.
+ *
+ * @param argc_ptr Pointer to program argc
+ * @param argv_ptr Pointer to program argv
+ * @param usage_on_error Show usage on parsing error
+ */
+C_FLAGS_EXPORT
+void c_flags_parse_pass_through(int *argc_ptr, char ***argv_ptr, bool usage_on_error);
+
 /**
  * Show usage based on your declared flags.
+ * The usage is written to stdout like `c_flags_usage_to_file(stdout)`.
  */
 C_FLAGS_EXPORT
 void c_flags_usage(void);
 
+/**
+ * Callback receiving the whole usage text at once.
+ *
+ * @param text Usage text, it's valid until the flags are changed
+ * @param size Size of the usage text
+ * @param user_data User data passed to `c_flags_usage_to_sink()`
+ */
+typedef void (*CFlagsUsageSink)(const char *text, size_t size, void *user_data);
+
+/**
+ * Set width for wrapping descriptions in usage.
+ * By default descriptions are wrapped to the terminal width
+ * when usage is written to a terminal and aren't wrapped otherwise.
+ *
+ * @param width Width in columns, or 0 to detect the terminal width
+ */
+C_FLAGS_EXPORT
+void c_flags_set_usage_width(unsigned width);
+
+/**
+ * Get usage text. The text is rendered once and cached until flags
+ * are declared or help messages are customized.
+ *
+ * @param size_ptr Pointer to store size of the text, can be NULL
+ * @return Usage text, or NULL if out of memory
+ */
+C_FLAGS_EXPORT
+const char *c_flags_usage_text(size_t *size_ptr);
+
+/**
+ * Write usage to the file with a single call.
+ *
+ * @param file File to write usage to
+ */
+C_FLAGS_EXPORT
+void c_flags_usage_to_file(FILE *file);
+
+/**
+ * Write usage to the file descriptor with a single `write()` if possible.
+ *
+ * @param fd File descriptor to write usage to
+ * @return true on success, otherwise false
+ */
+C_FLAGS_EXPORT
+bool c_flags_usage_to_fd(int fd);
+
+/**
+ * Pass usage text to the callback.
+ *
+ * @param sink Callback receiving the usage text
+ * @param user_data User data passed to the callback
+ */
+C_FLAGS_EXPORT
+void c_flags_usage_to_sink(CFlagsUsageSink sink, void *user_data);
+
+/**
+ * Write shell completion script for declared flags.
+ * The script contains all flag names, so completion doesn't run the program.
+ *
+ * @param shell Shell name: "bash", "zsh" or "fish"
+ * @param program Program name or path the completion is registered for
+ * @param file File to write the script to
+ * @return true on success, false if shell is not supported
+ */
+C_FLAGS_EXPORT
+bool c_flags_completion_to_file(const char *shell, const char *program, FILE *file);
+
+/**
+ * Declare hidden `--completion <shell>` flag. When it is passed, the parse
+ * functions write completion script for argv[0] to stdout and exit, so scripts
+ * can be generated with `program --completion bash > program.bash`.
+ */
+C_FLAGS_EXPORT
+void c_flags_add_completion_flag(void);
+
+/**
+ * Callback notified about changed flag values.
+ *
+ * @param changed Array of pointers returned by `c_flag_*` functions for changed flags,
+ *                bit flags are identified with `c_flags_bit_of()`
+ * @param changed_size Number of changed flags
+ * @param user_data User data passed on observer registration
+ */
+typedef void (*CFlagsObserver)(const void *const *changed, size_t changed_size, void *user_data);
+
+/**
+ * Observe changes of the flag value made at runtime, for example by config reload.
+ * Changes applied together are coalesced, so the observer is called once
+ * per batch with all changed flags it observes, even if it observes several flags.
+ * Observers are identified by callback and user data pair.
+ *
+ * Observers are called after the change is applied and flags are unlocked, so
+ * they can read flags, publish them to shared memory, write snapshots or call
+ * `c_flags_to_argv()`. Observers must not change flags, for example by loading
+ * a config, such changes are applied without notifying observers.
+ *
+ * @param value Pointer returned by `c_flag_*` function
+ * @param observer Callback to notify
+ * @param user_data User data passed to the callback
+ * @return true on success, false if out of memory
+ */
+C_FLAGS_EXPORT
+bool c_flags_observe(const void *value, CFlagsObserver observer, void *user_data);
+
+/**
+ * Observe changes of all flag values made at runtime.
+ * The observer is called once per batch of changes with all changed flags.
+ *
+ * @param observer Callback to notify
+ * @param user_data User data passed to the callback
+ * @return true on success, false if out of memory
+ */
+C_FLAGS_EXPORT
+bool c_flags_observe_all(CFlagsObserver observer, void *user_data);
+
+/**
+ * Load flag values from config file.
+ * The config consists of `<long-name> = <value>` lines, empty lines
+ * and `# comment` lines. Boolean flags accept `true` and `false` values.
+ *
+ * The whole file is validated before any flag is changed, so an invalid
+ * config leaves the old values in place. Only flags whose values differ
+ * are changed, flags missing in the config keep their current values.
+ * A flag given several times takes the value of its last line.
+ *
+ * String values loaded from the config are owned by the library, a string
+ * pointer read before the reload is invalidated when the flag is changed.
+ *
+ * @param path Path to the config file
+ * @return Number of changed flags, or -1 if config cannot be read or is invalid
+ */
+C_FLAGS_EXPORT
+int c_flags_load_config(const char *path);
+
+/**
+ * Render current flag values to the argv array accepted by `c_flags_parse()`,
+ * for example to re-exec the program with the same flags. Overrides can be
+ * appended after the rendered flags, the last value of a flag wins.
+ *
+ * Booleans are rendered as `--flag` or `--flag=false`, other flags as `--flag`
+ * and value arguments, floating point values are converted back exactly.
+ * String flags with NULL value are skipped.
+ *
+ * The buffer is filled with NULL terminated array of `argc` pointers followed
+ * by the strings they point to, the first pointer is the passed program name.
+ *
+ * @param buffer Buffer aligned for pointers, or NULL to get the required size
+ * @param size Size of the buffer
+ * @param program Program name for argv[0], it is not copied
+ * @param all Render all flags instead of the flags with non-default values
+ * @param argc_ptr Pointer to store the number of rendered arguments
+ * @return Required size of the buffer, the buffer is not filled if it is smaller
+ */
+C_FLAGS_EXPORT
+size_t c_flags_to_argv_buffer(void *buffer, size_t size, const char *program, bool all,
+                              int *argc_ptr);
+
+/**
+ * Render current flag values to the argv array like `c_flags_to_argv_buffer()`
+ * using a single allocation.
+ *
+ * @param program Program name for argv[0], it is not copied
+ * @param all Render all flags instead of the flags with non-default values
+ * @param argc_ptr Pointer to store the number of rendered arguments
+ * @return Rendered argv array that must be released with `free()`, or NULL on error
+ */
+C_FLAGS_EXPORT
+char **c_flags_to_argv(const char *program, bool all, int *argc_ptr);
+
+/**
+ * Get size of the binary snapshot of current flag values.
+ *
+ * @return Size of the snapshot in bytes
+ */
+C_FLAGS_EXPORT
+size_t c_flags_snapshot_size(void);
+
+/**
+ * Write current flag values, string values and their sources to the binary
+ * snapshot. The snapshot doesn't contain pointers, so it can be passed
+ * to a child process and loaded with `c_flags_snapshot_load()` instead of
+ * parsing the command line again.
+ *
+ * @param buffer Buffer for the snapshot
+ * @param size Size of the buffer, see `c_flags_snapshot_size()`
+ * @return Size of the written snapshot, or 0 if buffer is too small
+ */
+C_FLAGS_EXPORT
+size_t c_flags_snapshot_write(void *buffer, size_t size);
+
+/**
+ * Load flag values from the binary snapshot.
+ * The process must declare the same flags in the same order as the process
+ * wrote the snapshot. Observers are not notified about loaded values.
+ *
+ * @param buffer Snapshot written by `c_flags_snapshot_write()`
+ * @param size Size of the snapshot
+ * @return true on success, false if snapshot is corrupted or has other layout
+ */
+C_FLAGS_EXPORT
+bool c_flags_snapshot_load(const void *buffer, size_t size);
+
+#if defined(__unix__) || defined(__APPLE__)
+/**
+ * Write the binary snapshot of current flag values to the file descriptor,
+ * for example to a temporary file or memfd inherited by child processes.
+ *
+ * @param fd File descriptor opened for writing
+ * @return true on success, otherwise false
+ */
+C_FLAGS_EXPORT
+bool c_flags_snapshot_write_fd(int fd);
+
+/**
+ * Load flag values from the binary snapshot stored in the file.
+ * The file is mapped to memory and string values point into the mapping
+ * without copying.
+ *
+ * @param fd File descriptor of the snapshot file opened for reading
+ * @return true on success, false if snapshot is corrupted or has other layout
+ */
+C_FLAGS_EXPORT
+bool c_flags_snapshot_load_fd(int fd);
+#endif
+
+/**
+ * Make flag values read-only, usually right after parsing.
+ * Values in the library storage are protected with page permissions, so any
+ * later write through a pointer returned by `c_flag_*` crashes the program,
+ * and threads can read frozen values without synchronization.
+ *
+ * Frozen flags cannot be changed by config reload, control socket, shared
+ * memory or snapshot loading, such changes are refused. Variables bound with
+ * `c_flag_*_var()` and `c_flags_bind_struct()` belong to the application
+ * and are not protected.
+ *
+ * @param report_writes Print the name of the flag written after freezing before
+ *                      crashing, supported on POSIX systems only
+ * @return true on success, false if memory protection is not supported or
+ *         pages of the system are larger than the library is built for
+ */
+C_FLAGS_EXPORT
+bool c_flags_freeze(bool report_writes);
+
+/**
+ * Check whether flags are frozen with `c_flags_freeze()`.
+ *
+ * @return true if flags are frozen, otherwise false
+ */
+C_FLAGS_EXPORT
+bool c_flags_is_frozen(void);
+
+#if defined(__linux__)
+/**
+ * Start watching config file for changes using inotify.
+ * The returned file descriptor becomes readable when the config directory
+ * has pending events, add it to your event loop and call
+ * `c_flags_watch_dispatch()` when it is readable.
+ *
+ * Only one config can be watched at a time.
+ *
+ * @param path Path to the config file
+ * @return Pollable file descriptor, or -1 on error
+ */
+C_FLAGS_EXPORT
+int c_flags_watch_config(const char *path);
+
+/**
+ * Handle pending watcher events and reload the config
+ * with `c_flags_load_config()` if it was changed.
+ *
+ * @return Number of changed flags, or -1 if reload failed
+ */
+C_FLAGS_EXPORT
+int c_flags_watch_dispatch(void);
+
+/**
+ * Stop watching config file and close the watcher file descriptor.
+ */
+C_FLAGS_EXPORT
+void c_flags_unwatch_config(void);
+
+/**
+ * Open Unix domain control socket for runtime inspection and update of flags.
+ * The socket accepts line based commands, every command is answered
+ * with `OK ...` or `ERR <message>` line:
+ *
+ *  LIST                          -> `<long-name> <source> <value>` lines, then `OK`
+ *  GET <long-name>               -> `OK <value>`
+ *  SET <long-name>=<value> ...   -> `OK <number of changed flags>`
+ *
+ * All values of one `SET` command are validated before any flag is changed
+ * and are applied together, so observers are notified once per command.
+ * Values of `SET` cannot contain spaces.
+ *
+ * The returned file descriptor becomes readable when the socket has pending
+ * events, add it to your event loop and call `c_flags_control_dispatch()`
+ * when it is readable, or serve the socket with `c_flags_control_start_thread()`.
+ *
+ * The socket is created with 0600 permissions, so only the user running the
+ * program can connect, put it into a directory with suitable permissions to
+ * share it with other users. A socket left at the path by a previous run is
+ * replaced, other files are not removed and opening fails with `EEXIST`.
+ *
+ * @param path Path of the socket
+ * @return Pollable file descriptor, or -1 on error
+ */
+C_FLAGS_EXPORT
+int c_flags_control_open(const char *path);
+
+/**
+ * Handle pending control socket connections and commands without blocking.
+ *
+ * @return 0 on success, or -1 on error
+ */
+C_FLAGS_EXPORT
+int c_flags_control_dispatch(void);
+
+/**
+ * Serve control socket on a dedicated thread.
+ * Observers of flags changed with the socket are called on this thread.
+ *
+ * @return true if the thread is started, otherwise false
+ */
+C_FLAGS_EXPORT
+bool c_flags_control_start_thread(void);
+
+/**
+ * Stop control thread if started, close control socket and its connections.
+ */
+C_FLAGS_EXPORT
+void c_flags_control_close(void);
+
+/**
+ * Create shared memory segment with current flag values for worker processes.
+ * The segment is created with `shm_open()` if name is passed, otherwise
+ * with `memfd_create()`, its file descriptor is inherited by forked workers.
+ *
+ * Flags changed at runtime, for example by config reload or control socket,
+ * are published to the segment automatically. The segment has room for string
+ * values twice as large as initial ones, changes that don't fit aren't published,
+ * the error is printed and workers keep previous values.
+ *
+ * @param name Name of the segment like "/app-flags", or NULL for anonymous segment
+ * @return File descriptor of the segment, or -1 on error
+ */
+C_FLAGS_EXPORT
+int c_flags_shm_create(const char *name);
+
+/**
+ * Publish current flag values to the shared memory segment.
+ * Workers see either old or new values of all flags, never a mix of them.
+ *
+ * @return true on success, false if string values exceed the segment capacity
+ */
+C_FLAGS_EXPORT
+bool c_flags_shm_publish(void);
+
+/**
+ * Attach read-only to the shared memory segment created by the master process.
+ * Workers must declare the same flags in the same order as the master.
+ *
+ * @param name Name of the segment passed to `c_flags_shm_create()`
+ * @return true on success, false if segment cannot be opened or has other layout
+ */
+C_FLAGS_EXPORT
+bool c_flags_shm_attach(const char *name);
+
+/**
+ * Attach read-only to the shared memory segment by its file descriptor,
+ * for example inherited from the master process.
+ *
+ * @param fd File descriptor returned by `c_flags_shm_create()`
+ * @return true on success, false if segment has other layout
+ */
+C_FLAGS_EXPORT
+bool c_flags_shm_attach_fd(int fd);
+
+/**
+ * Copy flag values published by the master into the local flags.
+ * It is cheap to call when nothing was published since the last call.
+ * Observers are notified about changed flags.
+ *
+ * @return Number of changed flags, or -1 on error
+ */
+C_FLAGS_EXPORT
+int c_flags_shm_sync(void);
+
+/**
+ * Unmap and close the shared memory segment.
+ */
+C_FLAGS_EXPORT
+void c_flags_shm_close(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "edit-distance.h"
+
+#define ED_WORD_BITS 64
+
+static size_t ed_histogram_bucket(char c)
+{
+    return (unsigned char) c % ED_HISTOGRAM_SIZE;
+}
+
+void ed_pattern_init(EditDistancePattern *pattern, StringView sv)
+{
+    memset(pattern, 0, sizeof(EditDistancePattern));
+    pattern->sv = sv;
+
+    for (size_t i = 0; i < sv.size; i++) {
+        if (i < ED_WORD_BITS)
+            pattern->peq[(unsigned char) sv.data[i]] |= (uint64_t) 1 << i;
+
+        pattern->histogram[ed_histogram_bucket(sv.data[i])] += 1;
+    }
+}
+
+/*
+ * Lower bound of the distance: every insertion or deletion changes the
+ * character counts by one, every substitution by two.
+ */
+static size_t ed_lower_bound(const EditDistancePattern *pattern, StringView sv)
+{
+    uint16_t histogram[ED_HISTOGRAM_SIZE] = {0};
+    size_t difference = 0;
+
+    for (size_t i = 0; i < sv.size; i++)
+        histogram[ed_histogram_bucket(sv.data[i])] += 1;
+
+    for (size_t i = 0; i < ED_HISTOGRAM_SIZE; i++) {
+        difference += (pattern->histogram[i] > histogram[i])
+                          ? (size_t) (pattern->histogram[i] - histogram[i])
+                          : (size_t) (histogram[i] - pattern->histogram[i]);
+    }
+
+    return (difference + 1) / 2;
+}
+
+/*
+ * Myers' bit-parallel algorithm in Hyyrö's formulation for the global
+ * distance, the pattern must fit into a single word.
+ */
+static size_t ed_distance_myers(const EditDistancePattern *pattern, StringView sv)
+{
+    size_t m = pattern->sv.size;
+    uint64_t last = (uint64_t) 1 << (m - 1);
+
+    uint64_t pv = (m == ED_WORD_BITS) ? ~(uint64_t) 0 : ((uint64_t) 1 << m) - 1;
+    uint64_t mv = 0;
+    size_t score = m;
+
+    for (size_t i = 0; i < sv.size; i++) {
+        uint64_t eq = pattern->peq[(unsigned char) sv.data[i]];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+
+        if (ph & last)
+            score += 1;
+        else if (mh & last)
+            score -= 1;
+
+        ph = (ph << 1) | 1;
+        mh = mh << 1;
+
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+
+    return score;
+}
+
+// classic dynamic programming for patterns longer than a word
+static size_t ed_distance_rows(StringView a, StringView b)
+{
+    size_t *row = malloc((b.size + 1) * sizeof(size_t));
+    if (row == NULL)
+        return SIZE_MAX;
+
+    for (size_t j = 0; j <= b.size; j++)
+        row[j] = j;
+
+    for (size_t i = 1; i <= a.size; i++) {
+        size_t diagonal = row[0];
+        row[0] = i;
+
+        for (size_t j = 1; j <= b.size; j++) {
+            size_t above = row[j];
+            size_t cost = diagonal + (a.data[i - 1] != b.data[j - 1]);
+
+            if (above + 1 < cost)
+                cost = above + 1;
+            if (row[j - 1] + 1 < cost)
+                cost = row[j - 1] + 1;
+
+            row[j] = cost;
+            diagonal = above;
+        }
+    }
+
+    size_t distance = row[b.size];
+    free(row);
+
+    return distance;
+}
+
+size_t ed_distance(const EditDistancePattern *pattern, StringView sv, size_t max_distance)
+{
+    size_t m = pattern->sv.size;
+    size_t length_difference = (m > sv.size) ? m - sv.size : sv.size - m;
+
+    if (length_difference > max_distance || ed_lower_bound(pattern, sv) > max_distance)
+        return max_distance + 1;
+
+    size_t distance;
+
+    if (m == 0)
+        distance = sv.size;
+    else if (m <= ED_WORD_BITS)
+        distance = ed_distance_myers(pattern, sv);
+    else
+        distance = ed_distance_rows(pattern->sv, sv);
+
+    return (distance > max_distance) ? max_distance + 1 : distance;
+}
+
+size_t ed_levenshtein(StringView a, StringView b)
+{
+    EditDistancePattern pattern;
+    ed_pattern_init(&pattern, a);
+
+    return ed_distance(&pattern, b, SIZE_MAX - 1);
+}
@@ -0,0 +1,60 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef EDIT_DISTANCE_H
+#define EDIT_DISTANCE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "string-view.h"
+
+#define ED_HISTOGRAM_SIZE 64
+
+typedef struct
+{
+    StringView sv;
+    uint64_t peq[256];
+    uint16_t histogram[ED_HISTOGRAM_SIZE];
+} EditDistancePattern;
+
+/**
+ * Prepare pattern for computing edit distances to many strings
+ *
+ * @param pattern pattern instance to initialize
+ * @param sv string view of the pattern, must outlive the pattern
+ */
+void ed_pattern_init(EditDistancePattern *pattern, StringView sv);
+
+/**
+ * Compute Levenshtein distance between pattern and string view.
+ * Strings that are obviously too far by length and character counts
+ * are rejected without computing the distance.
+ *
+ * @param pattern pattern instance
+ * @param sv string view to compare with
+ * @param max_distance maximum distance of interest
+ * @return distance, or `max_distance + 1` if distance is greater than `max_distance`
+ */
+size_t ed_distance(const EditDistancePattern *pattern, StringView sv, size_t max_distance);
+
+/**
+ * Compute Levenshtein distance between two string views
+ *
+ * @param a first string view instance
+ * @param b second string view instance
+ * @return distance
+ */
+size_t ed_levenshtein(StringView a, StringView b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EDIT_DISTANCE_H
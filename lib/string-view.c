@@ -53,14 +53,23 @@ bool sv_contains(StringView a, StringView b)
 
 int sv_index_of(StringView a, StringView b)
 {
-    StringView null = sv_from_string(NULL);
-
-    if (sv_equal(a, null) || sv_equal(b, null))
+    if (a.size == 0 || b.size == 0 || a.size < b.size)
         return -1;
 
-    char *pos = strstr(a.data, b.data);
-    if (pos == NULL)
-        return -1;
+    // the search stays within the view, which isn't terminated when it's a slice
+    const char *begin = a.data;
+    const char *last = a.data + (a.size - b.size);
+
+    while (begin <= last) {
+        const char *pos = memchr(begin, b.data[0], (size_t) (last - begin) + 1);
+        if (pos == NULL)
+            return -1;
+
+        if (!memcmp(pos, b.data, b.size))
+            return (int) (pos - a.data);
+
+        begin = pos + 1;
+    }
 
-    return (int) (pos - a.data);
+    return -1;
 }
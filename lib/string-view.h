@@ -80,7 +80,8 @@ bool sv_contains(StringView a, StringView b);
  *
  * @param a first string view instance
  * @param b second string view instance
- * @return index in `a` string if `a` contains `b`, otherwise -1
+ * @return index in `a` string if `a` contains `b`, otherwise -1, which is
+ *         also returned for an empty `b`
  */
 int sv_index_of(StringView a, StringView b);
 
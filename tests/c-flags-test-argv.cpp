@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+TEST(CFlagsTestsArgv, RoundTrip)
+{
+    int8_t *int8_value = c_flag_int8("argv-int8", nullptr, nullptr, 0);
+    int64_t *int64_value = c_flag_int64("argv-int64", nullptr, nullptr, 0);
+    uint64_t *uint64_value = c_flag_uint64("argv-uint64", nullptr, nullptr, 0);
+    bool *verbose = c_flag_bool("argv-verbose", "v", nullptr, false);
+    bool *color = c_flag_bool("argv-color", nullptr, nullptr, true);
+    char **name = c_flag_string("argv-name", "n", nullptr, "hello");
+    char **empty = c_flag_string("argv-empty", nullptr, nullptr, nullptr);
+    float *float_value = c_flag_float("argv-float", nullptr, nullptr, 0.0f);
+    double *double_value = c_flag_double("argv-double", nullptr, nullptr, 0.0);
+    double *third = c_flag_double("argv-third", nullptr, nullptr, 0.0);
+    unsigned *untouched = c_flag_unsigned("argv-untouched", nullptr, nullptr, 7);
+
+    const char *argv_raw[] = {"app",
+                              "--argv-int8",
+                              "-128",
+                              "--argv-int64",
+                              "-9223372036854775808",
+                              "--argv-uint64",
+                              "18446744073709551615",
+                              "-v",
+                              "--argv-color=false",
+                              "-n",
+                              "-dash",
+                              "--argv-float",
+                              "0.1",
+                              "--argv-double",
+                              "1e-300",
+                              "--argv-third",
+                              "0.3333333333333333"};
+    char **argv = (char **) argv_raw;
+    int argc = sizeof(argv_raw) / sizeof(argv_raw[0]);
+
+    c_flags_parse(&argc, &argv, false);
+
+    int rendered_argc = 0;
+    char **rendered_argv = c_flags_to_argv("app", false, &rendered_argc);
+    ASSERT_NE(rendered_argv, nullptr);
+    EXPECT_EQ(rendered_argv[rendered_argc], nullptr);
+
+    EXPECT_EQ(to_vector(rendered_argv, rendered_argc),
+              (std::vector<std::string>{
+                  "app",
+                  "--argv-int8",
+                  "-128",
+                  "--argv-int64",
+                  "-9223372036854775808",
+                  "--argv-uint64",
+                  "18446744073709551615",
+                  "--argv-verbose",
+                  "--argv-color=false",
+                  "--argv-name",
+                  "-dash",
+                  "--argv-float",
+                  "0.1",
+                  "--argv-double",
+                  "1e-300",
+                  "--argv-third",
+                  "0.3333333333333333",
+              }));
+
+    float expected_float = *float_value;
+    double expected_third = *third;
+
+    *int8_value = 0;
+    *int64_value = 0;
+    *uint64_value = 0;
+    *verbose = false;
+    *color = true;
+    *float_value = 0.0f;
+    *double_value = 0.0;
+    *third = 0.0;
+
+    argc = rendered_argc;
+    argv = rendered_argv;
+    c_flags_parse(&argc, &argv, false);
+
+    EXPECT_EQ(argc, 0);
+    EXPECT_EQ(*int8_value, INT8_MIN);
+    EXPECT_EQ(*int64_value, INT64_MIN);
+    EXPECT_EQ(*uint64_value, UINT64_MAX);
+    EXPECT_EQ(*verbose, true);
+    EXPECT_EQ(*color, false);
+    EXPECT_STREQ(*name, "-dash");
+    EXPECT_EQ(*empty, nullptr);
+    EXPECT_EQ(*float_value, expected_float);
+    EXPECT_EQ(*double_value, 1e-300);
+    EXPECT_EQ(*third, expected_third);
+    EXPECT_EQ(*untouched, 7U);
+
+    free(rendered_argv);
+}
+
+TEST(CFlagsTestsArgv, Buffer)
+{
+    int argc = 0;
+    size_t size = c_flags_to_argv_buffer(nullptr, 0, "app", true, &argc);
+
+    // all flags except the NULL string
+    EXPECT_EQ(argc, 19);
+
+    std::vector<char *> buffer(size / sizeof(char *) + 1);
+    EXPECT_EQ(c_flags_to_argv_buffer(buffer.data(), size - 1, "app", true, &argc), size);
+    EXPECT_EQ(buffer[0], nullptr);
+
+    EXPECT_EQ(c_flags_to_argv_buffer(buffer.data(), size, "app", true, &argc), size);
+    EXPECT_STREQ(buffer[0], "app");
+    EXPECT_STREQ(buffer[argc - 2], "--argv-untouched");
+    EXPECT_STREQ(buffer[argc - 1], "7");
+    EXPECT_EQ(buffer[argc], nullptr);
+}
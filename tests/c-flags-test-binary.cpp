@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+TEST(CFlagsTestsBinary, Values)
+{
+    static const uint8_t *salt = nullptr;
+
+    const uint8_t **key = c_flag_binary("key", "k", "encryption key", "hex:00FFa0");
+    const uint8_t **id = c_flag_binary("id", nullptr, nullptr, nullptr);
+
+    ASSERT_NE(key, nullptr);
+    ASSERT_NE(id, nullptr);
+    ASSERT_TRUE(c_flag_binary_var(&salt, "salt", nullptr, nullptr, "base64:AP8="));
+
+    EXPECT_EQ(to_vector(*key), (std::vector<uint8_t> {0x00, 0xFF, 0xA0}));
+    EXPECT_EQ(*id, nullptr);
+    EXPECT_EQ(to_vector(salt), (std::vector<uint8_t> {0x00, 0xFF}));
+
+    const char *argv_raw[] = {"app", "-k", "hex:0123456789abcdefABCDEF", "--id=base64:aGVsbG8="};
+    char **argv = (char **) argv_raw;
+    int argc = 4;
+
+    c_flags_parse(&argc, &argv, false);
+
+    EXPECT_EQ(to_vector(*key),
+              (std::vector<uint8_t> {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0xAB, 0xCD,
+                                     0xEF}));
+    EXPECT_EQ(std::string((const char *) *id, c_flags_list_size(*id)), "hello");
+
+    for (const char *value : {"hex:", "base64:", ""}) {
+        ASSERT_NE(load_value("id", value), -1) << value;
+        EXPECT_EQ(*id, nullptr);
+    }
+
+    ASSERT_NE(load_value("id", "base64:aGk="), -1);
+    EXPECT_EQ(std::string((const char *) *id, c_flags_list_size(*id)), "hi");
+
+    for (const char *value : {"00ff", "HEX:00", "hex:0", "hex:0g", "hex:00 ff", "hex:0x00",
+                              "base64:AP8", "base64:AP9=", "base64:AB==", "base64:A===",
+                              "base64:====", "base64:AP8=AP8=", "base64:aGVs-G8=", "base64:aGk"}) {
+        ASSERT_EQ(load_value("id", value), -1) << value;
+    }
+
+    std::string usage = c_flags_usage_text(nullptr);
+    EXPECT_NE(usage.find("       Default: base64:AP+g\n"), std::string::npos);
+
+    int rendered_argc = 0;
+    char **rendered_argv = c_flags_to_argv("app", false, &rendered_argc);
+    ASSERT_NE(rendered_argv, nullptr);
+
+    std::vector<std::string> rendered(rendered_argv + 1, rendered_argv + rendered_argc);
+    free(rendered_argv);
+
+    EXPECT_EQ(rendered,
+              (std::vector<std::string> {"--key", "base64:ASNFZ4mrze+rze8=", "--id",
+                                         "base64:aGk="}));
+
+#if defined(__unix__) || defined(__APPLE__)
+    ASSERT_EXIT(parse_to_stderr("--key", "hex:00112233445566778899aabbccddeeff00112233zz"),
+                testing::ExitedWithCode(1),
+                "invalid value hex:00112233445566778899aabbccdd\\.\\.\\. \\(invalid hex digit at "
+                "offset 44\\) for binary flag --key");
+    ASSERT_EXIT(parse_to_stderr("--key", "hex:abc"),
+                testing::ExitedWithCode(1),
+                "invalid value hex:abc \\(odd number of hex digits\\) for binary flag --key");
+    ASSERT_EXIT(parse_to_stderr("--key", "00"),
+                testing::ExitedWithCode(1),
+                "invalid value 00 \\(expected hex: or base64: prefix\\) for binary flag --key");
+#endif
+}
+
+static std::string base64_encode(const uint8_t *data, size_t size)
+{
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string result;
+
+    for (size_t i = 0; i < size; i += 3) {
+        uint32_t bits = (uint32_t) data[i] << 16;
+        if (i + 1 < size)
+            bits |= (uint32_t) data[i + 1] << 8;
+        if (i + 2 < size)
+            bits |= data[i + 2];
+
+        result += alphabet[bits >> 18];
+        result += alphabet[(bits >> 12) & 0x3F];
+        result += i + 1 < size ? alphabet[(bits >> 6) & 0x3F] : '=';
+        result += i + 2 < size ? alphabet[bits & 0x3F] : '=';
+    }
+
+    return result;
+}
+
+// every length and position of the invalid character goes through vector, word and tail paths
+TEST(CFlagsTestsBinary, Large)
+{
+    const uint8_t **blob = c_flag_binary("blob", nullptr, nullptr, nullptr);
+    ASSERT_NE(blob, nullptr);
+
+    static const char digits[] = "0123456789abcdef";
+    std::vector<uint8_t> expected;
+    std::string hex = "hex:";
+
+    for (size_t i = 0; i < 4099; i++) {
+        uint8_t byte = (uint8_t) (i * 131 + 7);
+
+        expected.push_back(byte);
+        hex += digits[byte >> 4];
+        hex += digits[byte & 0x0F];
+    }
+
+    ASSERT_NE(load_value("blob", hex), -1);
+    ASSERT_EQ(to_vector(*blob), expected);
+
+    // the rendered base64 value is decoded into the same bytes
+    int rendered_argc = 0;
+    char **rendered_argv = c_flags_to_argv("app", false, &rendered_argc);
+    ASSERT_NE(rendered_argv, nullptr);
+
+    std::string base64;
+    for (int i = 1; i + 1 < rendered_argc; i++) {
+        if (std::string(rendered_argv[i]) == "--blob")
+            base64 = rendered_argv[i + 1];
+    }
+
+    free(rendered_argv);
+
+    ASSERT_NE(load_value("blob", "hex:00"), -1);
+    ASSERT_NE(load_value("blob", base64), -1);
+    ASSERT_EQ(to_vector(*blob), expected);
+
+    for (size_t size = 0; size < 40; size++) {
+        std::string value = "hex:" + hex.substr(4, size * 2);
+
+        ASSERT_NE(load_value("blob", value), -1) << value;
+        ASSERT_EQ(to_vector(*blob),
+                  std::vector<uint8_t>(expected.begin(), expected.begin() + size));
+
+        for (size_t i = 4; i < value.size(); i++) {
+            std::string invalid = value;
+            invalid[i] = i % 2 == 0 ? 'g' : '\xc0';
+
+            ASSERT_EQ(load_value("blob", invalid), -1) << invalid;
+        }
+    }
+
+    for (size_t size = 0; size < 64; size++) {
+        std::string value = "base64:" + base64_encode(expected.data(), size);
+
+        ASSERT_NE(load_value("blob", value), -1) << value;
+        ASSERT_EQ(to_vector(*blob),
+                  std::vector<uint8_t>(expected.begin(), expected.begin() + size));
+
+        for (size_t i = 7; i < value.size() && value[i] != '='; i++) {
+            std::string invalid = value;
+            invalid[i] = i % 2 == 0 ? '-' : '\xc0';
+
+            ASSERT_EQ(load_value("blob", invalid), -1) << invalid;
+        }
+    }
+
+    ASSERT_NE(load_value("blob", "hex:" + hex.substr(4, 78)), -1);
+
+    std::vector<unsigned char> snapshot(c_flags_snapshot_size());
+    ASSERT_EQ(c_flags_snapshot_write(snapshot.data(), snapshot.size()), snapshot.size());
+
+    ASSERT_NE(load_value("blob", "hex:01"), -1);
+    ASSERT_TRUE(c_flags_snapshot_load(snapshot.data(), snapshot.size()));
+    ASSERT_EQ(c_flags_list_size(*blob), 39u);
+}
@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+typedef struct
+{
+    bool verbose;
+    uint8_t level;
+    size_t batch;
+    char *output;
+    double ratio;
+} Config;
+
+static int jobs = 0;
+static Config config = {false, 1, 64, nullptr, 0.5};
+
+static const CFlagsField fields[] = {
+    C_FLAGS_FIELD(BOOL, Config, verbose, "verbose", "v", "verbose output"),
+    C_FLAGS_FIELD(UINT8, Config, level, "level", "l", nullptr),
+    C_FLAGS_FIELD(SIZE_T, Config, batch, "batch", "b", nullptr),
+    C_FLAGS_FIELD(STRING, Config, output, "output", "o", nullptr),
+    C_FLAGS_FIELD(DOUBLE, Config, ratio, "ratio", nullptr, nullptr),
+};
+
+TEST(CFlagsTestsBind, VariablesAndStruct)
+{
+    c_flag_int_var(&jobs, "jobs", "j", "number of jobs", 4);
+    c_flags_bind_struct(&config, fields, sizeof(fields) / sizeof(fields[0]));
+
+    ASSERT_EQ(jobs, 4);
+    ASSERT_EQ(config.verbose, false);
+    ASSERT_EQ(config.level, 1);
+    ASSERT_EQ(config.batch, 64u);
+    ASSERT_EQ(config.output, nullptr);
+    ASSERT_EQ(config.ratio, 0.5);
+
+    const char *argv_raw[] = {"app", "-j", "8", "-v", "-l", "255", "--output", "out.txt", "file"};
+    char **argv = (char **) argv_raw;
+    int argc = 9;
+
+    c_flags_parse(&argc, &argv, false);
+
+    ASSERT_EQ(argc, 1);
+    ASSERT_STREQ(argv[0], "file");
+
+    ASSERT_EQ(jobs, 8);
+    ASSERT_EQ(config.verbose, true);
+    ASSERT_EQ(config.level, 255);
+    ASSERT_EQ(config.batch, 64u);
+    ASSERT_STREQ(config.output, "out.txt");
+    ASSERT_EQ(config.ratio, 0.5);
+
+    // bound variables are used like returned pointers
+    char **rendered = c_flags_to_argv("app", false, &argc);
+
+    ASSERT_NE(rendered, nullptr);
+    ASSERT_EQ(argc, 8);
+    ASSERT_STREQ(rendered[1], "--jobs");
+    ASSERT_STREQ(rendered[2], "8");
+    ASSERT_STREQ(rendered[3], "--verbose");
+    ASSERT_STREQ(rendered[4], "--level");
+    ASSERT_STREQ(rendered[5], "255");
+    ASSERT_STREQ(rendered[6], "--output");
+    ASSERT_STREQ(rendered[7], "out.txt");
+
+    free(rendered);
+}
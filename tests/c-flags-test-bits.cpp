@@ -0,0 +1,79 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+// flag names must stay alive while the flags are used
+static std::string names[40];
+
+TEST(CFlagsTestsBits, PackedBooleans)
+{
+    CFlagsBit toggles[40];
+
+    for (size_t i = 0; i < 40; i++) {
+        names[i] = "toggle-" + std::to_string(i);
+        toggles[i] = c_flag_bit(names[i].c_str(), nullptr, nullptr, i % 2 == 0);
+    }
+
+    int *jobs = c_flag_int("jobs", "j", nullptr, 1);
+    CFlagsBit fast = c_flag_bit("fast", "f", nullptr, false);
+    CFlagsBit safe = c_flag_bit("safe", "s", nullptr, true);
+
+    const uint64_t *bits = c_flags_bits();
+
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(bits) % 64, 0u);
+    ASSERT_EQ(fast, 40u);
+    ASSERT_EQ(safe, 41u);
+
+    for (size_t i = 0; i < 40; i++)
+        ASSERT_EQ(C_FLAGS_BIT_TEST(bits, toggles[i]), i % 2 == 0);
+
+    ASSERT_FALSE(C_FLAGS_BIT_TEST(bits, fast));
+    ASSERT_TRUE(C_FLAGS_BIT_TEST(bits, safe));
+
+    const char *argv_raw[] = {
+        "app", "-f", "--safe=false", "--toggle-0=false", "--toggle-1", "-j", "4",
+    };
+    char **argv = (char **) argv_raw;
+    int argc = 7;
+
+    c_flags_parse(&argc, &argv, false);
+
+    ASSERT_EQ(argc, 0);
+    ASSERT_EQ(*jobs, 4);
+
+    ASSERT_TRUE(C_FLAGS_BIT_TEST(bits, fast));
+    ASSERT_FALSE(C_FLAGS_BIT_TEST(bits, safe));
+    ASSERT_FALSE(C_FLAGS_BIT_TEST(bits, toggles[0]));
+    ASSERT_TRUE(C_FLAGS_BIT_TEST(bits, toggles[1]));
+    ASSERT_TRUE(C_FLAGS_BIT_TEST(bits, toggles[2]));
+
+    // several toggles of one word are tested with one load
+    ASSERT_EQ(C_FLAGS_BIT_WORD(toggles[1]), C_FLAGS_BIT_WORD(toggles[2]));
+
+    uint64_t word = bits[C_FLAGS_BIT_WORD(toggles[1])];
+    uint64_t mask = C_FLAGS_BIT_MASK(toggles[1]) | C_FLAGS_BIT_MASK(toggles[2]);
+
+    ASSERT_EQ(word & mask, mask);
+
+    // packed flags are rendered like other boolean flags
+    char **rendered = c_flags_to_argv("app", false, &argc);
+
+    ASSERT_NE(rendered, nullptr);
+    ASSERT_EQ(argc, 7);
+    ASSERT_STREQ(rendered[1], "--toggle-0=false");
+    ASSERT_STREQ(rendered[2], "--toggle-1");
+    ASSERT_STREQ(rendered[3], "--jobs");
+    ASSERT_STREQ(rendered[4], "4");
+    ASSERT_STREQ(rendered[5], "--fast");
+    ASSERT_STREQ(rendered[6], "--safe=false");
+
+    free(rendered);
+}
@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+enum { IO_URING, IO_EPOLL, IO_POLL };
+
+static const char *const io_names[] = {"uring", "epoll", "poll"};
+static const char *const feature_names[] = {"a", "b", "c", "d", "e", "f"};
+
+TEST(CFlagsTestsChoice, Values)
+{
+    int *io = c_flag_choice("io", nullptr, "io backend", io_names, 3, IO_EPOLL);
+    uint64_t *features = c_flag_set("features", "F", "enabled features", feature_names, 6, 0x3);
+
+    ASSERT_NE(io, nullptr);
+    ASSERT_NE(features, nullptr);
+    ASSERT_EQ(*io, IO_EPOLL);
+    ASSERT_EQ(*features, 0x3u);
+
+    const char *argv_raw[] = {"app", "--io=uring", "-F", "a,c,f"};
+    char **argv = (char **) argv_raw;
+    int argc = 4;
+
+    c_flags_parse(&argc, &argv, false);
+
+    ASSERT_EQ(*io, IO_URING);
+    ASSERT_EQ(*features, (1u << 0) | (1u << 2) | (1u << 5));
+
+    ASSERT_NE(load_value("io", "poll"), -1);
+    ASSERT_EQ(*io, IO_POLL);
+
+    ASSERT_NE(load_value("features", "f,f,b"), -1);
+    ASSERT_EQ(*features, (1u << 1) | (1u << 5));
+
+    ASSERT_NE(load_value("features", ""), -1);
+    ASSERT_EQ(*features, 0u);
+
+    for (const char *value : {"select", "epol", "epollx", "URING", ""})
+        ASSERT_EQ(load_value("io", value), -1) << value;
+
+    for (const char *value : {"a,", ",a", "a,,b", "g", "a,bc"})
+        ASSERT_EQ(load_value("features", value), -1) << value;
+
+    ASSERT_EQ(*io, IO_POLL);
+    ASSERT_EQ(*features, 0u);
+
+    std::string usage = c_flags_usage_text(nullptr);
+
+    ASSERT_NE(usage.find("       Allowed: uring, epoll, poll\n"
+                         "       Default: epoll\n"),
+              std::string::npos);
+    ASSERT_NE(usage.find("       Allowed: a, b, c, d, e, f\n"
+                         "       Default: a,b\n"),
+              std::string::npos);
+
+#if defined(__unix__) || defined(__APPLE__)
+    ASSERT_EXIT(parse_to_stderr("--io", "select"),
+                testing::ExitedWithCode(1),
+                "invalid value select for choice flag --io\n"
+                "       allowed values: uring, epoll, poll");
+#endif
+}
+
+// perfect hash finds every name of large sets and rejects others
+TEST(CFlagsTestsChoice, ManyNames)
+{
+    static std::string names[255];
+    static const char *name_ptrs[255];
+
+    for (size_t i = 0; i < 255; i++) {
+        names[i] = "name-" + std::to_string(i * 7919);
+        name_ptrs[i] = names[i].c_str();
+    }
+
+    int *choice = c_flag_choice("many", nullptr, nullptr, name_ptrs, 255, 0);
+    ASSERT_NE(choice, nullptr);
+
+    for (size_t i = 0; i < 255; i++) {
+        ASSERT_NE(load_value("many", name_ptrs[i]), -1) << name_ptrs[i];
+        ASSERT_EQ(*choice, (int) i);
+    }
+
+    ASSERT_EQ(load_value("many", "name-1"), -1);
+    ASSERT_EQ(load_value("many", "name-"), -1);
+}
+
+#if !defined(NDEBUG)
+TEST(CFlagsTestsChoice, DefaultOutOfRange)
+{
+    EXPECT_DEATH(c_flag_choice("io-out-of-range", nullptr, nullptr, io_names, 3, 3),
+                 "the default value must be an index of the choices");
+    EXPECT_DEATH(c_flag_choice("io-negative", nullptr, nullptr, io_names, 3, -1),
+                 "the default value must be an index of the choices");
+}
+#endif
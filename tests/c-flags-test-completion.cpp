@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+static std::string completion(const char *shell)
+{
+    FILE *file = tmpfile();
+    EXPECT_NE(file, nullptr);
+
+    EXPECT_TRUE(c_flags_completion_to_file(shell, "/usr/bin/tool", file));
+
+    std::string content;
+    char buffer[256];
+    size_t size;
+
+    rewind(file);
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        content.append(buffer, size);
+
+    fclose(file);
+    return content;
+}
+
+TEST(CFlagsTestsCompletion, Scripts)
+{
+    c_flag_bool("verbose", "v", "verbose mode", false);
+    c_flag_uint64("batch-size", "bs", "declare [batch] size", 32);
+    c_flag_string("output", nullptr, "output file", nullptr);
+    c_flags_add_completion_flag();
+
+    std::string bash = completion("bash");
+    EXPECT_NE(bash.find("compgen -W '--batch-size -bs --output --verbose -v'"), std::string::npos);
+    EXPECT_NE(bash.find("'--batch-size'|'-bs')\n        COMPREPLY=()"), std::string::npos);
+    EXPECT_NE(bash.find("'--output')\n        COMPREPLY=($(compgen -f"), std::string::npos);
+    EXPECT_NE(bash.find("complete -F _c_flags_tool 'tool'\n"), std::string::npos);
+
+    std::string zsh = completion("zsh");
+    EXPECT_EQ(zsh.find("#compdef tool\n"), 0U);
+    EXPECT_NE(zsh.find("'(--batch-size -bs)'{--batch-size,-bs}'[declare \\[batch\\] size]"
+                       ":uint64_t: ' \\\n"
+                       "    '--output[output file]:string:_files' \\\n"
+                       "    '(--verbose -v)'{--verbose,-v}'[verbose mode]' \\\n"),
+              std::string::npos);
+
+    std::string fish = completion("fish");
+    EXPECT_NE(fish.find("complete -c 'tool' -l 'batch-size' -o 'bs' -x -d 'declare [batch] size'\n"
+                        "complete -c 'tool' -l 'output' -r -F -d 'output file'\n"
+                        "complete -c 'tool' -l 'verbose' -o 'v' -d 'verbose mode'\n"),
+              std::string::npos);
+
+    // the completion flag is hidden
+    EXPECT_EQ(bash.find("--completion"), std::string::npos);
+    EXPECT_EQ(std::string(c_flags_usage_text(nullptr)).find("--completion"), std::string::npos);
+
+    EXPECT_FALSE(c_flags_completion_to_file("tcsh", "tool", stdout));
+}
+
+TEST(CFlagsTestsCompletion, Flag)
+{
+    const char *argv_raw[] = {"/usr/bin/tool", "--completion", "fish"};
+    char **argv = (char **) argv_raw;
+    int argc = 3;
+
+    EXPECT_EXIT(c_flags_parse(&argc, &argv, false), ::testing::ExitedWithCode(0), "");
+
+    const char *argv_unknown_raw[] = {"/usr/bin/tool", "--completion", "tcsh"};
+    argv = (char **) argv_unknown_raw;
+    argc = 3;
+
+    EXPECT_EXIT(c_flags_parse(&argc, &argv, false), ::testing::ExitedWithCode(1), "");
+}
@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#if defined(__linux__)
+#include <poll.h>
+#endif
+
+static std::string write_config(const char *name, const char *content)
+{
+    std::string path = testing::TempDir() + name;
+    std::string tmp_path = path + ".tmp";
+
+    FILE *file = fopen(tmp_path.c_str(), "wb");
+    fputs(content, file);
+    fclose(file);
+
+    std::rename(tmp_path.c_str(), path.c_str());
+    return path;
+}
+
+TEST(CFlagsTestsConfig, Positive)
+{
+    int *int_value = c_flag_int("config-int", nullptr, nullptr, 0);
+    uint64_t *uint64_value = c_flag_uint64("config-uint64", nullptr, nullptr, 0);
+    bool *bool_value = c_flag_bool("config-bool", nullptr, nullptr, false);
+    char **string_value = c_flag_string("config-string", nullptr, nullptr, "hello");
+    double *double_value = c_flag_double("config-double", nullptr, nullptr, 0.0);
+
+    std::string path = write_config("c-flags-config-positive.conf",
+                                    "# comment\n"
+                                    "\n"
+                                    "config-int = -1\n"
+                                    "  --config-uint64=64  \n"
+                                    "config-bool = true\n"
+                                    "config-string = hello world\n"
+                                    "config-double = 1.5\n");
+
+    EXPECT_EQ(c_flags_load_config(path.c_str()), 5);
+
+    EXPECT_EQ(*int_value, -1);
+    EXPECT_EQ(*uint64_value, 64U);
+    EXPECT_EQ(*bool_value, true);
+    EXPECT_STREQ(*string_value, "hello world");
+    EXPECT_EQ(*double_value, 1.5);
+
+    path = write_config("c-flags-config-positive.conf",
+                        "config-int = -1\n"
+                        "config-uint64 = 65\n"
+                        "config-string = hello world\n");
+
+    EXPECT_EQ(c_flags_load_config(path.c_str()), 1);
+    EXPECT_EQ(*uint64_value, 65U);
+    EXPECT_STREQ(*string_value, "hello world");
+
+    // only the last occurrence of a flag is applied
+    path = write_config("c-flags-config-positive.conf",
+                        "config-int = 5\n"
+                        "config-string = first\n"
+                        "config-int = -1\n"
+                        "config-string = second\n");
+
+    EXPECT_EQ(c_flags_load_config(path.c_str()), 1);
+    EXPECT_EQ(*int_value, -1);
+    EXPECT_STREQ(*string_value, "second");
+}
+
+TEST(CFlagsTestsConfig, NegativeKeepsOldValues)
+{
+    int *int_value = c_flag_int("config-atomic-int", nullptr, nullptr, 1);
+    int8_t *int8_value = c_flag_int8("config-atomic-int8", nullptr, nullptr, 1);
+
+    std::string path = write_config("c-flags-config-negative.conf",
+                                    "config-atomic-int = 2\n"
+                                    "config-atomic-int8 = 128\n");
+
+    EXPECT_EQ(c_flags_load_config(path.c_str()), -1);
+    EXPECT_EQ(*int_value, 1);
+    EXPECT_EQ(*int8_value, 1);
+
+    path = write_config("c-flags-config-negative.conf", "config-atomic-unknown = 2\n");
+    EXPECT_EQ(c_flags_load_config(path.c_str()), -1);
+
+    path = write_config("c-flags-config-negative.conf", "config-atomic-int\n");
+    EXPECT_EQ(c_flags_load_config(path.c_str()), -1);
+
+    EXPECT_EQ(c_flags_load_config("/nonexistent/c-flags.conf"), -1);
+}
+
+#if defined(__linux__)
+TEST(CFlagsTestsConfig, WatchReload)
+{
+    int *int_value = c_flag_int("config-watch-int", nullptr, nullptr, 0);
+    std::string path = write_config("c-flags-config-watch.conf", "config-watch-int = 1\n");
+
+    int fd = c_flags_watch_config(path.c_str());
+    ASSERT_GE(fd, 0);
+
+    EXPECT_EQ(c_flags_watch_dispatch(), 0);
+
+    write_config("c-flags-config-watch.conf", "config-watch-int = 2\n");
+
+    struct pollfd pfd = {fd, POLLIN, 0};
+    ASSERT_EQ(poll(&pfd, 1, 1000), 1);
+
+    EXPECT_EQ(c_flags_watch_dispatch(), 1);
+    EXPECT_EQ(*int_value, 2);
+
+    write_config("c-flags-config-watch.conf", "config-watch-int = a\n");
+    ASSERT_EQ(poll(&pfd, 1, 1000), 1);
+
+    EXPECT_EQ(c_flags_watch_dispatch(), -1);
+    EXPECT_EQ(*int_value, 2);
+
+    c_flags_unwatch_config();
+}
+#endif
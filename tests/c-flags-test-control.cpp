@@ -0,0 +1,202 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#if defined(__linux__)
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+static int connect_control(const std::string &path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    struct sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    if (connect(fd, (struct sockaddr *) &address, sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+// read response lines until status line
+static std::string request(int fd, const std::string &command)
+{
+    std::string line = command + "\n";
+    EXPECT_EQ(write(fd, line.data(), line.size()), (ssize_t) line.size());
+
+    std::string response;
+    char c;
+
+    while (read(fd, &c, 1) == 1) {
+        response += c;
+
+        if (c != '\n')
+            continue;
+
+        size_t line_start = response.rfind('\n', response.size() - 2);
+        line_start = (line_start == std::string::npos) ? 0 : line_start + 1;
+
+        if (response.compare(line_start, 2, "OK") == 0 ||
+            response.compare(line_start, 3, "ERR") == 0) {
+            break;
+        }
+    }
+
+    return response;
+}
+
+TEST(CFlagsTestsControl, Thread)
+{
+    uint64_t *batch = c_flag_uint64("control-batch", "b", nullptr, 32);
+    bool *verbose = c_flag_bool("control-verbose", "v", nullptr, false);
+    char **name = c_flag_string("control-name", "n", nullptr, "hello");
+
+    const char *argv_raw[] = {"app", "-b", "64"};
+    char **argv = (char **) argv_raw;
+    int argc = 3;
+
+    c_flags_parse(&argc, &argv, false);
+
+    std::string path = testing::TempDir() + "c-flags-control-thread.sock";
+
+    ASSERT_GE(c_flags_control_open(path.c_str()), 0);
+    ASSERT_TRUE(c_flags_control_start_thread());
+
+    struct stat path_stat;
+    ASSERT_EQ(lstat(path.c_str(), &path_stat), 0);
+    EXPECT_TRUE(S_ISSOCK(path_stat.st_mode));
+    EXPECT_EQ(path_stat.st_mode & 0777, 0600u);
+
+    int fd = connect_control(path);
+    ASSERT_GE(fd, 0);
+
+    EXPECT_EQ(request(fd, "LIST"),
+              "control-batch command-line 64\n"
+              "control-verbose default false\n"
+              "control-name default hello\n"
+              "OK\n");
+
+    EXPECT_EQ(request(fd, "GET control-batch"), "OK 64\n");
+    EXPECT_EQ(request(fd, "GET control-unknown"), "ERR unknown flag control-unknown\n");
+
+    EXPECT_EQ(request(fd, "SET control-batch=128 control-verbose=true control-name=world"),
+              "OK 3\n");
+
+    EXPECT_EQ(request(fd, "SET control-batch=256 control-verbose=maybe"),
+              "ERR invalid value maybe for bool flag control-verbose\n");
+
+    EXPECT_EQ(request(fd, "SET control-batch=128"), "OK 0\n");
+    EXPECT_EQ(request(fd, "GET control-name"), "OK world\n");
+    EXPECT_EQ(request(fd, "FLUSH"), "ERR unknown command FLUSH\n");
+
+    close(fd);
+    c_flags_control_close();
+
+    EXPECT_EQ(*batch, 128U);
+    EXPECT_EQ(*verbose, true);
+    EXPECT_STREQ(*name, "world");
+
+    EXPECT_EQ(access(path.c_str(), F_OK), -1);
+}
+
+TEST(CFlagsTestsControl, LineTooLong)
+{
+    int *level = c_flag_int("control-level", nullptr, nullptr, 7);
+
+    std::string path = testing::TempDir() + "c-flags-control-long.sock";
+
+    ASSERT_GE(c_flags_control_open(path.c_str()), 0);
+    ASSERT_TRUE(c_flags_control_start_thread());
+
+    int fd = connect_control(path);
+    ASSERT_GE(fd, 0);
+
+    // the command at the end of the buffer belongs to the long line and isn't executed
+    std::string line = std::string(4096, 'x') + "SET control-level=2";
+    EXPECT_EQ(request(fd, line), "ERR line is too long\n");
+    EXPECT_EQ(request(fd, "GET control-level"), "OK 7\n");
+
+    close(fd);
+    c_flags_control_close();
+
+    EXPECT_EQ(*level, 7);
+}
+
+TEST(CFlagsTestsControl, EventLoop)
+{
+    int *workers = c_flag_int("control-workers", nullptr, nullptr, 4);
+
+    std::string path = testing::TempDir() + "c-flags-control-loop.sock";
+
+    ASSERT_GE(c_flags_control_open(path.c_str()), 0);
+
+    int fd = connect_control(path);
+    ASSERT_GE(fd, 0);
+
+    const char command[] = "SET control-workers=8\n";
+    ASSERT_EQ(write(fd, command, sizeof(command) - 1), (ssize_t) (sizeof(command) - 1));
+    shutdown(fd, SHUT_WR);
+
+    // accept, then read the command
+    EXPECT_EQ(c_flags_control_dispatch(), 0);
+    EXPECT_EQ(c_flags_control_dispatch(), 0);
+
+    char response[16] = {0};
+    EXPECT_GT(read(fd, response, sizeof(response) - 1), 0);
+    EXPECT_STREQ(response, "OK 1\n");
+    EXPECT_EQ(*workers, 8);
+
+    close(fd);
+    c_flags_control_close();
+}
+
+TEST(CFlagsTestsControl, ExistingPath)
+{
+    std::string path = testing::TempDir() + "c-flags-control-existing";
+
+    FILE *file = fopen(path.c_str(), "w");
+    ASSERT_NE(file, nullptr);
+    fputs("data", file);
+    fclose(file);
+
+    // other files are kept
+    EXPECT_EQ(c_flags_control_open(path.c_str()), -1);
+    EXPECT_EQ(errno, EEXIST);
+    EXPECT_EQ(access(path.c_str(), F_OK), 0);
+
+    unlink(path.c_str());
+
+    // a socket left by a previous run is replaced
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+
+    struct sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    ASSERT_EQ(bind(fd, (struct sockaddr *) &address, sizeof(address)), 0);
+    close(fd);
+
+    ASSERT_GE(c_flags_control_open(path.c_str()), 0);
+    c_flags_control_close();
+
+    EXPECT_EQ(access(path.c_str(), F_OK), -1);
+}
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#if defined(__linux__)
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static std::string online_cpus()
+{
+    std::ifstream file("/sys/devices/system/cpu/online");
+    std::string online;
+
+    std::getline(file, online);
+    return online;
+}
+
+TEST(CFlagsTestsCpus, Values)
+{
+    const cpu_set_t **cpus = c_flag_cpus("cpus", "c", "worker CPUs", "0");
+    static const cpu_set_t *all_cpus = nullptr;
+
+    ASSERT_NE(cpus, nullptr);
+    ASSERT_TRUE(c_flag_cpus_var(&all_cpus, "all-cpus", nullptr, nullptr, "all"));
+
+    // a default with offline CPUs falls back to all online CPUs
+    testing::internal::CaptureStdout();
+    const cpu_set_t **offline = c_flag_cpus("offline", nullptr, nullptr, "1024");
+    std::string output = testing::internal::GetCapturedStdout();
+
+    ASSERT_NE(offline, nullptr);
+    EXPECT_EQ(*offline, all_cpus);
+    EXPECT_EQ(output,
+              "ERROR: invalid default value 1024 for cpus flag --offline, all online CPUs are "
+              "used\n");
+
+    ASSERT_EQ(CPU_COUNT(*cpus), 1);
+    ASSERT_TRUE(CPU_ISSET(0, *cpus));
+    ASSERT_EQ(CPU_COUNT(all_cpus), sysconf(_SC_NPROCESSORS_ONLN));
+
+    const cpu_set_t *default_cpus = *cpus;
+
+    // equal sets share the address, so values are compared by pointer
+    const char *argv_raw[] = {"app", "--cpus=all,^1-1023:2/2,0-0"};
+    char **argv = (char **) argv_raw;
+    int argc = 2;
+
+    c_flags_parse(&argc, &argv, false);
+    ASSERT_EQ(*cpus, default_cpus);
+
+    for (const char *value : {"0", "0-0", "0:1", "0-0:1/1", "0,0", "^1,0", "all,^1023"}) {
+        ASSERT_NE(load_value("cpus", value), -1) << value;
+        ASSERT_TRUE(CPU_ISSET(0, *cpus)) << value;
+    }
+
+    for (const char *value : {"", ",", "0,", ",0", "0,,0", "^0", "0,^0", "1-0", "0-", "-0",
+                              "0:", "0:0", "0-0:2/1", "0-0:1/", "a", "0x1", "0 1", "1024", "^"}) {
+        ASSERT_EQ(load_value("cpus", value), -1) << value;
+    }
+
+    std::string usage = c_flags_usage_text(nullptr);
+
+    ASSERT_NE(usage.find("       Default: 0\n"), std::string::npos);
+    ASSERT_NE(usage.find("       Default: " + online_cpus() + "\n"), std::string::npos);
+
+    ASSERT_EXIT(parse_to_stderr("--cpus", "0-1024"),
+                testing::ExitedWithCode(1),
+                "invalid value 0-1024 for cpus flag --cpus");
+}
+
+// ranges, strides and exclusions need several online CPUs
+TEST(CFlagsTestsCpus, Syntax)
+{
+    if (sysconf(_SC_NPROCESSORS_ONLN) < 8 || online_cpus().rfind("0-", 0) != 0)
+        GTEST_SKIP() << "requires CPUs 0-7 online";
+
+    const cpu_set_t **cpus = c_flag_cpus("syntax", nullptr, nullptr, "0-7");
+    ASSERT_NE(cpus, nullptr);
+
+    struct
+    {
+        const char *value;
+        std::vector<int> expected;
+    } cases[] = {
+        {"0-7:2", {0, 2, 4, 6}},
+        {"1-7:3", {1, 4, 7}},
+        {"0-7:2/4", {0, 1, 4, 5}},
+        {"0-7,^2-5", {0, 1, 6, 7}},
+        {"^0,0-3", {1, 2, 3}},
+        {"7,3,5", {3, 5, 7}},
+    };
+
+    for (const auto &test_case : cases) {
+        ASSERT_NE(load_value("syntax", test_case.value), -1) << test_case.value;
+        ASSERT_EQ(CPU_COUNT(*cpus), (int) test_case.expected.size()) << test_case.value;
+
+        for (int cpu : test_case.expected)
+            ASSERT_TRUE(CPU_ISSET(cpu, *cpus)) << test_case.value;
+    }
+
+    // snapshots store sets as text and parse them again
+    ASSERT_NE(load_value("syntax", "0-3,5,6"), -1);
+    const cpu_set_t *saved = *cpus;
+
+    std::vector<unsigned char> snapshot(c_flags_snapshot_size());
+    ASSERT_EQ(c_flags_snapshot_write(snapshot.data(), snapshot.size()), snapshot.size());
+    ASSERT_NE(std::string(snapshot.begin(), snapshot.end()).find("0-3,5-6"), std::string::npos);
+
+    ASSERT_NE(load_value("syntax", "7"), -1);
+    ASSERT_TRUE(c_flags_snapshot_load(snapshot.data(), snapshot.size()));
+    ASSERT_EQ(*cpus, saved);
+}
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#if defined(__linux__)
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static void write_file(const std::string &path, const std::string &content)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr) << "unable to create " << path;
+
+    size_t written = fwrite(content.data(), 1, content.size(), file);
+    ASSERT_EQ(fclose(file), 0);
+    ASSERT_EQ(written, content.size());
+}
+
+TEST(CFlagsTestsFile, Values)
+{
+    std::string dir = testing::TempDir() + "c-flags-file";
+    std::string data = dir + "/data.bin";
+    std::string empty = dir + "/empty";
+
+    mkdir(dir.c_str(), 0700);
+    ASSERT_NO_FATAL_FAILURE(write_file(data, "routing table"));
+    ASSERT_NO_FATAL_FAILURE(write_file(empty, ""));
+
+    const CFlagsFile **table =
+        c_flag_file("table", "t", "routing table", C_FLAGS_FILE_MAP, data.c_str());
+    const CFlagsFile **root =
+        c_flag_file("root", nullptr, nullptr, C_FLAGS_FILE_DIRECTORY, nullptr);
+    const CFlagsFile **input = c_flag_file("input", nullptr, nullptr, C_FLAGS_FILE_READ, nullptr);
+    static const CFlagsFile *anchor = nullptr;
+
+    ASSERT_NE(table, nullptr);
+    ASSERT_NE(root, nullptr);
+    ASSERT_NE(input, nullptr);
+    ASSERT_TRUE(c_flag_file_var(&anchor, "anchor", nullptr, nullptr, C_FLAGS_FILE_PATH, "/"));
+
+    ASSERT_NE(*table, nullptr);
+    EXPECT_EQ((*table)->fd, -1);
+    EXPECT_EQ(std::string((const char *) (*table)->data, (*table)->size), "routing table");
+    EXPECT_EQ(*root, nullptr);
+    EXPECT_EQ(*input, nullptr);
+    EXPECT_NE(fcntl(anchor->fd, F_GETFL) & O_PATH, 0);
+
+    std::string root_value = "--root=" + dir;
+    const char *argv_raw[] = {"app", root_value.c_str(), "--input", data.c_str()};
+    char **argv = (char **) argv_raw;
+    int argc = 4;
+
+    c_flags_parse(&argc, &argv, false);
+
+    ASSERT_NE(*root, nullptr);
+    ASSERT_NE(*input, nullptr);
+    EXPECT_EQ((*root)->path, dir);
+
+    // directories are used with openat()
+    int fd = openat((*root)->fd, "data.bin", O_RDONLY);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    char buffer[16] = {0};
+    ASSERT_EQ(pread((*input)->fd, buffer, 7, 0), 7);
+    EXPECT_STREQ(buffer, "routing");
+
+    // the same unchanged file gets the same handle, a replaced one gets a new mapping
+    const CFlagsFile *mapped = *table;
+
+    ASSERT_NE(load_value("table", data), -1);
+    EXPECT_EQ(*table, mapped);
+
+    write_file(data + ".new", "new routing table");
+    ASSERT_EQ(rename((data + ".new").c_str(), data.c_str()), 0);
+    ASSERT_NE(load_value("table", data), -1);
+    EXPECT_NE(*table, mapped);
+    EXPECT_EQ(std::string((const char *) (*table)->data, (*table)->size), "new routing table");
+
+    // the default still references the first mapping
+    EXPECT_EQ(std::string((const char *) mapped->data, mapped->size), "routing table");
+
+    ASSERT_NE(load_value("table", empty), -1);
+    EXPECT_EQ((*table)->data, nullptr);
+    EXPECT_EQ((*table)->size, 0u);
+
+    std::vector<std::string> invalid = {"", dir + "/nonexistent", dir, "/dev/null"};
+
+    for (const std::string &value : invalid)
+        ASSERT_EQ(load_value("table", value), -1) << value;
+
+    ASSERT_EQ(load_value("root", data), -1);
+    ASSERT_EQ(load_value("input", dir), -1);
+
+    // a handle that no value or default references is closed
+    int input_fd = (*input)->fd;
+    ASSERT_NE(load_value("input", empty), -1);
+    EXPECT_NE((*input)->fd, input_fd);
+    EXPECT_EQ(fcntl(input_fd, F_GETFD), -1);
+
+    std::string usage = c_flags_usage_text(nullptr);
+    EXPECT_NE(usage.find("       Default: " + data + "\n"), std::string::npos);
+
+    // snapshots store paths and open them again
+    std::vector<unsigned char> snapshot(c_flags_snapshot_size());
+    ASSERT_EQ(c_flags_snapshot_write(snapshot.data(), snapshot.size()), snapshot.size());
+
+    ASSERT_NE(load_value("root", "/"), -1);
+    EXPECT_STREQ((*root)->path, "/");
+
+    ASSERT_TRUE(c_flags_snapshot_load(snapshot.data(), snapshot.size()));
+    EXPECT_EQ((*root)->path, dir);
+
+    int rendered_argc = 0;
+    char **rendered_argv = c_flags_to_argv("app", false, &rendered_argc);
+    ASSERT_NE(rendered_argv, nullptr);
+
+    std::vector<std::string> rendered(rendered_argv + 1, rendered_argv + rendered_argc);
+    free(rendered_argv);
+
+    EXPECT_EQ(rendered,
+              (std::vector<std::string> {"--table", empty, "--root", dir, "--input", empty}));
+
+    ASSERT_EXIT(parse_to_stderr("--table", "/nonexistent"),
+                testing::ExitedWithCode(1),
+                "invalid value /nonexistent \\(No such file or directory\\) for mapped file flag "
+                "--table");
+    ASSERT_EXIT(parse_to_stderr("--root", data.c_str()),
+                testing::ExitedWithCode(1),
+                "\\(Not a directory\\) for directory flag --root");
+}
+
+TEST(CFlagsTestsFile, MissingDefault)
+{
+    std::string data = temp_path(".bin");
+    ASSERT_NO_FATAL_FAILURE(write_file(data, "lookup table"));
+
+    // the flag is declared anyway, so it can still be given
+    testing::internal::CaptureStdout();
+    const CFlagsFile **lookup =
+        c_flag_file("lookup", nullptr, nullptr, C_FLAGS_FILE_READ, "/nonexistent");
+    static const CFlagsFile *fallback = nullptr;
+    bool declared = c_flag_file_var(
+        &fallback, "fallback", nullptr, nullptr, C_FLAGS_FILE_MAP, "/nonexistent");
+    std::string output = testing::internal::GetCapturedStdout();
+
+    ASSERT_NE(lookup, nullptr);
+    EXPECT_EQ(*lookup, nullptr);
+    EXPECT_FALSE(declared);
+    EXPECT_EQ(fallback, nullptr);
+    EXPECT_EQ(output,
+              "ERROR: invalid default value /nonexistent (No such file or directory) for file "
+              "flag --lookup\n"
+              "ERROR: invalid default value /nonexistent (No such file or directory) for mapped "
+              "file flag --fallback\n");
+
+    ASSERT_NE(load_value("lookup", data), -1);
+    ASSERT_NE(load_value("fallback", data), -1);
+    ASSERT_NE(*lookup, nullptr);
+    EXPECT_EQ(std::string((const char *) fallback->data, fallback->size), "lookup table");
+}
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * The library is built for pages smaller than pages of any system,
+ * so freezing is refused like on systems with pages larger than expected.
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <csignal>
+
+TEST(CFlagsTestsFreezePageSize, LargerPagesRefused)
+{
+    int *jobs = c_flag_int("jobs", "j", nullptr, 1);
+
+    const char *argv_raw[] = {"app", "-j", "4"};
+    char **argv = (char **) argv_raw;
+    int argc = 3;
+
+    c_flags_parse(&argc, &argv, false);
+
+    ASSERT_FALSE(c_flags_freeze(true));
+    ASSERT_FALSE(c_flags_is_frozen());
+
+    // handlers of writes aren't left installed
+    struct sigaction action;
+    ASSERT_EQ(sigaction(SIGSEGV, nullptr, &action), 0);
+    ASSERT_EQ(action.sa_handler, SIG_DFL);
+
+    // values stay writable and runtime changes are accepted
+    *jobs = 8;
+    ASSERT_EQ(*jobs, 8);
+
+    unsigned char snapshot[1024];
+    size_t snapshot_size = c_flags_snapshot_write(snapshot, sizeof(snapshot));
+
+    *jobs = 16;
+
+    ASSERT_GT(snapshot_size, 0u);
+    ASSERT_TRUE(c_flags_snapshot_load(snapshot, snapshot_size));
+    ASSERT_EQ(*jobs, 8);
+}
+
+#endif
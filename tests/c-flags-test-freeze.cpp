@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cstdio>
+#include <unistd.h>
+
+TEST(CFlagsTestsFreeze, ReadOnlyValues)
+{
+    int *jobs = c_flag_int("jobs", "j", nullptr, 1);
+    char **name = c_flag_string("name", "n", nullptr, "default");
+    CFlagsBit fast = c_flag_bit("fast", "f", nullptr, false);
+
+    const char *argv_raw[] = {"app", "-j", "4", "-f"};
+    char **argv = (char **) argv_raw;
+    int argc = 4;
+
+    c_flags_parse(&argc, &argv, false);
+
+    // errors are printed to stdout, redirect it to stderr checked by death tests
+    ASSERT_DEATH(
+        {
+            dup2(STDERR_FILENO, STDOUT_FILENO);
+            c_flags_freeze(true);
+            *jobs = 8;
+        },
+        "write to frozen flag --jobs");
+
+    ASSERT_FALSE(c_flags_is_frozen());
+    ASSERT_TRUE(c_flags_freeze(false));
+    ASSERT_TRUE(c_flags_is_frozen());
+
+    const int *frozen_jobs = jobs;
+    const uint64_t *bits = c_flags_bits();
+
+    ASSERT_EQ(*frozen_jobs, 4);
+    ASSERT_STREQ(*name, "default");
+    ASSERT_TRUE(C_FLAGS_BIT_TEST(bits, fast));
+
+    // runtime changes are refused
+    char path[] = "/tmp/c-flags-test-freeze-XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+
+    const char config[] = "jobs = 16\n";
+    ASSERT_EQ(write(fd, config, sizeof(config) - 1), (ssize_t) (sizeof(config) - 1));
+
+    ASSERT_EQ(c_flags_load_config(path), -1);
+    ASSERT_EQ(*frozen_jobs, 4);
+
+    unsigned char snapshot[1024];
+    size_t snapshot_size = c_flags_snapshot_write(snapshot, sizeof(snapshot));
+
+    ASSERT_GT(snapshot_size, 0u);
+    ASSERT_FALSE(c_flags_snapshot_load(snapshot, snapshot_size));
+
+    close(fd);
+    unlink(path);
+}
+
+#endif
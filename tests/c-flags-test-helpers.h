@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef C_FLAGS_TEST_HELPERS_H
+#define C_FLAGS_TEST_HELPERS_H
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+// test executables run in parallel, so every test writes its own file
+static inline std::string temp_path(const char *extension)
+{
+    const testing::TestInfo *info = testing::UnitTest::GetInstance()->current_test_info();
+
+    return testing::TempDir() + "c-flags-" + info->test_suite_name() + "-" + info->name()
+        + extension;
+}
+
+// load the config through the config parser, -1 is returned if the file isn't written
+static inline int load_config(const std::string &content)
+{
+    std::string path = temp_path(".conf");
+
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        ADD_FAILURE() << "unable to create " << path;
+        return -1;
+    }
+
+    size_t written = fwrite(content.data(), 1, content.size(), file);
+    if (fclose(file) != 0 || written != content.size()) {
+        ADD_FAILURE() << "unable to write " << path;
+        return -1;
+    }
+
+    return c_flags_load_config(path.c_str());
+}
+
+// load the single `<name> = <value>` line through the config parser
+static inline int load_value(const char *name, const std::string &value)
+{
+    return load_config(std::string(name) + " = " + value + "\n");
+}
+
+// values of the list or binary flag
+template <typename T>
+static inline std::vector<T> to_vector(const T *values)
+{
+    return std::vector<T>(values, values + c_flags_list_size(values));
+}
+
+// values of the repeated string flag, the array ends with NULL
+static inline std::vector<std::string> to_vector(char **values)
+{
+    std::vector<std::string> result;
+
+    for (; *values != nullptr; values++)
+        result.push_back(*values);
+
+    return result;
+}
+
+// the first `argc` arguments
+static inline std::vector<std::string> to_vector(char **argv, int argc)
+{
+    std::vector<std::string> result;
+
+    for (int i = 0; i < argc; i++)
+        result.push_back(argv[i]);
+
+    return result;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// errors are printed to stdout, redirect it to stderr checked by death tests
+static inline void parse_to_stderr(const std::vector<const char *> &tokens)
+{
+    std::vector<char *> args = {(char *) "app"};
+    for (const char *token : tokens)
+        args.push_back((char *) token);
+    args.push_back(nullptr);
+
+    int argc = (int) args.size() - 1;
+    char **argv = args.data();
+
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+    c_flags_parse(&argc, &argv, false);
+}
+
+static inline void parse_to_stderr(const char *token)
+{
+    parse_to_stderr(std::vector<const char *> {token});
+}
+
+static inline void parse_to_stderr(const char *name, const char *value)
+{
+    parse_to_stderr(std::vector<const char *> {name, value});
+}
+#endif
+
+#endif // C_FLAGS_TEST_HELPERS_H
@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+TEST(CFlagsTestsLayout, DenseValues)
+{
+    bool *verbose = c_flag_bool("verbose", "v", nullptr, false);
+    int8_t *level = c_flag_int8("level", "l", nullptr, -3);
+    double *ratio = c_flag_double("ratio", "r", nullptr, 0.5);
+    char **name = c_flag_string("name", "n", nullptr, "default");
+    uint64_t *limit = c_flag_uint64("limit", nullptr, nullptr, 42);
+
+    auto address = [](const void *ptr) { return reinterpret_cast<uintptr_t>(ptr); };
+
+    // values are stored in equally sized slots of a cache line aligned block
+    uintptr_t slot = address(level) - address(verbose);
+
+    ASSERT_GE(slot, sizeof(uintmax_t));
+    ASSERT_EQ(address(verbose) % 64, 0u);
+    ASSERT_EQ(address(ratio) - address(level), slot);
+    ASSERT_EQ(address(name) - address(ratio), slot);
+    ASSERT_EQ(address(limit) - address(name), slot);
+
+#if !defined(C_FLAGS_PAD_VALUES)
+    // eight values share a cache line
+    ASSERT_EQ(slot, sizeof(uintmax_t));
+#endif
+
+    ASSERT_EQ(*verbose, false);
+    ASSERT_EQ(*level, -3);
+    ASSERT_EQ(*ratio, 0.5);
+    ASSERT_STREQ(*name, "default");
+    ASSERT_EQ(*limit, 42u);
+
+    const char *argv_raw[] = {"app", "-v", "-l", "7", "--ratio", "0.25", "--name", "x"};
+    char **argv = (char **) argv_raw;
+    int argc = sizeof(argv_raw) / sizeof(argv_raw[0]);
+
+    c_flags_parse(&argc, &argv, false);
+
+    ASSERT_EQ(*verbose, true);
+    ASSERT_EQ(*level, 7);
+    ASSERT_EQ(*ratio, 0.25);
+    ASSERT_STREQ(*name, "x");
+    ASSERT_EQ(*limit, 42u);
+}
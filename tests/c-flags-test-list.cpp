@@ -0,0 +1,149 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+TEST(CFlagsTestsList, Values)
+{
+    static const double *ratios = nullptr;
+
+    const int64_t **ids = c_flag_int64_list("ids", "i", "shard ids", "1,2,3");
+    const uint32_t **ports = c_flag_uint32_list("ports", nullptr, nullptr, nullptr);
+    const int32_t **offsets = c_flag_int32_list("offsets", nullptr, nullptr, " -1 0\t1 ");
+
+    ASSERT_NE(ids, nullptr);
+    ASSERT_NE(ports, nullptr);
+    ASSERT_NE(offsets, nullptr);
+    ASSERT_TRUE(c_flag_double_list_var(&ratios, "ratios", nullptr, nullptr, "0.5, 0.25"));
+
+    EXPECT_EQ(to_vector(*ids), (std::vector<int64_t> {1, 2, 3}));
+    EXPECT_EQ(*ports, nullptr);
+    EXPECT_EQ(c_flags_list_size(*ports), 0u);
+    EXPECT_EQ(to_vector(*offsets), (std::vector<int32_t> {-1, 0, 1}));
+    EXPECT_EQ(to_vector(ratios), (std::vector<double> {0.5, 0.25}));
+
+    const char *argv_raw[] = {"app", "--ids=-9223372036854775808 5, 6", "--ports", "80,443"};
+    char **argv = (char **) argv_raw;
+    int argc = 4;
+
+    c_flags_parse(&argc, &argv, false);
+
+    EXPECT_EQ(to_vector(*ids), (std::vector<int64_t> {INT64_MIN, 5, 6}));
+    EXPECT_EQ(to_vector(*ports), (std::vector<uint32_t> {80, 443}));
+
+    ASSERT_NE(load_value("ports", ""), -1);
+    EXPECT_EQ(*ports, nullptr);
+
+    ASSERT_NE(load_value("ports", "4294967295"), -1);
+    EXPECT_EQ(to_vector(*ports), (std::vector<uint32_t> {UINT32_MAX}));
+
+    for (const char *value : {",", "1,", ",1", "1,,2", "1, ,2", "-1", "4294967296", "1x", "0x10"})
+        ASSERT_EQ(load_value("ports", value), -1) << value;
+
+    for (const char *value : {"2147483648", "-2147483649", "1.5"})
+        ASSERT_EQ(load_value("offsets", value), -1) << value;
+
+    std::string usage = c_flags_usage_text(nullptr);
+
+    EXPECT_NE(usage.find("       Default: 1,2,3\n"), std::string::npos);
+    EXPECT_NE(usage.find("       Default: -1,0,1\n"), std::string::npos);
+
+#if defined(__unix__) || defined(__APPLE__)
+    ASSERT_EXIT(parse_to_stderr("--ids", "1 2,x,4"),
+                testing::ExitedWithCode(1),
+                "invalid value x at index 2 for int64_t list flag --ids");
+    ASSERT_EXIT(parse_to_stderr("--ids", "1,2,,4"),
+                testing::ExitedWithCode(1),
+                "invalid value \"\" at index 2 for int64_t list flag --ids");
+#endif
+}
+
+// large lists are parsed into one right-sized array and survive rendering and snapshots
+TEST(CFlagsTestsList, Large)
+{
+    const uint64_t **shards = c_flag_uint64_list("shards", nullptr, nullptr, nullptr);
+    ASSERT_NE(shards, nullptr);
+
+    std::string value;
+    std::vector<uint64_t> expected;
+
+    for (uint64_t i = 0; i < 100000; i++) {
+        value += (i % 3 == 0 ? " " : ",") + std::to_string(i * 1000003);
+        expected.push_back(i * 1000003);
+    }
+
+    ASSERT_NE(load_value("shards", value), -1);
+    ASSERT_EQ(to_vector(*shards), expected);
+
+    int rendered_argc = 0;
+    char **rendered_argv = c_flags_to_argv("app", false, &rendered_argc);
+    ASSERT_NE(rendered_argv, nullptr);
+
+    std::string rendered;
+    for (int i = 1; i + 1 < rendered_argc; i++) {
+        if (std::string(rendered_argv[i]) == "--shards")
+            rendered = rendered_argv[i + 1];
+    }
+
+    free(rendered_argv);
+    ASSERT_EQ(rendered.size(), value.size() - 1);
+    ASSERT_EQ(rendered.substr(0, 16), "0,1000003,200000");
+
+    std::vector<unsigned char> snapshot(c_flags_snapshot_size());
+    ASSERT_EQ(c_flags_snapshot_write(snapshot.data(), snapshot.size()), snapshot.size());
+
+    ASSERT_NE(load_value("shards", "1 2 3"), -1);
+    ASSERT_EQ(c_flags_list_size(*shards), 3u);
+
+    ASSERT_TRUE(c_flags_snapshot_load(snapshot.data(), snapshot.size()));
+    ASSERT_EQ(to_vector(*shards), expected);
+}
+
+TEST(CFlagsTestsList, Separators)
+{
+    static const char *separators[] = {",", " ", ", ", "\t", " ,\n", "\n\n", ",\t "};
+
+    const uint32_t **values = c_flag_uint32_list("separators", nullptr, nullptr, nullptr);
+    ASSERT_NE(values, nullptr);
+
+    // elements and runs of separators of every length cross the boundaries of vectors and words
+    for (size_t shift = 0; shift < 16; shift++) {
+        std::string value(shift, ' ');
+        std::vector<uint32_t> expected;
+
+        for (uint32_t i = 0; i < 64; i++) {
+            uint32_t element = (i * 7919 + (uint32_t) shift) % 100000;
+
+            if (i > 0)
+                value += separators[(i + shift) % 7];
+
+            value += std::to_string(element);
+            expected.push_back(element);
+        }
+
+        // newlines can't be given in configs
+        const char *argv_raw[] = {"app", "--separators", value.c_str()};
+        char **argv = (char **) argv_raw;
+        int argc = 3;
+
+        c_flags_parse(&argc, &argv, false);
+
+        ASSERT_EQ(argc, 0) << "shift: " << shift;
+        ASSERT_EQ(to_vector(*values), expected) << "shift: " << shift;
+    }
+}
@@ -0,0 +1,147 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+struct Notifications
+{
+    size_t calls = 0;
+    std::vector<const void *> changed;
+};
+
+static void observer(const void *const *changed, size_t changed_size, void *user_data)
+{
+    Notifications *notifications = static_cast<Notifications *>(user_data);
+
+    notifications->calls += 1;
+    notifications->changed.assign(changed, changed + changed_size);
+}
+
+TEST(CFlagsTestsObserve, Coalesced)
+{
+    int *first = c_flag_int("observe-first", nullptr, nullptr, 0);
+    int *second = c_flag_int("observe-second", nullptr, nullptr, 0);
+    int *third = c_flag_int("observe-third", nullptr, nullptr, 0);
+
+    // observers stay registered after the test
+    static Notifications pool;
+    static Notifications cache;
+    static Notifications all;
+
+    ASSERT_TRUE(c_flags_observe(first, observer, &pool));
+    ASSERT_TRUE(c_flags_observe(second, observer, &pool));
+    ASSERT_TRUE(c_flags_observe(second, observer, &pool));
+    ASSERT_TRUE(c_flags_observe(third, observer, &cache));
+    ASSERT_TRUE(c_flags_observe_all(observer, &all));
+
+    ASSERT_GE(load_config("observe-first = 1\n"
+                          "observe-second = 2\n"
+                          "observe-second = 3\n"), 0);
+
+    EXPECT_EQ(pool.calls, 1U);
+    EXPECT_EQ(pool.changed.size(), 2U);
+    EXPECT_NE(std::find(pool.changed.begin(), pool.changed.end(), first), pool.changed.end());
+    EXPECT_NE(std::find(pool.changed.begin(), pool.changed.end(), second), pool.changed.end());
+
+    EXPECT_EQ(cache.calls, 0U);
+
+    EXPECT_EQ(all.calls, 1U);
+    EXPECT_EQ(all.changed.size(), 2U);
+
+    ASSERT_GE(load_config("observe-first = 1\n"
+                          "observe-third = 3\n"), 0);
+
+    EXPECT_EQ(pool.calls, 1U);
+    EXPECT_EQ(cache.calls, 1U);
+    ASSERT_EQ(cache.changed.size(), 1U);
+    EXPECT_EQ(cache.changed[0], third);
+
+    EXPECT_EQ(all.calls, 2U);
+    ASSERT_EQ(all.changed.size(), 1U);
+    EXPECT_EQ(all.changed[0], third);
+
+    ASSERT_GE(load_config("observe-third = 3\n"), 0);
+
+    EXPECT_EQ(cache.calls, 1U);
+    EXPECT_EQ(all.calls, 2U);
+}
+
+struct Rendered
+{
+    size_t calls = 0;
+    std::vector<std::string> argv;
+    size_t snapshot_size = 0;
+};
+
+// functions taking the flags lock are called from the observer
+static void render_observer(const void *const *changed, size_t changed_size, void *user_data)
+{
+    Rendered *rendered = static_cast<Rendered *>(user_data);
+    int argc = 0;
+
+    (void) changed;
+    (void) changed_size;
+
+    char **argv = c_flags_to_argv("app", false, &argc);
+    ASSERT_NE(argv, nullptr);
+
+    rendered->calls += 1;
+    rendered->argv.assign(argv, argv + argc);
+    free(argv);
+
+    unsigned char snapshot[4096];
+    rendered->snapshot_size = c_flags_snapshot_write(snapshot, sizeof(snapshot));
+}
+
+TEST(CFlagsTestsObserve, ReadFromObserver)
+{
+    int *level = c_flag_int("observe-level", nullptr, nullptr, 0);
+
+    static Rendered rendered;
+    ASSERT_TRUE(c_flags_observe(level, render_observer, &rendered));
+
+    ASSERT_GE(load_config("observe-level = 5\n"), 0);
+
+    EXPECT_EQ(rendered.calls, 1U);
+    // flags are rendered in declaration order, the observed flag is declared last
+    ASSERT_GE(rendered.argv.size(), 3U);
+    EXPECT_EQ(rendered.argv[rendered.argv.size() - 2], "--observe-level");
+    EXPECT_EQ(rendered.argv.back(), "5");
+    EXPECT_GT(rendered.snapshot_size, 0U);
+}
+
+TEST(CFlagsTestsObserve, ChangedBits)
+{
+    int *width = c_flag_int("observe-width", nullptr, nullptr, 0);
+    CFlagsBit fast = c_flag_bit("observe-fast", nullptr, nullptr, false);
+    CFlagsBit safe = c_flag_bit("observe-safe", nullptr, nullptr, true);
+
+    static Notifications all;
+    ASSERT_TRUE(c_flags_observe_all(observer, &all));
+
+    ASSERT_GE(load_config("observe-width = 80\n"
+                          "observe-safe = false\n"), 0);
+
+    ASSERT_EQ(all.calls, 1U);
+    ASSERT_EQ(all.changed.size(), 2U);
+
+    CFlagsBit bit = fast;
+    EXPECT_EQ(all.changed[0], width);
+    EXPECT_FALSE(c_flags_bit_of(all.changed[0], &bit));
+    EXPECT_EQ(bit, fast);
+
+    // changed bits are identified by their pointers
+    ASSERT_TRUE(c_flags_bit_of(all.changed[1], &bit));
+    EXPECT_EQ(bit, safe);
+}
@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+TEST(CFlagsTestsPassThrough, Positive)
+{
+    int *int_value = c_flag_int("pass-int", "i", nullptr, 0);
+    bool *bool_value = c_flag_bool("pass-bool", "b", nullptr, false);
+    char **string_value = c_flag_string("pass-string", nullptr, nullptr, "hello");
+
+    // clang-format off
+    const char *argv_raw[] = {"app", "--unknown", "value",
+                                     "-i", "1",
+                                     "input.txt",
+                                     "--other=1",
+                                     "-b",
+                                     "-x",
+                                     "--pass-string=world",
+                                     "--",
+                                     "--pass-int", "2",
+                                     nullptr};
+    // clang-format on
+    char **argv = (char **) argv_raw;
+    int argc = (int) (sizeof(argv_raw) / sizeof(argv_raw[0])) - 1;
+
+    c_flags_parse_pass_through(&argc, &argv, false);
+
+    EXPECT_EQ(*int_value, 1);
+    EXPECT_EQ(*bool_value, true);
+    EXPECT_STREQ(*string_value, "world");
+
+    EXPECT_EQ(to_vector(argv, argc),
+              (std::vector<std::string>{
+                  "--unknown",
+                  "value",
+                  "input.txt",
+                  "--other=1",
+                  "-x",
+                  "--pass-int",
+                  "2",
+              }));
+
+    EXPECT_EQ(argv[argc], nullptr);
+
+    // parsed tokens are kept in front of the forwarded arguments in unspecified order
+    std::vector<std::string> parsed = to_vector((char **) argv_raw + 1, 5);
+    std::sort(parsed.begin(), parsed.end());
+
+    EXPECT_STREQ(argv_raw[0], "app");
+    EXPECT_EQ(parsed, (std::vector<std::string>{"--", "--pass-string=world", "-b", "-i", "1"}));
+    EXPECT_EQ(argv - 1, (char **) argv_raw + 5);
+}
+
+TEST(CFlagsTestsPassThrough, NothingToForward)
+{
+    c_flag_int("pass-only", nullptr, nullptr, 0);
+
+    const char *argv_raw[] = {"app", "--pass-only", "3", nullptr};
+    char **argv = (char **) argv_raw;
+    int argc = 3;
+
+    c_flags_parse_pass_through(&argc, &argv, false);
+
+    EXPECT_EQ(argc, 0);
+    EXPECT_EQ(argv[0], nullptr);
+    EXPECT_EQ(argv - 1, (char **) argv_raw + 2);
+}
+
+TEST(CFlagsTestsPassThrough, InvalidKnownFlag)
+{
+    c_flag_int("pass-invalid", nullptr, nullptr, 0);
+
+    const char *argv_raw[] = {"app", "--unknown", "--pass-invalid", "abc", nullptr};
+    char **argv = (char **) argv_raw;
+    int argc = 4;
+
+    EXPECT_EXIT(c_flags_parse_pass_through(&argc, &argv, false),
+                ::testing::ExitedWithCode(1),
+                ".*");
+}
@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#include <string>
+#include <vector>
+
+TEST(CFlagsTestsPermute, Positive)
+{
+    bool *verbose = c_flag_bool("permute-verbose", "v", nullptr, false);
+    int *level = c_flag_int("permute-level", "l", nullptr, 0);
+
+    // clang-format off
+    const char *argv_raw[] = {"app", "file.dat",
+                                     "--permute-verbose",
+                                     "other.dat",
+                                     "-l", "3",
+                                     "--",
+                                     "-v",
+                                     "--permute-level=4",
+                                     nullptr};
+    // clang-format on
+    char **argv = (char **) argv_raw;
+    int argc = (int) (sizeof(argv_raw) / sizeof(argv_raw[0])) - 1;
+
+    c_flags_parse_permute(&argc, &argv, false);
+
+    EXPECT_EQ(*verbose, true);
+    EXPECT_EQ(*level, 3);
+
+    EXPECT_EQ(to_vector(argv, argc),
+              (std::vector<std::string>{"file.dat", "other.dat", "-v", "--permute-level=4"}));
+    EXPECT_EQ(argv[argc], nullptr);
+    EXPECT_EQ(argv, (char **) argv_raw + 5);
+}
+
+TEST(CFlagsTestsPermute, Large)
+{
+    int *count = c_flag_int("permute-count", "c", nullptr, 0);
+
+    const int size = 200000;
+    std::vector<std::string> tokens;
+    std::vector<char *> argv_raw;
+
+    tokens.reserve(size);
+    tokens.push_back("app");
+
+    for (int i = 1; i < size; i++) {
+        if (i % 3 == 0)
+            tokens.push_back("-c");
+        else if (i % 3 == 1)
+            tokens.push_back(std::to_string(i));
+        else
+            tokens.push_back("positional-" + std::to_string(i));
+    }
+
+    for (std::string &token : tokens)
+        argv_raw.push_back(&token[0]);
+    argv_raw.push_back(nullptr);
+
+    char **argv = argv_raw.data();
+    int argc = size;
+
+    c_flags_parse_permute(&argc, &argv, false);
+
+    EXPECT_EQ(*count, size - 1);
+    ASSERT_EQ(argc, size / 3 + 1);
+
+    // the first value is a positional argument because it precedes any flag
+    EXPECT_STREQ(argv[0], "1");
+
+    for (int i = 1; i < argc; i++)
+        EXPECT_EQ(std::string(argv[i]), "positional-" + std::to_string(3 * (i - 1) + 2));
+}
+
+TEST(CFlagsTestsPermute, UnknownFlag)
+{
+    const char *argv_raw[] = {"app", "file.dat", "--permute-unknown", nullptr};
+    char **argv = (char **) argv_raw;
+    int argc = 3;
+
+    EXPECT_EXIT(c_flags_parse_permute(&argc, &argv, false), ::testing::ExitedWithCode(1), ".*");
+}
@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+TEST(CFlagsTestsRepeated, Values)
+{
+    static char *default_mounts[] = {(char *) "/proc", (char *) "/sys", nullptr};
+    static char **envs = nullptr;
+
+    unsigned *verbose = c_flag_counter("verbose", "v", "verbosity", 0);
+    char ***includes = c_flag_strings("include", "I", "include directories", nullptr);
+    char ***mounts = c_flag_strings("mount", nullptr, "mounts", default_mounts);
+    c_flag_strings_var(&envs, "env", "e", "environment", nullptr);
+
+    ASSERT_EQ(*verbose, 0u);
+    ASSERT_NE(*includes, nullptr);
+    ASSERT_EQ(**includes, nullptr);
+    ASSERT_EQ(*mounts, default_mounts);
+
+    const char *argv_raw[] = {"app", "-v", "-I", "a", "--verbose", "-e", "X=1", "-vvv",
+                              "--include=b", "--include", "", "pos", "-I", "c"};
+    char **argv = (char **) argv_raw;
+    int argc = 14;
+
+    c_flags_parse(&argc, &argv, false);
+
+    ASSERT_EQ(argc, 3);
+    ASSERT_STREQ(argv[0], "pos");
+
+    EXPECT_EQ(*verbose, 5u);
+    EXPECT_EQ(to_vector(*includes), (std::vector<std::string> {"a", "b", ""}));
+    EXPECT_EQ(to_vector(envs), (std::vector<std::string> {"X=1"}));
+    EXPECT_EQ(*mounts, default_mounts);
+
+    // elements reference argv
+    EXPECT_EQ((*includes)[0], argv_raw[3]);
+    EXPECT_EQ(envs[0], argv_raw[6]);
+
+    std::string usage = c_flags_usage_text(nullptr);
+    EXPECT_NE(usage.find("       Default: /proc,/sys\n"), std::string::npos);
+
+    // configs set the count and the only element
+    ASSERT_NE(load_value("verbose", "7"), -1);
+    EXPECT_EQ(*verbose, 7u);
+    ASSERT_EQ(load_value("verbose", "-1"), -1);
+
+    ASSERT_NE(load_value("mount", "/dev"), -1);
+    EXPECT_EQ(to_vector(*mounts), (std::vector<std::string> {"/dev"}));
+
+    // the rendered argv is parsed into the same values
+    int rendered_argc = 0;
+    char **rendered_argv = c_flags_to_argv("app", false, &rendered_argc);
+    ASSERT_NE(rendered_argv, nullptr);
+
+    std::vector<std::string> rendered(rendered_argv + 1, rendered_argv + rendered_argc);
+    EXPECT_EQ(rendered,
+              (std::vector<std::string> {"--verbose=7", "--include", "a", "--include", "b",
+                                         "--include", "", "--mount", "/dev", "--env", "X=1"}));
+
+    std::vector<unsigned char> snapshot(c_flags_snapshot_size());
+    ASSERT_EQ(c_flags_snapshot_write(snapshot.data(), snapshot.size()), snapshot.size());
+
+    const char *reset_raw[] = {"app", "-v", "--include", "z", "--mount=/"};
+    char **reset_argv = (char **) reset_raw;
+    int reset_argc = 5;
+
+    c_flags_parse(&reset_argc, &reset_argv, false);
+
+    EXPECT_EQ(*verbose, 8u);
+    EXPECT_EQ(to_vector(*includes), (std::vector<std::string> {"z"}));
+    EXPECT_EQ(to_vector(*mounts), (std::vector<std::string> {"/"}));
+    EXPECT_EQ(to_vector(envs), (std::vector<std::string> {"X=1"}));
+
+    int parsed_argc = rendered_argc;
+    char **parsed_argv = rendered_argv;
+    c_flags_parse(&parsed_argc, &parsed_argv, false);
+
+    EXPECT_EQ(parsed_argc, 0);
+    EXPECT_EQ(*verbose, 7u);
+    EXPECT_EQ(to_vector(*includes), (std::vector<std::string> {"a", "b", ""}));
+    EXPECT_EQ(to_vector(*mounts), (std::vector<std::string> {"/dev"}));
+
+    ASSERT_NE(load_value("include", "y"), -1);
+    ASSERT_TRUE(c_flags_snapshot_load(snapshot.data(), snapshot.size()));
+
+    EXPECT_EQ(to_vector(*includes), (std::vector<std::string> {"a", "b", ""}));
+    EXPECT_EQ(to_vector(*mounts), (std::vector<std::string> {"/dev"}));
+    EXPECT_EQ(to_vector(envs), (std::vector<std::string> {"X=1"}));
+
+    free(rendered_argv);
+}
+
+// hundreds of repeats are collected in order without growing arrays
+TEST(CFlagsTestsRepeated, Many)
+{
+    char ***binds = c_flag_strings("bind", "b", nullptr, nullptr);
+
+    std::vector<std::string> values;
+    std::vector<const char *> argv_raw = {"app"};
+
+    for (int i = 0; i < 500; i++)
+        values.push_back("/src/" + std::to_string(i) + ":/dst/" + std::to_string(i));
+
+    for (size_t i = 0; i < values.size(); i++) {
+        argv_raw.push_back(i % 2 == 0 ? "--bind" : "-b");
+        argv_raw.push_back(values[i].c_str());
+        argv_raw.push_back("positional");
+    }
+
+    char **argv = (char **) argv_raw.data();
+    int argc = (int) argv_raw.size();
+
+    c_flags_parse_permute(&argc, &argv, false);
+
+    ASSERT_EQ(argc, 500);
+    ASSERT_EQ(to_vector(*binds), values);
+}
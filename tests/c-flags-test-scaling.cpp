@@ -0,0 +1,245 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Registration, parsing and usage rendering are timed at doubling sizes and
+ * the growth exponent is fitted from the measurements, so paths that become
+ * quadratic in the number of flags, tokens or characters fail here instead of
+ * in programs with thousands of flags. The library is built with the capacity
+ * for the largest registry.
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 1 is linear and 2 is quadratic growth, the margin absorbs timing noise
+#define SCALING_MAX_EXPONENT 1.5
+
+// measurements of the same size, the fastest one is taken
+#define SCALING_REPETITIONS 5
+
+// names share long prefixes, so comparing them isn't decided by the first characters
+static const std::string long_prefix = "scaling-" + std::string(64, 'n') + "-";
+static const std::string short_prefix = "s" + std::string(16, 'n');
+
+// deques don't move elements, so names passed to the library stay valid
+static std::deque<std::string> long_names;
+static std::deque<std::string> short_names;
+
+// declare flags until `count` of them are declared by the test
+static void declare_flags(size_t count)
+{
+    for (size_t i = long_names.size(); i < count; i++) {
+        const std::string &long_name = long_names.emplace_back(long_prefix + std::to_string(i));
+        const std::string &short_name = short_names.emplace_back(short_prefix + std::to_string(i));
+
+        c_flag_int(long_name.c_str(), short_name.c_str(), "flag of the scaling test", 0);
+    }
+}
+
+// processor time isn't affected by other processes running on the same cores
+static double seconds(const std::function<void()> &function)
+{
+    std::clock_t begin = std::clock();
+    function();
+    std::clock_t end = std::clock();
+
+    return (double) (end - begin) / CLOCKS_PER_SEC;
+}
+
+static double fastest(const std::function<void()> &function)
+{
+    double result = seconds(function);
+
+    for (int i = 1; i < SCALING_REPETITIONS; i++)
+        result = std::min(result, seconds(function));
+
+    return result;
+}
+
+// least squares slope of the time over the size on the log-log scale
+static double growth_exponent(const std::vector<double> &sizes, const std::vector<double> &times)
+{
+    double mean_x = 0;
+    double mean_y = 0;
+
+    for (size_t i = 0; i < sizes.size(); i++) {
+        mean_x += std::log(sizes[i]) / (double) sizes.size();
+        mean_y += std::log(times[i]) / (double) sizes.size();
+    }
+
+    double covariance = 0;
+    double variance = 0;
+
+    for (size_t i = 0; i < sizes.size(); i++) {
+        double x = std::log(sizes[i]) - mean_x;
+
+        covariance += x * (std::log(times[i]) - mean_y);
+        variance += x * x;
+    }
+
+    return covariance / variance;
+}
+
+static void parse(const std::vector<std::string> &strings)
+{
+    std::vector<char *> args = {(char *) "app"};
+    for (const std::string &string : strings)
+        args.push_back((char *) string.c_str());
+    args.push_back(nullptr);
+
+    int argc = (int) args.size() - 1;
+    char **argv = args.data();
+
+    c_flags_parse(&argc, &argv, false);
+    ASSERT_EQ(argc, 0);
+}
+
+enum class Form {
+    Separate, // `--flag value`
+    Equal,    // `--flag=value`
+    Short,    // `-f value`
+};
+
+// `tokens` flags spread over the first `count` declared flags
+static std::vector<std::string> make_args(Form form, size_t count, size_t tokens)
+{
+    std::vector<std::string> strings;
+
+    for (size_t i = 0; i < tokens; i++) {
+        size_t index = (i * 7919) % count;
+        std::string value = std::to_string(i);
+
+        switch (form) {
+        case Form::Separate:
+            strings.push_back("--" + long_names[index]);
+            strings.push_back(value);
+            break;
+        case Form::Equal:
+            strings.push_back("--" + long_names[index] + "=" + value);
+            break;
+        case Form::Short:
+            strings.push_back("-" + short_names[index]);
+            strings.push_back(value);
+            break;
+        }
+    }
+
+    return strings;
+}
+
+static const Form forms[] = {Form::Separate, Form::Equal, Form::Short};
+static const char *form_names[] = {"separate", "equal", "short"};
+
+TEST(CFlagsTestsScaling, FlagsCount)
+{
+    static const char *descriptions[] = {"scaling", "scaling test"};
+    std::vector<double> sizes;
+
+    double registration = 0;
+    std::vector<double> registration_times;
+    std::vector<double> parse_times[3];
+    std::vector<double> usage_times;
+
+    // the registry only grows, so sizes are measured in the increasing order
+    for (size_t count = 1024; count <= 8192; count *= 2) {
+        sizes.push_back((double) count);
+
+        registration += seconds([&] { declare_flags(count); });
+        registration_times.push_back(registration);
+
+        // every flag is given once, so lookups are measured together with the flag count
+        for (size_t i = 0; i < 3; i++) {
+            std::vector<std::string> strings = make_args(forms[i], count, count);
+            parse_times[i].push_back(fastest([&] { parse(strings); }));
+        }
+
+        size_t rendered = 0;
+        usage_times.push_back(fastest([&] {
+            // a new description drops the cached text, so it's rendered again
+            c_flags_set_description(descriptions[rendered++ % 2]);
+            ASSERT_NE(c_flags_usage_text(nullptr), nullptr);
+        }));
+    }
+
+    EXPECT_LT(growth_exponent(sizes, registration_times), SCALING_MAX_EXPONENT);
+    EXPECT_LT(growth_exponent(sizes, usage_times), SCALING_MAX_EXPONENT);
+
+    for (size_t i = 0; i < 3; i++) {
+        EXPECT_LT(growth_exponent(sizes, parse_times[i]), SCALING_MAX_EXPONENT)
+            << "form: " << form_names[i];
+    }
+}
+
+TEST(CFlagsTestsScaling, TokensCount)
+{
+    declare_flags(1024);
+
+    for (size_t i = 0; i < 3; i++) {
+        std::vector<double> sizes;
+        std::vector<double> times;
+
+        for (size_t tokens = 2048; tokens <= 16384; tokens *= 2) {
+            std::vector<std::string> strings = make_args(forms[i], 1024, tokens);
+
+            sizes.push_back((double) tokens);
+            times.push_back(fastest([&] { parse(strings); }));
+        }
+
+        EXPECT_LT(growth_exponent(sizes, times), SCALING_MAX_EXPONENT)
+            << "form: " << form_names[i];
+    }
+}
+
+TEST(CFlagsTestsScaling, Length)
+{
+    char **string = c_flag_string("scaling-string", nullptr, "string of the scaling test", "");
+    unsigned *counter = c_flag_counter("scaling-counter", "v", "counter of the scaling test", 0);
+
+    static std::deque<std::string> names;
+
+    std::vector<double> sizes;
+    std::vector<double> value_times;
+    std::vector<double> name_times;
+    std::vector<double> run_times;
+
+    for (size_t length = 65536; length <= 524288; length *= 2) {
+        std::string value(length, 'v');
+        const std::string &name = names.emplace_back(long_prefix + std::string(length, 'l'));
+
+        c_flag_bool(name.c_str(), nullptr, "long flag of the scaling test", false);
+
+        sizes.push_back((double) length);
+
+        // string values reference argv, so it outlives the check
+        std::vector<std::string> strings = {"--scaling-string=" + value, "--scaling-string", value};
+
+        value_times.push_back(fastest([&] {
+            parse(strings);
+            ASSERT_EQ(std::string(*string), value);
+        }));
+
+        name_times.push_back(fastest([&] { parse({"--" + name, "--" + name + "=true"}); }));
+
+        run_times.push_back(fastest([&] {
+            unsigned before = *counter;
+
+            parse({"-" + value});
+            ASSERT_EQ(*counter, before + length);
+        }));
+    }
+
+    EXPECT_LT(growth_exponent(sizes, value_times), SCALING_MAX_EXPONENT);
+    EXPECT_LT(growth_exponent(sizes, name_times), SCALING_MAX_EXPONENT);
+    EXPECT_LT(growth_exponent(sizes, run_times), SCALING_MAX_EXPONENT);
+}
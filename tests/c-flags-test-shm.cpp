@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#if defined(__linux__)
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// layout of the segment header, see c-flags-shm.c
+struct ShmHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t schema;
+    uint32_t sequence;
+    uint32_t count;
+    uint64_t strings_offset;
+    uint64_t strings_capacity;
+    uint64_t size;
+};
+
+// attach to the copy of the segment with the changed header
+static bool attach_changed(std::vector<unsigned char> segment,
+                           uint64_t strings_offset,
+                           uint64_t strings_capacity)
+{
+    ShmHeader *header = (ShmHeader *) segment.data();
+    header->strings_offset = strings_offset;
+    header->strings_capacity = strings_capacity;
+
+    FILE *file = tmpfile();
+    EXPECT_NE(file, nullptr);
+    if (file == nullptr)
+        return false;
+
+    EXPECT_EQ(fwrite(segment.data(), 1, segment.size(), file), segment.size());
+    fflush(file);
+
+    // the attached segment owns the duplicate and closes it
+    int fd = dup(fileno(file));
+    bool attached = c_flags_shm_attach_fd(fd);
+
+    if (attached)
+        c_flags_shm_close();
+    else
+        close(fd);
+
+    fclose(file);
+    return attached;
+}
+
+TEST(CFlagsTestsSharedMemory, MasterAndWorker)
+{
+    uint64_t *batch = c_flag_uint64("shm-batch", nullptr, nullptr, 32);
+    char **name = c_flag_string("shm-name", nullptr, nullptr, "hello");
+    char **empty = c_flag_string("shm-empty", nullptr, nullptr, nullptr);
+
+    int fd = c_flags_shm_create(nullptr);
+    ASSERT_GE(fd, 0);
+
+    int attached[2];
+    int published[2];
+    ASSERT_EQ(pipe(attached), 0);
+    ASSERT_EQ(pipe(published), 0);
+
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+
+    if (pid == 0) {
+        char c;
+
+        if (!c_flags_shm_attach_fd(fd) || c_flags_shm_sync() != 0)
+            _exit(1);
+
+        if (write(attached[1], "x", 1) != 1 || read(published[0], &c, 1) != 1)
+            _exit(2);
+
+        if (c_flags_shm_sync() != 2 || c_flags_shm_sync() != 0)
+            _exit(3);
+
+        if (*batch != 64 || strcmp(*name, "world") != 0 || *empty != nullptr)
+            _exit(4);
+
+        c_flags_shm_close();
+        _exit(0);
+    }
+
+    char c;
+    ASSERT_EQ(read(attached[0], &c, 1), 1);
+
+    ASSERT_GT(load_config("shm-batch = 64\n"
+                          "shm-name = world\n"), 0);
+
+    ASSERT_EQ(write(published[1], "x", 1), 1);
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+
+    close(attached[0]);
+    close(attached[1]);
+    close(published[0]);
+    close(published[1]);
+
+    c_flags_shm_close();
+}
+
+TEST(CFlagsTestsSharedMemory, StringsOverflow)
+{
+    char **path = c_flag_string("shm-path", nullptr, nullptr, "/tmp");
+
+    ASSERT_GE(c_flags_shm_create(nullptr), 0);
+
+    // string values have room for twice the initial size, at least 4096 bytes
+    std::string config = "shm-path = " + std::string(8192, 'p') + "\n";
+
+    testing::internal::CaptureStdout();
+    ASSERT_GT(load_config(config), 0);
+    std::string output = testing::internal::GetCapturedStdout();
+
+    EXPECT_EQ(strlen(*path), 8192u);
+    EXPECT_NE(output.find("ERROR: string values don't fit into shared memory"),
+              std::string::npos);
+    EXPECT_FALSE(c_flags_shm_publish());
+
+    c_flags_shm_close();
+
+    // closed segment isn't published anymore
+    testing::internal::CaptureStdout();
+    ASSERT_GT(load_config("shm-path = /var\n"), 0);
+    output = testing::internal::GetCapturedStdout();
+
+    EXPECT_STREQ(*path, "/var");
+    EXPECT_EQ(output, "");
+}
+
+TEST(CFlagsTestsSharedMemory, MalformedLayout)
+{
+    int fd = c_flags_shm_create(nullptr);
+    ASSERT_GE(fd, 0);
+
+    struct stat st;
+    ASSERT_EQ(fstat(fd, &st), 0);
+
+    std::vector<unsigned char> segment((size_t) st.st_size);
+    ASSERT_EQ(pread(fd, segment.data(), segment.size(), 0), (ssize_t) segment.size());
+    c_flags_shm_close();
+
+    const ShmHeader *header = (const ShmHeader *) segment.data();
+    uint64_t offset = header->strings_offset;
+    uint64_t capacity = header->strings_capacity;
+
+    ASSERT_EQ(offset + capacity, segment.size());
+    EXPECT_TRUE(attach_changed(segment, offset, capacity));
+
+    // strings must follow the entries and end with the segment
+    EXPECT_FALSE(attach_changed(segment, offset + 8, capacity - 8));
+    EXPECT_FALSE(attach_changed(segment, offset - 8, capacity + 8));
+    EXPECT_FALSE(attach_changed(segment, offset, capacity + 4096));
+    EXPECT_FALSE(attach_changed(segment, offset, capacity - 8));
+    EXPECT_FALSE(attach_changed(segment, UINT64_MAX - 8, capacity));
+}
+
+#endif
@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+static std::vector<unsigned char> write_snapshot()
+{
+    std::vector<unsigned char> snapshot(c_flags_snapshot_size());
+    EXPECT_EQ(c_flags_snapshot_write(snapshot.data(), snapshot.size()), snapshot.size());
+    return snapshot;
+}
+
+TEST(CFlagsTestsSnapshot, Buffer)
+{
+    uint64_t *batch = c_flag_uint64("snapshot-batch", "b", nullptr, 32);
+    bool *verbose = c_flag_bool("snapshot-verbose", "v", nullptr, false);
+    double *ratio = c_flag_double("snapshot-ratio", nullptr, nullptr, 0.5);
+    char **name = c_flag_string("snapshot-name", "n", nullptr, "hello");
+    char **empty = c_flag_string("snapshot-empty", nullptr, nullptr, nullptr);
+
+    const char *argv_raw[] = {"app", "-b", "64", "-v", "-n", "world"};
+    char **argv = (char **) argv_raw;
+    int argc = 6;
+
+    c_flags_parse(&argc, &argv, false);
+
+    std::vector<unsigned char> snapshot = write_snapshot();
+    EXPECT_EQ(c_flags_snapshot_write(snapshot.data(), snapshot.size() - 1), 0U);
+
+    ASSERT_GT(load_config("snapshot-batch = 128\n"
+                          "snapshot-verbose = false\n"
+                          "snapshot-ratio = 0.25\n"
+                          "snapshot-name = config\n"
+                          "snapshot-empty = value\n"), 0);
+
+    ASSERT_TRUE(c_flags_snapshot_load(snapshot.data(), snapshot.size()));
+
+    EXPECT_EQ(*batch, 64U);
+    EXPECT_EQ(*verbose, true);
+    EXPECT_EQ(*ratio, 0.5);
+    EXPECT_STREQ(*name, "world");
+    EXPECT_EQ(*empty, nullptr);
+
+    // the snapshot is copied on load
+    snapshot.assign(snapshot.size(), 0);
+    EXPECT_STREQ(*name, "world");
+}
+
+TEST(CFlagsTestsSnapshot, Corrupted)
+{
+    std::vector<unsigned char> snapshot = write_snapshot();
+
+    snapshot.back() ^= 1;
+    EXPECT_FALSE(c_flags_snapshot_load(snapshot.data(), snapshot.size()));
+
+    snapshot.back() ^= 1;
+    EXPECT_FALSE(c_flags_snapshot_load(snapshot.data(), snapshot.size() - 1));
+    EXPECT_TRUE(c_flags_snapshot_load(snapshot.data(), snapshot.size()));
+
+    // other layout of flags
+    c_flag_int("snapshot-other", nullptr, nullptr, 0);
+    EXPECT_FALSE(c_flags_snapshot_load(snapshot.data(), snapshot.size()));
+}
+
+// layout of the snapshot, see c-flags-snapshot.c
+struct SnapshotHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t schema;
+    uint64_t checksum;
+    uint64_t size;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+struct SnapshotEntry
+{
+    uintmax_t data;
+    uint32_t string_offset;
+    uint32_t string_size;
+    uint32_t source;
+    uint32_t reserved;
+};
+
+static SnapshotEntry *snapshot_entry(std::vector<unsigned char> &snapshot, size_t index)
+{
+    return (SnapshotEntry *) (snapshot.data() + sizeof(SnapshotHeader)) + index;
+}
+
+// update the checksum, so only the validation of entries rejects the snapshot
+static void snapshot_seal(std::vector<unsigned char> &snapshot)
+{
+    const unsigned char *data = snapshot.data() + sizeof(SnapshotHeader);
+    size_t size = snapshot.size() - sizeof(SnapshotHeader);
+    uint64_t hash = 14695981039346656037ULL;
+    size_t i = 0;
+
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+
+        hash = (hash ^ word) * 1099511628211ULL;
+        hash ^= hash >> 29;
+    }
+
+    for (; i < size; i++)
+        hash = (hash ^ data[i]) * 1099511628211ULL;
+
+    ((SnapshotHeader *) snapshot.data())->checksum = hash;
+}
+
+TEST(CFlagsTestsSnapshot, Malformed)
+{
+    // `snapshot-name` is the fourth declared flag
+    std::vector<unsigned char> snapshot = write_snapshot();
+    size_t count = ((SnapshotHeader *) snapshot.data())->count;
+    size_t strings_offset = sizeof(SnapshotHeader) + count * sizeof(SnapshotEntry);
+
+    std::vector<unsigned char> unknown_source = snapshot;
+    snapshot_entry(unknown_source, 3)->source = 100;
+    snapshot_seal(unknown_source);
+
+    EXPECT_FALSE(c_flags_snapshot_load(unknown_source.data(), unknown_source.size()));
+
+    // the string runs into the next value without its terminator
+    std::vector<unsigned char> unterminated = snapshot;
+    const SnapshotEntry *entry = snapshot_entry(unterminated, 3);
+    size_t terminator = strings_offset + entry->string_offset + entry->string_size;
+
+    ASSERT_LT(terminator, unterminated.size());
+    ASSERT_EQ(unterminated[terminator], '\0');
+
+    unterminated[terminator] = 'x';
+    snapshot_seal(unterminated);
+
+    EXPECT_FALSE(c_flags_snapshot_load(unterminated.data(), unterminated.size()));
+
+    snapshot_seal(snapshot);
+    EXPECT_TRUE(c_flags_snapshot_load(snapshot.data(), snapshot.size()));
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(CFlagsTestsSnapshot, FileDescriptor)
+{
+    char **name = c_flag_string("snapshot-fd-name", nullptr, nullptr, "hello");
+    ASSERT_GT(load_config("snapshot-fd-name = world\n"), 0);
+
+    FILE *file = tmpfile();
+    ASSERT_NE(file, nullptr);
+
+    int fd = fileno(file);
+    ASSERT_TRUE(c_flags_snapshot_write_fd(fd));
+
+    ASSERT_GT(load_config("snapshot-fd-name = config\n"), 0);
+    EXPECT_STREQ(*name, "config");
+
+    ASSERT_TRUE(c_flags_snapshot_load_fd(fd));
+    EXPECT_STREQ(*name, "world");
+
+    fclose(file);
+}
+#endif
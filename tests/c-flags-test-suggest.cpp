@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <unistd.h>
+
+TEST(CFlagsTestsSuggest, Typo)
+{
+    c_flag_bool("verbose", "v", nullptr, false);
+    c_flag_uint64("batch-size", "bs", nullptr, 0);
+    c_flag_int("level", "lvl", nullptr, 0);
+
+    EXPECT_EXIT(parse_to_stderr("--verbos"),
+                ::testing::ExitedWithCode(1),
+                "unknown flag --verbos, did you mean --verbose\\?");
+
+    EXPECT_EXIT(parse_to_stderr("--bacth-size"),
+                ::testing::ExitedWithCode(1),
+                "unknown flag --bacth-size, did you mean --batch-size\\?");
+
+    EXPECT_EXIT(parse_to_stderr("-lvel"),
+                ::testing::ExitedWithCode(1),
+                "unknown flag -lvel, did you mean --level\\?");
+
+    EXPECT_EXIT(parse_to_stderr("-bz"),
+                ::testing::ExitedWithCode(1),
+                "unknown flag -bz, did you mean -bs\\?");
+}
+
+TEST(CFlagsTestsSuggest, NothingClose)
+{
+    EXPECT_EXIT(parse_to_stderr("--output"),
+                ::testing::ExitedWithCode(1),
+                "unknown flag --output\n");
+
+    EXPECT_EXIT(parse_to_stderr("-q"), ::testing::ExitedWithCode(1), "unknown flag -q\n");
+}
+
+TEST(CFlagsTestsSuggest, ManyFlags)
+{
+    static std::string names[50];
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        names[i] = "generated-flag-" + std::to_string(i * 7919);
+        c_flag_int(names[i].c_str(), nullptr, nullptr, 0);
+    }
+
+    EXPECT_EXIT(parse_to_stderr("--generated-flag-791"),
+                ::testing::ExitedWithCode(1),
+                "did you mean --generated-flag-7919\\?");
+}
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include "c-flags-test-helpers.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+TEST(CFlagsTestsUnits, Values)
+{
+    uint64_t *size = c_flag_bytes("size", "s", "buffer size", 64 * 1024 * 1024);
+    int64_t *timeout = c_flag_duration("timeout", "t", "request timeout", 250 * 1000000LL);
+
+    ASSERT_EQ(*size, 64u * 1024 * 1024);
+    ASSERT_EQ(*timeout, 250 * 1000000LL);
+
+    const char *argv_raw[] = {"app", "--size", "512MiB", "-t", "2m30s"};
+    char **argv = (char **) argv_raw;
+    int argc = 5;
+
+    c_flags_parse(&argc, &argv, false);
+
+    ASSERT_EQ(*size, 512ULL * 1024 * 1024);
+    ASSERT_EQ(*timeout, 150 * 1000000000LL);
+
+    const struct
+    {
+        const char *value;
+        uint64_t bytes;
+    } sizes[] = {
+        {"0", 0},
+        {"4096", 4096},
+        {"4k", 4000},
+        {"4K", 4000},
+        {"4KB", 4000},
+        {"512m", 512000000ULL},
+        {"1.5g", 1500000000ULL},
+        {"2t", 2000000000000ULL},
+        {"3p", 3000000000000000ULL},
+        {"4e", 4000000000000000000ULL},
+        {"4KiB", 4096},
+        {"1.5G", 1500000000ULL},
+        {"1.5GiB", 1536ULL * 1024 * 1024},
+        {"0.5Ki", 512},
+        {"15EiB", 15ULL << 60},
+        {"18446744073709551615B", UINT64_MAX},
+    };
+
+    for (const auto &entry : sizes) {
+        ASSERT_NE(load_value("size", entry.value), -1) << entry.value;
+        ASSERT_EQ(*size, entry.bytes) << entry.value;
+    }
+
+    // fractions must give a whole number of bytes, values must fit uint64_t
+    for (const char *value :
+         {"0.3KiB", "1.5", "KiB", "1.KiB", "1Kib", "-1k", "1e3", "1mb", "16EiB"})
+        ASSERT_EQ(load_value("size", value), -1) << value;
+
+    const struct
+    {
+        const char *value;
+        int64_t nanoseconds;
+    } durations[] = {
+        {"0", 0},
+        {"1h", 3600 * 1000000000LL},
+        {"250ms", 250 * 1000000LL},
+        {"1.5s", 1500 * 1000000LL},
+        {"1h30m", 5400 * 1000000000LL},
+        {"-1m", -60 * 1000000000LL},
+        {"10us", 10000},
+        {"10\xC2\xB5s", 10000},
+        {"7ns", 7},
+        {"1d", 86400 * 1000000000LL},
+        {"9223372036854775807ns", INT64_MAX},
+        {"-9223372036854775808ns", INT64_MIN},
+    };
+
+    for (const auto &entry : durations) {
+        ASSERT_NE(load_value("timeout", entry.value), -1) << entry.value;
+        ASSERT_EQ(*timeout, entry.nanoseconds) << entry.value;
+    }
+
+    for (const char *value : {"", "1", "ms", "1.5ns", "1x", "9223372036854775808ns", "300y"})
+        ASSERT_EQ(load_value("timeout", value), -1) << value;
+}
+
+TEST(CFlagsTestsUnits, HumanUnits)
+{
+    c_flag_bytes("cache", nullptr, nullptr, 1536ULL * 1024 * 1024);
+    c_flag_bytes("chunk", nullptr, nullptr, 4000);
+    c_flag_bytes("odd", nullptr, nullptr, 1000001);
+    c_flag_duration("interval", nullptr, nullptr, 3723 * 1000000000LL + 5000000);
+    c_flag_duration("zero", nullptr, nullptr, 0);
+
+    std::string usage = c_flags_usage_text(nullptr);
+
+    ASSERT_NE(usage.find("Default: 1536MiB\n"), std::string::npos);
+    ASSERT_NE(usage.find("Default: 4kB\n"), std::string::npos);
+    ASSERT_NE(usage.find("Default: 1000001\n"), std::string::npos);
+    ASSERT_NE(usage.find("Default: 1h2m3s5ms\n"), std::string::npos);
+    ASSERT_NE(usage.find("Default: 0s\n"), std::string::npos);
+
+    // rendered values are parsed back to the same values
+    int argc = 0;
+    char **rendered = c_flags_to_argv("app", true, &argc);
+
+    ASSERT_NE(rendered, nullptr);
+
+    std::string joined;
+    for (int i = 1; i < argc; i++)
+        joined += std::string(" ") + rendered[i];
+
+    ASSERT_NE(joined.find("--cache 1536MiB"), std::string::npos);
+    ASSERT_NE(joined.find("--interval 1h2m3s5ms"), std::string::npos);
+
+    free(rendered);
+}
@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <c-flags.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+static void append_to_string(const char *text, size_t size, void *user_data)
+{
+    static_cast<std::string *>(user_data)->append(text, size);
+}
+
+// runs first, while the hidden completion flag is the only declared flag
+TEST(CFlagsTestsUsage, HiddenOnly)
+{
+    c_flags_set_application_name("app");
+    c_flags_add_completion_flag();
+
+    size_t size = 0;
+    const char *text = c_flags_usage_text(&size);
+    ASSERT_NE(text, nullptr);
+
+    EXPECT_EQ(std::string(text, size), "USAGE:\n   app \n\n");
+}
+
+TEST(CFlagsTestsUsage, Text)
+{
+    c_flags_set_application_name("app");
+    c_flags_set_positional_args_description("<file>");
+    c_flags_set_description("Usage test application");
+
+    c_flag_bool("usage-verbose", "v", "verbose mode", false);
+    c_flag_string("usage-name", nullptr, nullptr, nullptr);
+    c_flag_double("usage-ratio", nullptr, "ratio of something", 0.5);
+
+    size_t size = 0;
+    const char *text = c_flags_usage_text(&size);
+    ASSERT_NE(text, nullptr);
+
+    EXPECT_EQ(std::string(text, size),
+              "USAGE:\n"
+              "   app [OPTIONS] <file>\n"
+              "\n"
+              "DESCRIPTION:\n"
+              "   Usage test application\n"
+              "\n"
+              "OPTIONS:\n"
+              "   --usage-verbose, -v\n"
+              "       Description: verbose mode\n"
+              "       Default: false\n"
+              "\n"
+              "   --usage-name\n"
+              "\n"
+              "   --usage-ratio\n"
+              "       Description: ratio of something\n"
+              "       Default: 0.500000\n");
+
+    // cached until the flags are changed
+    EXPECT_EQ(c_flags_usage_text(nullptr), text);
+
+    c_flag_int("usage-level", nullptr, nullptr, 3);
+
+    std::string changed = c_flags_usage_text(&size);
+    EXPECT_EQ(changed.size(), size);
+    EXPECT_NE(changed.find("   --usage-level\n       Default: 3\n"), std::string::npos);
+}
+
+TEST(CFlagsTestsUsage, Wrap)
+{
+    c_flag_int("usage-wrapped",
+               nullptr,
+               "a long description that does not fit into narrow terminal",
+               0);
+
+    c_flags_set_usage_width(40);
+
+    std::string text;
+    c_flags_usage_to_sink(append_to_string, &text);
+
+    c_flags_set_usage_width(0);
+
+    EXPECT_NE(text.find("   --usage-wrapped\n"
+                        "       Description: a long description\n"
+                        "                    that does not fit\n"
+                        "                    into narrow terminal\n"),
+              std::string::npos);
+
+    EXPECT_NE(text.find("DESCRIPTION:\n"
+                        "   Usage test application\n"),
+              std::string::npos);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(CFlagsTestsUsage, FileDescriptor)
+{
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    size_t size = 0;
+    const char *text = c_flags_usage_text(&size);
+
+    ASSERT_TRUE(c_flags_usage_to_fd(fds[1]));
+    close(fds[1]);
+
+    std::string written;
+    char buffer[256];
+    ssize_t result;
+
+    while ((result = read(fds[0], buffer, sizeof(buffer))) > 0)
+        written.append(buffer, (size_t) result);
+
+    close(fds[0]);
+
+    EXPECT_EQ(written, std::string(text, size));
+}
+#endif
@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2025 Denis Glazkov <glazzk.off@mail.ru>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include "edit-distance.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+static size_t naive_levenshtein(const std::string &a, const std::string &b)
+{
+    std::vector<std::vector<size_t>> d(a.size() + 1, std::vector<size_t>(b.size() + 1));
+
+    for (size_t i = 0; i <= a.size(); i++)
+        d[i][0] = i;
+    for (size_t j = 0; j <= b.size(); j++)
+        d[0][j] = j;
+
+    for (size_t i = 1; i <= a.size(); i++) {
+        for (size_t j = 1; j <= b.size(); j++) {
+            d[i][j] = std::min({d[i - 1][j] + 1,
+                                d[i][j - 1] + 1,
+                                d[i - 1][j - 1] + (a[i - 1] != b[j - 1])});
+        }
+    }
+
+    return d[a.size()][b.size()];
+}
+
+static StringView sv(const std::string &string)
+{
+    return sv_from_string(string.c_str());
+}
+
+TEST(EditDistanceTest, ed_levenshtein)
+{
+    EXPECT_EQ(ed_levenshtein(sv(""), sv("")), 0U);
+    EXPECT_EQ(ed_levenshtein(sv(""), sv("abc")), 3U);
+    EXPECT_EQ(ed_levenshtein(sv("abc"), sv("")), 3U);
+    EXPECT_EQ(ed_levenshtein(sv("verbose"), sv("verbose")), 0U);
+    EXPECT_EQ(ed_levenshtein(sv("verbos"), sv("verbose")), 1U);
+    EXPECT_EQ(ed_levenshtein(sv("vrebose"), sv("verbose")), 2U);
+    EXPECT_EQ(ed_levenshtein(sv("kitten"), sv("sitting")), 3U);
+    EXPECT_EQ(ed_levenshtein(sv("batch-size"), sv("bs")), 8U);
+}
+
+TEST(EditDistanceTest, Random)
+{
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> letter('a', 'e');
+
+    // lengths around the word size check both algorithms
+    for (size_t length : {1, 5, 20, 63, 64, 65, 100}) {
+        for (int iteration = 0; iteration < 50; iteration++) {
+            std::string a, b;
+
+            for (size_t i = 0; i < length; i++)
+                a += (char) letter(random);
+            for (size_t i = 0; i < length + iteration % 7; i++)
+                b += (char) letter(random);
+
+            EXPECT_EQ(ed_levenshtein(sv(a), sv(b)), naive_levenshtein(a, b)) << a << " " << b;
+        }
+    }
+}
+
+TEST(EditDistanceTest, ed_distance)
+{
+    EditDistancePattern pattern;
+    std::string name = "verbose";
+    ed_pattern_init(&pattern, sv(name));
+
+    EXPECT_EQ(ed_distance(&pattern, sv("verbos"), 2), 1U);
+    EXPECT_EQ(ed_distance(&pattern, sv("vrebose"), 2), 2U);
+    EXPECT_EQ(ed_distance(&pattern, sv("vrebos"), 2), 3U);
+
+    // rejected by length and character counts
+    EXPECT_EQ(ed_distance(&pattern, sv("v"), 2), 3U);
+    EXPECT_EQ(ed_distance(&pattern, sv("xxxxxxx"), 2), 3U);
+}
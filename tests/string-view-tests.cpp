@@ -134,4 +134,10 @@ TEST(StringViewTest, sv_index_of)
 
     EXPECT_EQ(sv_index_of(sv, sv_from_string("h")), 0);
     EXPECT_EQ(sv_index_of(sv, sv_from_string("o")), 4);
+    EXPECT_EQ(sv_index_of(sv, sv_from_string("lo")), 3);
+    EXPECT_EQ(sv_index_of(sv, sv_from_string("hello!")), -1);
+
+    EXPECT_EQ(sv_index_of(sv_slice_left(sv, 3), sv_from_string("l")), 2);
+    EXPECT_EQ(sv_index_of(sv_slice_left(sv, 3), sv_from_string("lo")), -1);
+    EXPECT_EQ(sv_index_of(sv_slice_left(sv, 3), empty), -1);
 }